@@ -103,6 +103,24 @@ const ActionDescriptionMap kActionDescriptions =
     }
   },
 
+  /* Action         : kActionPause
+   * Scope          : Application
+   * Parameter type : -
+   * State type     : bool
+   * State value    : false
+   * State hint     : -
+   * Enabled        : true
+   */
+  { kActionPause,
+    {
+      ActionScope::kApp,
+      {},
+      Glib::Variant<bool>::create( false ),
+      {},
+      true
+    }
+  },
+
   /* Action         : kActionTempo
    * Scope          : Application
    * Parameter type : double
@@ -761,6 +779,24 @@ const ActionDescriptionMap kActionDescriptions =
     }
   },
 
+  /* Action         : kActionShowStats
+   * Scope          : Window
+   * Parameter type : -
+   * State type     : bool
+   * State value    : false
+   * State hint     : -
+   * Enabled        : true
+   */
+  { kActionShowStats,
+    {
+      ActionScope::kWin,
+      {},
+      Glib::Variant<bool>::create( false ),
+      {},
+      true
+    }
+  },
+
   /* Action         : kActionPendulumTogglePhase
    * Scope          : Window
    * Parameter type : -
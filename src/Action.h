@@ -36,6 +36,7 @@
 // Application actions
 inline const Glib::ustring  kActionQuit                 {"quit"};
 inline const Glib::ustring  kActionStart                {"start"};
+inline const Glib::ustring  kActionPause                {"pause"};
 inline const Glib::ustring  kActionVolume               {"volume"};
 inline const Glib::ustring  kActionVolumeChange         {"volume-change"};
 inline const Glib::ustring  kActionVolumeMute           {"volume-mute"};
@@ -81,6 +82,7 @@ inline const Glib::ustring kActionShowHelp              {"show-help"};
 inline const Glib::ustring kActionShowAbout             {"show-about"};
 inline const Glib::ustring kActionShowPendulum          {"show-pendulum"};
 inline const Glib::ustring kActionFullScreen            {"full-screen"};
+inline const Glib::ustring kActionShowStats             {"show-stats"};
 inline const Glib::ustring kActionTempoQuickSet         {"tempo-quick-set"};
 inline const Glib::ustring kActionPendulumTogglePhase   {"pendulum-toggle-phase"};
 
@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "AllocGuard.h"
+
+#include <atomic>
+
+#ifdef ENABLE_ALLOC_GUARD
+# include <algorithm>
+# include <cerrno>
+# include <cstdio>
+# include <cstdlib>
+# include <cstring>
+# include <new>
+# include <unistd.h>
+# if __has_include(<execinfo.h>)
+#  include <execinfo.h>
+#  define ALLOC_GUARD_BACKTRACE 1
+# endif
+#endif
+
+namespace audio {
+
+  namespace {
+
+    // guard state of the current thread (no dynamic initialization, since
+    // it is accessed from within the allocation functions)
+    thread_local int guard_depth = 0;
+    thread_local int suspend_depth = 0;
+
+    std::atomic<std::size_t> violation_count {0};
+
+  }//unnamed namespace
+
+  AllocGuard::AllocGuard() noexcept
+  { ++guard_depth; }
+
+  AllocGuard::~AllocGuard()
+  { --guard_depth; }
+
+  bool AllocGuard::enabled() noexcept
+  {
+#ifdef ENABLE_ALLOC_GUARD
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  std::size_t AllocGuard::violations() noexcept
+  {
+    return violation_count.load(std::memory_order_relaxed);
+  }
+
+  AllocGuard::Suspend::Suspend() noexcept
+  { ++suspend_depth; }
+
+  AllocGuard::Suspend::~Suspend()
+  { --suspend_depth; }
+
+#ifdef ENABLE_ALLOC_GUARD
+
+  namespace {
+
+    // prevents recursive reports (e.g. allocations of backtrace())
+    thread_local bool reporting = false;
+
+    bool abortOnViolation()
+    {
+      static const bool abort_mode = [] {
+        const char* mode = std::getenv("GMETRONOME_ALLOC_GUARD");
+        return mode != nullptr && std::strcmp(mode, "abort") == 0;
+      }();
+      return abort_mode;
+    }
+
+    // reports an allocation in a guarded section without allocating memory
+    void checkAllocation(std::size_t size)
+    {
+      if (guard_depth == 0 || suspend_depth > 0 || reporting)
+        return;
+
+      reporting = true;
+
+      violation_count.fetch_add(1, std::memory_order_relaxed);
+
+      char msg[128];
+      int len = std::snprintf(msg, sizeof(msg),
+                              "AllocGuard: allocation of %zu bytes in real-time section\n",
+                              size);
+      if (len > 0 && ::write(STDERR_FILENO, msg, std::strlen(msg)) < 0)
+      {
+        // nothing we can do about it
+      }
+
+# ifdef ALLOC_GUARD_BACKTRACE
+      void* frames[32];
+      int depth = ::backtrace(frames, 32);
+      ::backtrace_symbols_fd(frames, depth, STDERR_FILENO);
+# endif
+
+      if (abortOnViolation())
+        std::abort();
+
+      reporting = false;
+    }
+
+  }//unnamed namespace
+
+#endif//ENABLE_ALLOC_GUARD
+
+}//namespace audio
+
+#ifdef ENABLE_ALLOC_GUARD
+# ifdef __GLIBC__
+
+// With glibc we interpose the C allocation functions, which also covers the
+// global operator new and allocations in C libraries (e.g. audio backends).
+extern "C" {
+
+  void* __libc_malloc(std::size_t size);
+  void* __libc_calloc(std::size_t num, std::size_t size);
+  void* __libc_realloc(void* ptr, std::size_t size);
+  void* __libc_memalign(std::size_t alignment, std::size_t size);
+  void* __libc_valloc(std::size_t size);
+  void* __libc_pvalloc(std::size_t size);
+
+  void* malloc(std::size_t size)
+  {
+    audio::checkAllocation(size);
+    return __libc_malloc(size);
+  }
+
+  void* calloc(std::size_t num, std::size_t size)
+  {
+    audio::checkAllocation(num * size);
+    return __libc_calloc(num, size);
+  }
+
+  void* realloc(void* ptr, std::size_t size)
+  {
+    audio::checkAllocation(size);
+    return __libc_realloc(ptr, size);
+  }
+
+  // the aligned variants are also used by the aligned operator new
+
+  void* memalign(std::size_t alignment, std::size_t size)
+  {
+    audio::checkAllocation(size);
+    return __libc_memalign(alignment, size);
+  }
+
+  void* aligned_alloc(std::size_t alignment, std::size_t size)
+  {
+    audio::checkAllocation(size);
+
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+    {
+      errno = EINVAL;
+      return nullptr;
+    }
+    return __libc_memalign(alignment, size);
+  }
+
+  int posix_memalign(void** ptr, std::size_t alignment, std::size_t size)
+  {
+    audio::checkAllocation(size);
+
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0 || alignment == 0)
+      return EINVAL;
+
+    void* mem = __libc_memalign(alignment, size);
+    if (mem == nullptr)
+      return ENOMEM;
+
+    *ptr = mem;
+    return 0;
+  }
+
+  void* valloc(std::size_t size)
+  {
+    audio::checkAllocation(size);
+    return __libc_valloc(size);
+  }
+
+  void* pvalloc(std::size_t size)
+  {
+    audio::checkAllocation(size);
+    return __libc_pvalloc(size);
+  }
+
+}//extern "C"
+
+# else
+
+void* operator new(std::size_t size)
+{
+  audio::checkAllocation(size);
+
+  if (void* ptr = std::malloc(size == 0 ? 1 : size); ptr)
+    return ptr;
+  else
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{ return operator new(size); }
+
+void operator delete(void* ptr) noexcept
+{ std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept
+{ std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept
+{ std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{ std::free(ptr); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+  audio::checkAllocation(size);
+
+  // the size of std::aligned_alloc must be a multiple of the alignment
+  const auto align = static_cast<std::size_t>(alignment);
+  const std::size_t bytes = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+
+  if (void* ptr = std::aligned_alloc(align, bytes); ptr)
+    return ptr;
+  else
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{ return operator new(size, alignment); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{ std::free(ptr); }
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{ std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{ std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{ std::free(ptr); }
+
+# endif//__GLIBC__
+#endif//ENABLE_ALLOC_GUARD
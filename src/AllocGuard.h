@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GMetronome_AllocGuard_h
+#define GMetronome_AllocGuard_h
+
+#include <cstddef>
+
+namespace audio {
+
+  /**
+   * @class AllocGuard
+   * @brief Detects heap allocations in real-time sections
+   *
+   * While a guard object exists, every heap allocation on the same thread
+   * (malloc, calloc, realloc and the aligned allocation functions with glibc,
+   * the global operator new including its aligned overloads otherwise) is
+   * reported as a violation. Depending on the environment variable
+   * GMETRONOME_ALLOC_GUARD the violation is logged with a backtrace to
+   * stderr ("log", default) or the program is aborted ("abort").
+   *
+   * The allocation hooks are only compiled in if the package is configured
+   * with --enable-alloc-guard. Otherwise guard objects do nothing.
+   */
+  class AllocGuard {
+  public:
+    AllocGuard() noexcept;
+    ~AllocGuard();
+
+    AllocGuard(const AllocGuard&) = delete;
+    AllocGuard& operator=(const AllocGuard&) = delete;
+
+    /** Checks whether the allocation hooks are compiled in. */
+    static bool enabled() noexcept;
+
+    /** Number of allocations that were detected in guarded sections. */
+    static std::size_t violations() noexcept;
+
+    /**
+     * @class Suspend
+     * @brief Permits allocations within a guarded section
+     */
+    class Suspend {
+    public:
+      Suspend() noexcept;
+      ~Suspend();
+
+      Suspend(const Suspend&) = delete;
+      Suspend& operator=(const Suspend&) = delete;
+    };
+  };
+
+}//namespace audio
+#endif//GMetronome_AllocGuard_h
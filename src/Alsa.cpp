@@ -28,10 +28,116 @@
 #include <utility>
 #include <thread>
 #include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <mutex>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
 
 namespace audio {
 
+  namespace {
+
+    // Safety timeout of a single wait for the device (in milliseconds).
+    // The writer is usually woken up by the device or by an explicit wakeup.
+    constexpr int kPollTimeout = 1000;
+
+    // Device nodes of the sound cards (watched for hotplug events)
+    constexpr const char* kDeviceDirectory = "/dev/snd";
+
+    // Capabilities of the probed devices, shared by all backend instances
+    struct DeviceCache
+    {
+      struct Entry
+      {
+        std::string card;  // empty, if the device is not bound to a card
+        bool usable;
+        DeviceInfo info;
+      };
+
+      std::mutex mutex;
+      std::vector<std::string> cards; // card ids at the time of the last scan
+      std::map<std::string, Entry> entries; // by device name
+
+      // remove the entries of a card and of devices without a card (e.g. "default")
+      void invalidate(const std::string& card)
+        {
+          for (auto it = entries.begin(); it != entries.end();)
+          {
+            if (it->second.card.empty() || it->second.card == card)
+              it = entries.erase(it);
+            else
+              ++it;
+          }
+        }
+    };
+
+    DeviceCache& deviceCache()
+    {
+      static DeviceCache cache;
+      return cache;
+    }
+
+    // get the id of the card of a device name (e.g. "front:CARD=PCH,DEV=0")
+    std::string cardOfDevice(const std::string& name)
+    {
+      static const std::string kCardKey = "CARD=";
+
+      auto begin = name.find(kCardKey);
+      if (begin == std::string::npos)
+        return {};
+
+      begin += kCardKey.size();
+      auto end = name.find(',', begin);
+
+      return name.substr(begin, end == std::string::npos ? end : end - begin);
+    }
+
+    // open the control interface of a card and get the card id
+    snd_ctl_t* openCardControl(int card, std::string& id)
+    {
+      snd_ctl_t* ctl = nullptr;
+
+      std::string name = "hw:" + std::to_string(card);
+      if (snd_ctl_open(&ctl, name.c_str(), SND_CTL_NONBLOCK) < 0)
+        return nullptr;
+
+      snd_ctl_card_info_t* info;
+      snd_ctl_card_info_alloca(&info);
+
+      if (snd_ctl_card_info(ctl, info) < 0)
+      {
+        snd_ctl_close(ctl);
+        return nullptr;
+      }
+
+      id = snd_ctl_card_info_get_id(info);
+      return ctl;
+    }
+
+    // get the ids of the available cards in the order of their indices
+    std::vector<std::string> getCardIds()
+    {
+      std::vector<std::string> ids;
+
+      int card = -1;
+      while (snd_card_next(&card) == 0 && card >= 0)
+      {
+        std::string id;
+        if (snd_ctl_t* ctl = openCardControl(card, id); ctl != nullptr)
+        {
+          ids.push_back(id);
+          snd_ctl_close(ctl);
+        }
+      }
+      return ids;
+    }
+
+  }//unnamed namespace
+
   class AlsaDeviceError : public GMetronomeError {
   public:
     AlsaDeviceError(const std::string& msg = "", int error = 0)
@@ -138,6 +244,7 @@ namespace audio {
   std::ostream& operator<<(std::ostream& os, const AlsaBackend::AlsaDeviceConfig& cfg)
   {
     os << "["
+       << snd_pcm_access_name(cfg.access) << ", "
        << snd_pcm_format_name(cfg.format) << ", "
        << cfg.channels << ", "
        << cfg.rate << ", "
@@ -156,17 +263,33 @@ namespace audio {
   AlsaBackend::AlsaDevice::AlsaDevice(const std::string& name)
     : name_ {name},
       pcm_ {nullptr},
-      rate_ {0}
+      rate_ {0},
+      access_ {SND_PCM_ACCESS_RW_INTERLEAVED},
+      avail_min_ {0},
+      buffer_size_ {0},
+      start_threshold_ {0},
+      xruns_ {0}
   {}
 
   AlsaBackend::AlsaDevice::AlsaDevice(AlsaDevice&& device) noexcept
     : name_ { std::move(device.name_) },
       pcm_ { device.pcm_ },
-      rate_ { device.rate_ }
+      rate_ { device.rate_ },
+      access_ { device.access_ },
+      avail_min_ { device.avail_min_ },
+      buffer_size_ { device.buffer_size_ },
+      start_threshold_ { device.start_threshold_ },
+      xruns_ { device.xruns_ },
+      poll_fds_ { std::move(device.poll_fds_) }
   {
     device.name_.clear();
     device.pcm_ = nullptr;
     device.rate_ = 0;
+    device.avail_min_ = 0;
+    device.buffer_size_ = 0;
+    device.start_threshold_ = 0;
+    device.xruns_ = 0;
+    device.poll_fds_.clear();
   }
 
   AlsaBackend::AlsaDevice::~AlsaDevice()
@@ -194,17 +317,27 @@ namespace audio {
 
     pcm_  = std::exchange(device.pcm_, nullptr);
     rate_ = std::exchange(device.rate_, 0);
+    access_ = device.access_;
+    avail_min_ = std::exchange(device.avail_min_, 0);
+    buffer_size_ = std::exchange(device.buffer_size_, 0);
+    start_threshold_ = std::exchange(device.start_threshold_, 0);
+    xruns_ = std::exchange(device.xruns_, 0);
+
+    poll_fds_ = std::move(device.poll_fds_);
+    device.poll_fds_.clear();
 
     return *this;
   }
 
-  void AlsaBackend::AlsaDevice::open()
+  void AlsaBackend::AlsaDevice::open(int mode)
   {
     if (pcm_) return;
 
-    int error = snd_pcm_open(&pcm_, name_.c_str(), SND_PCM_STREAM_PLAYBACK, 0);
+    int error = snd_pcm_open(&pcm_, name_.c_str(), SND_PCM_STREAM_PLAYBACK, mode);
     if (error < 0)
       throw AlsaDeviceError {"failed to open device '" + name_ + "'", error};
+
+    xruns_ = 0;
   }
 
   void AlsaBackend::AlsaDevice::close()
@@ -232,9 +365,7 @@ namespace audio {
     if (error < 0)
       throw AlsaDeviceError {"failed to set up configuration space", error};
 
-    error = snd_pcm_hw_params_set_access(pcm_, hw_params, SND_PCM_ACCESS_RW_INTERLEAVED);
-    if (error < 0)
-      throw AlsaDeviceError {"failed to set the access type", error};
+    setupAccess(hw_params, out_cfg);
 
     error = snd_pcm_hw_params_set_format(pcm_, hw_params, in_cfg.format);
     if (error < 0)
@@ -261,36 +392,84 @@ namespace audio {
     if (error < 0)
       throw AlsaDeviceError {"unable to install pcm hw params", error};
 
+    // the device might not support the requested buffer layout exactly
+    error = snd_pcm_hw_params_get_period_size(hw_params, &out_cfg.period_size, NULL);
+    if (error < 0)
+      throw AlsaDeviceError {"failed to get the period size", error};
+
+    error = snd_pcm_hw_params_get_buffer_size(hw_params, &out_cfg.buffer_size);
+    if (error < 0)
+      throw AlsaDeviceError {"failed to get the buffer size", error};
+
     rate_ = out_cfg.rate; // cache
+    access_ = out_cfg.access; // cache
+
+    setupSoftware(out_cfg);
+
+    // allocate the poll descriptors in advance (see wait())
+    int count = snd_pcm_poll_descriptors_count(pcm_);
+    if (count <= 0)
+      throw AlsaDeviceError {"failed to get the number of poll descriptors", count};
+
+    poll_fds_.resize(count + 1);
+
+    return out_cfg;
+  }
 
-    //
-    // TODO: set approriate software parameters
-    //
+  void AlsaBackend::AlsaDevice::setupAccess(snd_pcm_hw_params_t* hw_params,
+                                            AlsaDeviceConfig& cfg)
+  {
+    int error = snd_pcm_hw_params_set_access(pcm_, hw_params, cfg.access);
 
-    // snd_pcm_sw_params_t *sw_params;
-    // snd_pcm_sw_params_alloca(&sw_params);
+    // not every device (or plugin) supports memory mapped access
+    if (error < 0 && cfg.access != SND_PCM_ACCESS_RW_INTERLEAVED)
+    {
+#ifndef NDEBUG
+      std::cerr << "AlsaBackend: access type " << snd_pcm_access_name(cfg.access)
+                << " not supported (falling back to "
+                << snd_pcm_access_name(SND_PCM_ACCESS_RW_INTERLEAVED) << ")" << std::endl;
+#endif
+      cfg.access = SND_PCM_ACCESS_RW_INTERLEAVED;
+      error = snd_pcm_hw_params_set_access(pcm_, hw_params, cfg.access);
+    }
 
-    // error = snd_pcm_sw_params_current(pcm_, sw_params);
-    // if (error < 0)
-    //   throw AlsaDeviceError {"unable to get current sw params", error};
+    if (error < 0)
+      throw AlsaDeviceError {"failed to set the access type", error};
+  }
+
+  void AlsaBackend::AlsaDevice::setupSoftware(const AlsaDeviceConfig& cfg)
+  {
+    snd_pcm_sw_params_t *sw_params;
+    snd_pcm_sw_params_alloca(&sw_params);
+
+    int error = snd_pcm_sw_params_current(pcm_, sw_params);
+    if (error < 0)
+      throw AlsaDeviceError {"unable to get current sw params", error};
 
-    // error = snd_pcm_sw_params_set_avail_min(pcm_, sw_params, 1024);
-    // if (error < 0)
-    //   throw AlsaDeviceError {"failed to set sw param avail min", error};
+    // wake up the writer as soon as a whole period can be written
+    avail_min_ = std::min(cfg.period_size, cfg.buffer_size);
 
-    // error = snd_pcm_sw_params_set_start_threshold(pcm_, sw_params, 1024);
-    // if (error < 0)
-    //   throw AlsaDeviceError {"unable to set sw param start threshold", error};
+    error = snd_pcm_sw_params_set_avail_min(pcm_, sw_params, avail_min_);
+    if (error < 0)
+      throw AlsaDeviceError {"failed to set sw param avail min", error};
 
-    // error = snd_pcm_sw_params_set_stop_threshold(pcm_, sw_params, 1024);
-    // if (error < 0)
-    //   throw AlsaDeviceError {"unable to set sw param stop threshold", error};
+    // start the playback automatically, when the buffer is filled for
+    // the first time (an explicit start would underrun immediately)
+    error = snd_pcm_sw_params_set_start_threshold(pcm_, sw_params, cfg.buffer_size);
+    if (error < 0)
+      throw AlsaDeviceError {"unable to set sw param start threshold", error};
 
-    // error = snd_pcm_sw_params(pcm_, sw_params);
-    // if (error < 0)
-    //   throw AlsaDeviceError {"unable to install pcm sw params", error};
+    buffer_size_ = cfg.buffer_size; // cache
+    start_threshold_ = cfg.buffer_size; // cache (see startAtThreshold)
 
-    return out_cfg;
+    // report an underrun as soon as the buffer runs empty
+    error = snd_pcm_sw_params_set_stop_threshold(pcm_, sw_params, cfg.buffer_size);
+    if (error < 0)
+      throw AlsaDeviceError {"unable to set sw param stop threshold", error};
+
+    error = snd_pcm_sw_params(pcm_, sw_params);
+    if (error < 0)
+      throw AlsaDeviceError {"unable to install pcm sw params", error};
   }
 
   void AlsaBackend::AlsaDevice::prepare()
@@ -313,11 +492,12 @@ namespace audio {
       throw AlsaDeviceError {"failed to start device", error};
   }
 
-  void AlsaBackend::AlsaDevice::write(const void* data, size_t bytes)
+  size_t AlsaBackend::AlsaDevice::write(const void* data, size_t bytes, int wakeup_fd)
   {
     assert(pcm_ != nullptr && "can not write to a closed device");
 
-    snd_pcm_sframes_t frames_left = snd_pcm_bytes_to_frames(pcm_, bytes);
+    const snd_pcm_sframes_t frames_total = snd_pcm_bytes_to_frames(pcm_, bytes);
+    snd_pcm_sframes_t frames_left = frames_total;
 
 // #ifndef NDEBUG
 //     std::cerr << "AlsaBackend: write " << frames_left << " frames" << std::endl;
@@ -325,29 +505,41 @@ namespace audio {
 
     while (frames_left > 0)
     {
-      snd_pcm_sframes_t avail  = snd_pcm_avail(pcm_);
+      snd_pcm_sframes_t avail = snd_pcm_avail_update(pcm_);
 
       if (avail < 0)
-        throw AlsaDeviceError {"unable to write (failed to get available frames)", (int) avail};
+      {
+        recover(avail);
+        continue;
+      }
 
-      if (avail==0)
-        snd_pcm_wait(pcm_, 100);
+      // write whole periods (or the rest of the data) to avoid busy writing
+      if (avail < std::min<snd_pcm_sframes_t>(frames_left, avail_min_))
+      {
+        // a prepared device does not free any space, so waiting for it would
+        // only time out (start the playback with the frames already queued)
+        if (state() == SND_PCM_STATE_PREPARED)
+        {
+          start();
+          continue;
+        }
+
+        if (wait(wakeup_fd))
+          continue;
+        else
+          break; // interrupted
+      }
 
       snd_pcm_sframes_t frames_chunk = (avail < frames_left) ? avail : frames_left;
 
-      snd_pcm_sframes_t frames_written = snd_pcm_writei(pcm_, data, frames_chunk);
-      if (frames_written < 0)
-      {
-#ifndef NDEBUG
-        std::cerr << "AlsaBackend: write failed (trying to recover)" << std::endl;
-#endif
-        frames_written = snd_pcm_recover(pcm_, frames_written, 0);
-      }
+      snd_pcm_sframes_t frames_written = transfer(data, frames_chunk);
       if (frames_written < 0)
       {
-        throw AlsaDeviceError {"write failed (could not recover)", (int)frames_written};
+        recover(frames_written);
+        continue;
       }
-      else if (frames_written > 0 && frames_written < (snd_pcm_sframes_t) frames_chunk)
+      // (short transfers to the mapped area are expected at the end of the ring buffer)
+      else if (frames_written < frames_chunk && access_ == SND_PCM_ACCESS_RW_INTERLEAVED)
       {
 #ifndef NDEBUG
         std::cerr << "AlsaBackend: short write (expected " << frames_chunk
@@ -355,6 +547,11 @@ namespace audio {
 #endif
       }
 
+      // unlike snd_pcm_writei, a commit to the mapped area does not apply
+      // the start threshold (also after a recovery or a flush)
+      if (access_ == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+        startAtThreshold();
+
       frames_left -= frames_written;
 
       // increment data ptr
@@ -364,9 +561,112 @@ namespace audio {
 //       std::cerr << "AlsaBackend: written: " << frames_written << " "
 //                 << "left: " << frames_left << std::endl;
 // #endif
+    }
+
+    return snd_pcm_frames_to_bytes(pcm_, frames_total - frames_left);
+  }
+
+  snd_pcm_sframes_t AlsaBackend::AlsaDevice::transfer(const void* data, snd_pcm_uframes_t frames)
+  {
+    if (access_ == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+      return transferMmap(data, frames);
+    else
+      return snd_pcm_writei(pcm_, data, frames);
+  }
+
+  snd_pcm_sframes_t AlsaBackend::AlsaDevice::transferMmap(const void* data, snd_pcm_uframes_t frames)
+  {
+    const snd_pcm_channel_area_t* areas;
+    snd_pcm_uframes_t offset;
+    snd_pcm_uframes_t count = frames;
+
+    // requires a preceding snd_pcm_avail_update (see write)
+    int error = snd_pcm_mmap_begin(pcm_, &areas, &offset, &count);
+    if (error < 0)
+      return error;
+
+    // the channels of an interleaved area share the address of the first
+    // channel and the step is the size of a frame in bits
+    char* dst = static_cast<char*>(areas[0].addr)
+      + (areas[0].first + offset * areas[0].step) / 8;
+
+    assert(static_cast<snd_pcm_sframes_t>(areas[0].step / 8) == snd_pcm_frames_to_bytes(pcm_, 1));
+
+    std::memcpy(dst, data, snd_pcm_frames_to_bytes(pcm_, count));
+
+    return snd_pcm_mmap_commit(pcm_, offset, count);
+  }
 
-      snd_pcm_wait(pcm_, 100);
+  void AlsaBackend::AlsaDevice::startAtThreshold()
+  {
+    if (state() != SND_PCM_STATE_PREPARED)
+      return;
+
+    // errors are handled by the next snd_pcm_avail_update in write
+    snd_pcm_sframes_t avail = snd_pcm_avail_update(pcm_);
+    if (avail < 0)
+      return;
+
+    const snd_pcm_uframes_t queued = buffer_size_ - std::min<snd_pcm_uframes_t>(avail, buffer_size_);
+    if (queued >= start_threshold_)
+      start();
+  }
+
+  bool AlsaBackend::AlsaDevice::wait(int wakeup_fd)
+  {
+    assert(!poll_fds_.empty() && "device not set up");
+
+    const int count = poll_fds_.size() - 1;
+
+    int error = snd_pcm_poll_descriptors(pcm_, poll_fds_.data(), count);
+    if (error < 0)
+      throw AlsaDeviceError {"failed to get poll descriptors", error};
+
+    // a negative descriptor is ignored by poll()
+    poll_fds_[count] = { wakeup_fd, POLLIN, 0 };
+
+    int ready = poll(poll_fds_.data(), poll_fds_.size(), kPollTimeout);
+    if (ready < 0)
+    {
+      if (errno == EINTR)
+        return true;
+      else
+        throw AlsaDeviceError {"failed to wait for the device", -errno};
+    }
+
+    if (poll_fds_[count].revents & POLLIN)
+      return false;
+
+    if (ready > 0)
+    {
+      unsigned short revents = 0;
+      error = snd_pcm_poll_descriptors_revents(pcm_, poll_fds_.data(), count, &revents);
+      if (error < 0)
+        throw AlsaDeviceError {"failed to get poll events", error};
+
+      // errors (e.g. underruns) are handled by the next snd_pcm_avail_update
+#ifndef NDEBUG
+      if (revents & POLLERR)
+        std::cerr << "AlsaBackend: poll error (state: "
+                  << alsa_name(state()) << ")" << std::endl;
+#endif
     }
+
+    return true;
+  }
+
+  void AlsaBackend::AlsaDevice::recover(int error)
+  {
+#ifndef NDEBUG
+    std::cerr << "AlsaBackend: write failed (trying to recover)" << std::endl;
+#endif
+    if (error == -EPIPE)
+      ++xruns_;
+
+    // after the recovery the playback restarts, when the buffer is filled
+    int result = snd_pcm_recover(pcm_, error, 1);
+    if (result < 0)
+      throw AlsaDeviceError {"write failed (could not recover)", result};
   }
 
   void AlsaBackend::AlsaDevice::drop()
@@ -553,24 +853,181 @@ namespace audio {
     return devices;
   }
 
+  class AlsaBackend::AlsaMonitor {
+  public:
+    AlsaMonitor();
+    ~AlsaMonitor();
+
+    AlsaMonitor(const AlsaMonitor&) = delete;
+    AlsaMonitor& operator=(const AlsaMonitor&) = delete;
+
+    /**
+     * @brief Wait for control events of the cards or changes of /dev/snd
+     * @param timeout   Maximum time to wait
+     * @param cards     Receives the ids of the cards that changed
+     * @param all       Set to true if cards were added or removed
+     * @return false on timeout
+     */
+    bool wait(milliseconds timeout, std::vector<std::string>& cards, bool& all);
+
+  private:
+    std::vector<std::pair<snd_ctl_t*, std::string>> controls_;
+    int inotify_fd_;
+  };
+
+  AlsaBackend::AlsaMonitor::AlsaMonitor()
+    : inotify_fd_ {inotify_init1(IN_NONBLOCK | IN_CLOEXEC)}
+  {
+    if (inotify_fd_ >= 0 && inotify_add_watch(inotify_fd_, kDeviceDirectory, IN_CREATE | IN_DELETE) < 0)
+    {
+      ::close(inotify_fd_);
+      inotify_fd_ = -1;
+    }
+#ifndef NDEBUG
+    if (inotify_fd_ < 0)
+      std::cerr << "AlsaBackend: failed to watch '" << kDeviceDirectory << "' "
+                << "(new cards will not be detected)" << std::endl;
+#endif
+
+    int card = -1;
+    while (snd_card_next(&card) == 0 && card >= 0)
+    {
+      std::string id;
+      if (snd_ctl_t* ctl = openCardControl(card, id); ctl != nullptr)
+      {
+        if (snd_ctl_subscribe_events(ctl, 1) == 0)
+          controls_.emplace_back(ctl, id);
+        else
+          snd_ctl_close(ctl);
+      }
+    }
+  }
+
+  AlsaBackend::AlsaMonitor::~AlsaMonitor()
+  {
+    for (auto& [ctl, id] : controls_)
+      snd_ctl_close(ctl);
+
+    if (inotify_fd_ >= 0)
+      ::close(inotify_fd_);
+  }
+
+  bool AlsaBackend::AlsaMonitor::wait(milliseconds timeout,
+                                      std::vector<std::string>& cards,
+                                      bool& all)
+  {
+    std::vector<pollfd> fds;
+    std::vector<int> counts;
+
+    for (auto& [ctl, id] : controls_)
+    {
+      int count = std::max(snd_ctl_poll_descriptors_count(ctl), 0);
+      fds.resize(fds.size() + count);
+      count = std::max(snd_ctl_poll_descriptors(ctl, fds.data() + fds.size() - count, count), 0);
+      counts.push_back(count);
+    }
+
+    if (inotify_fd_ >= 0)
+      fds.push_back({inotify_fd_, POLLIN, 0});
+
+    if (fds.empty())
+    {
+      std::this_thread::sleep_for(timeout);
+      return false;
+    }
+
+    if (poll(fds.data(), fds.size(), timeout.count()) <= 0)
+      return false;
+
+    cards.clear();
+    all = false;
+
+    pollfd* ctl_fds = fds.data();
+    for (std::size_t index = 0; index < controls_.size(); ++index)
+    {
+      auto& [ctl, id] = controls_[index];
+
+      unsigned short revents = 0;
+      snd_ctl_poll_descriptors_revents(ctl, ctl_fds, counts[index], &revents);
+      ctl_fds += counts[index];
+
+      // the card was disconnected
+      if (revents & (POLLERR | POLLHUP | POLLNVAL))
+      {
+        all = true;
+        continue;
+      }
+
+      if (!(revents & POLLIN))
+        continue;
+
+      snd_ctl_event_t* event;
+      snd_ctl_event_alloca(&event);
+
+      // Value changes (e.g. of the volume) are ignored, but added, removed
+      // or reconfigured elements (e.g. the ELD of HDMI outputs) indicate
+      // that the capabilities of the card's devices might have changed.
+      bool changed = false;
+      while (snd_ctl_read(ctl, event) > 0)
+      {
+        if (snd_ctl_event_get_type(event) != SND_CTL_EVENT_ELEM)
+          continue;
+
+        unsigned int mask = snd_ctl_event_elem_get_mask(event);
+        if (mask == SND_CTL_EVENT_MASK_REMOVE
+            || (mask & (SND_CTL_EVENT_MASK_ADD | SND_CTL_EVENT_MASK_INFO)))
+          changed = true;
+      }
+
+      if (changed)
+        cards.push_back(id);
+    }
+
+    if (inotify_fd_ >= 0 && (fds.back().revents & POLLIN))
+    {
+      alignas(inotify_event) char buffer[4096];
+      while (read(inotify_fd_, buffer, sizeof(buffer)) > 0);
+      all = true;
+    }
+
+    return all || !cards.empty();
+  }
+
   AlsaBackend::AlsaBackend()
     : state_ {BackendState::kConfig},
       cfg_ {kDefaultConfig},
       device_infos_ {},
-      alsa_device_ {nullptr}
-  {}
+      alsa_device_ {nullptr},
+      monitor_ {nullptr},
+      wakeup_fd_ {eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)}
+  {
+#ifndef NDEBUG
+    if (wakeup_fd_ < 0)
+      std::cerr << "AlsaBackend: failed to create wakeup descriptor "
+                << "(write can not be interrupted)" << std::endl;
+#endif
+  }
 
   AlsaBackend::AlsaBackend(AlsaBackend&& backend) noexcept
     : state_ { std::move(backend.state_) },
       cfg_ { std::move(backend.cfg_) },
       device_infos_ { std::move(backend.device_infos_) },
-      alsa_device_ { std::move(backend.alsa_device_) }
+      alsa_device_ { std::move(backend.alsa_device_) },
+      monitor_ { std::move(backend.monitor_) },
+      wakeup_fd_ { std::exchange(backend.wakeup_fd_, -1) }
   {
     backend.state_ = BackendState::kConfig;
     backend.device_infos_.clear();
   }
 
-  AlsaBackend::~AlsaBackend() {}
+  AlsaBackend::~AlsaBackend()
+  {
+    // close the device before the wakeup descriptor
+    alsa_device_ = nullptr;
+
+    if (wakeup_fd_ >= 0)
+      ::close(wakeup_fd_);
+  }
 
   AlsaBackend& AlsaBackend::operator=(AlsaBackend&& backend) noexcept
   {
@@ -585,16 +1042,56 @@ namespace audio {
     backend.device_infos_.clear();
 
     alsa_device_  = std::move(backend.alsa_device_);
+    monitor_ = std::move(backend.monitor_);
+
+    if (wakeup_fd_ >= 0)
+      ::close(wakeup_fd_);
+
+    wakeup_fd_ = std::exchange(backend.wakeup_fd_, -1);
 
     return *this;
   }
 
   std::vector<DeviceInfo> AlsaBackend::devices()
   {
-    scanAlsaDevices();
+    scanDevices([] (const DeviceInfo&) { return true; });
     return device_infos_;
   }
 
+  bool AlsaBackend::waitDeviceChange(microseconds timeout)
+  {
+    if (!monitor_)
+      monitor_ = std::make_unique<AlsaMonitor>();
+
+    std::vector<std::string> cards;
+    bool all = false;
+
+    if (!monitor_->wait(std::chrono::duration_cast<milliseconds>(timeout), cards, all))
+      return false;
+
+    {
+      auto& cache = deviceCache();
+      std::lock_guard<std::mutex> guard(cache.mutex);
+
+      if (all)
+      {
+        cache.entries.clear();
+        cache.cards.clear();
+      }
+      else for (const auto& card : cards)
+        cache.invalidate(card);
+    }
+
+    // subscribe to the events of the new set of cards
+    if (all)
+      monitor_ = nullptr;
+
+#ifndef NDEBUG
+    std::cerr << "AlsaBackend: devices changed" << std::endl;
+#endif
+    return true;
+  }
+
   void AlsaBackend::configure(const DeviceConfig& config)
   {
     assert(state_ == BackendState::kConfig);
@@ -617,15 +1114,17 @@ namespace audio {
     }
 
     AlsaDeviceConfig alsa_in_cfg;
+    alsa_in_cfg.access = SND_PCM_ACCESS_MMAP_INTERLEAVED; // falls back to RW access
     alsa_in_cfg.format = sampleFormatToAlsa(cfg_.spec.format);
     alsa_in_cfg.rate = cfg_.spec.rate;
     alsa_in_cfg.channels = cfg_.spec.channels;
 
-    // TODO: The preferred buffer configuration should depend on the client side
-    //       configuration (audio::DeviceConfig) and might anticipate a working
+    // TODO: The preferred buffer configuration might anticipate a working
     //       setup by respecting the actual device capabilities (audio::AlsaDeviceCaps).
-    alsa_in_cfg.period_size = 1024;
-    alsa_in_cfg.buffer_size = 4096;
+    const auto& latency = latencyParameters(cfg_.latency);
+
+    alsa_in_cfg.period_size = usecsToFrames(latency.period, cfg_.spec);
+    alsa_in_cfg.buffer_size = usecsToFrames(latency.buffer, cfg_.spec);
 
 #ifndef NDEBUG
     std::cerr << "AlsaBackend: pre config: " << alsa_in_cfg << std::endl;
@@ -648,6 +1147,9 @@ namespace audio {
     actual_cfg.spec.format = sampleFormatFromAlsa(alsa_out_cfg.format);
     actual_cfg.spec.rate = alsa_out_cfg.rate;
     actual_cfg.spec.channels = alsa_out_cfg.channels;
+    actual_cfg.latency = cfg_.latency;
+    actual_cfg.period_frames = alsa_out_cfg.period_size;
+    actual_cfg.buffer_frames = alsa_out_cfg.buffer_size;
 
     state_ = BackendState::kOpen;
 
@@ -665,9 +1167,12 @@ namespace audio {
   {
     assert(state_ == BackendState::kOpen);
     assert(alsa_device_ != nullptr);
+    // discard wakeups of the previous run
+    clearWakeup();
+
+    // the playback starts with the first filled buffer (see start threshold)
     try {
       alsa_device_->prepare();
-      alsa_device_->start();
     }
     catch(const AlsaDeviceError& e) {
 #ifndef NDEBUG
@@ -690,11 +1195,11 @@ namespace audio {
     state_ = BackendState::kOpen;
   }
 
-  void AlsaBackend::write(const void* data, size_t bytes)
+  size_t AlsaBackend::write(const void* data, size_t bytes)
   {
     assert(state_ == BackendState::kRunning);
     try {
-      alsa_device_->write(data, bytes);
+      return alsa_device_->write(data, bytes, wakeup_fd_);
     }
     catch(AlsaDeviceError& e) {
       throw makeAlsaBackendError(state_, e);
@@ -705,12 +1210,15 @@ namespace audio {
   {
     assert(state_ == BackendState::kRunning);
     assert(alsa_device_ != nullptr);
+    // the device is prepared again to accept new data
     try {
       alsa_device_->drop();
+      alsa_device_->prepare();
     }
     catch(AlsaDeviceError& e) {
       throw makeAlsaBackendError(state_, e);
     }
+    clearWakeup();
   }
 
   void AlsaBackend::drain()
@@ -725,6 +1233,29 @@ namespace audio {
     }
   }
 
+  std::uint64_t AlsaBackend::xruns() const
+  {
+    return alsa_device_ ? alsa_device_->xruns() : 0;
+  }
+
+  void AlsaBackend::wakeup()
+  {
+    if (wakeup_fd_ >= 0)
+    {
+      std::uint64_t value = 1;
+      [[maybe_unused]] auto result = ::write(wakeup_fd_, &value, sizeof(value));
+    }
+  }
+
+  void AlsaBackend::clearWakeup()
+  {
+    if (wakeup_fd_ >= 0)
+    {
+      std::uint64_t value;
+      [[maybe_unused]] auto result = ::read(wakeup_fd_, &value, sizeof(value));
+    }
+  }
+
   microseconds AlsaBackend::latency()
   {
     assert(alsa_device_ != nullptr);
@@ -822,7 +1353,58 @@ namespace audio {
                            });
   }
 
-  void AlsaBackend::scanAlsaDevices()
+  bool AlsaBackend::probeAlsaDevice(const AlsaDeviceDescription& descr,
+                                    DeviceInfo& info,
+                                    bool& usable)
+  {
+    AlsaDevice alsa_device (descr.name);
+
+    AlsaDeviceCaps device_caps;
+    bool grope_succeeded = true;
+
+    // do not wait for busy devices
+    try {
+      alsa_device.open(SND_PCM_NONBLOCK);
+    }
+    catch (...) {
+      validateAlsaDevice(descr.name, false, false, device_caps);
+      return false;
+    }
+
+    try {
+      device_caps = alsa_device.grope();
+    }
+    catch (...) { grope_succeeded = false; }
+
+    try {
+      alsa_device.close();
+    }
+    catch (...) {}
+
+    usable = validateAlsaDevice(descr.name, true, grope_succeeded, device_caps);
+    if (!usable)
+      return true;
+
+    info.name = descr.name;
+    info.descr = descr.descr;
+    info.min_channels = device_caps.min_channels;
+    info.max_channels = device_caps.max_channels;
+
+    info.channels = std::max(
+      std::min(kDefaultChannels, device_caps.max_channels),
+      device_caps.min_channels);
+
+    info.min_rate = device_caps.min_rate;
+    info.max_rate = device_caps.max_rate;
+
+    info.rate = std::max(
+      std::min(kDefaultRate, device_caps.max_rate),
+      device_caps.min_rate);
+
+    return true;
+  }
+
+  void AlsaBackend::scanDevices(const DeviceCallback& callback)
   {
 #ifndef NDEBUG
     std::cerr << "AlsaBackend: scan devices" << std::endl;
@@ -835,64 +1417,66 @@ namespace audio {
       throw makeAlsaBackendError(state_, e);
     }
 
-    std::vector<DeviceInfo> device_infos;
-    device_infos.reserve( device_descriptions.size() );
+    auto& cache = deviceCache();
 
-    for (auto& device_descr : device_descriptions)
+    // the cache is outdated if cards were added or removed in the meantime
+    auto cards = getCardIds();
     {
-      try {
-        AlsaDevice alsa_device (device_descr.name);
+      std::lock_guard<std::mutex> guard(cache.mutex);
+      if (cards != cache.cards)
+      {
+        cache.entries.clear();
+        cache.cards = std::move(cards);
+      }
+    }
 
-        AlsaDeviceCaps device_caps;
-        bool open_succeeded = true;
-        bool grope_succeeded = true;
+    std::vector<DeviceInfo> device_infos;
+    device_infos.reserve( device_descriptions.size() );
 
-        try {
-          alsa_device.open();
-        }
-        catch (...) { open_succeeded = false; }
+    [[maybe_unused]] std::size_t probed = 0;
 
-        if (open_succeeded)
+    for (auto& device_descr : device_descriptions)
+    {
+      DeviceCache::Entry entry {cardOfDevice(device_descr.name), false, {}};
+      bool cached = false;
+      {
+        std::lock_guard<std::mutex> guard(cache.mutex);
+        if (auto it = cache.entries.find(device_descr.name); it != cache.entries.end())
         {
-          try {
-            device_caps = alsa_device.grope();
-          }
-          catch (...) { grope_succeeded = false; }
+          entry = it->second;
+          cached = true;
         }
+      }
 
-        if (!validateAlsaDevice(device_descr.name, open_succeeded, grope_succeeded, device_caps))
-          continue;
-
-        audio::DeviceInfo device_info;
-
-        device_info.name = device_descr.name;
-        device_info.descr = device_descr.descr;
-        device_info.min_channels = device_caps.min_channels;
-        device_info.max_channels = device_caps.max_channels;
+      if (!cached)
+      {
+        // devices that could not be opened (e.g. busy) are probed again next time
+        try {
+          if (!probeAlsaDevice(device_descr, entry.info, entry.usable))
+            continue;
+        }
+        catch(...) { continue; } // ignore error and try next
 
-        device_info.channels = std::max(
-          std::min(kDefaultChannels, device_caps.max_channels),
-          device_caps.min_channels);
+        ++probed;
 
-        device_info.min_rate = device_caps.min_rate;
-        device_info.max_rate = device_caps.max_rate;
+        std::lock_guard<std::mutex> guard(cache.mutex);
+        cache.entries[device_descr.name] = entry;
+      }
 
-        device_info.rate = std::max(
-          std::min(kDefaultRate, device_caps.max_rate),
-          device_caps.min_rate);
+      if (!entry.usable)
+        continue;
 
-        device_infos.push_back(device_info);
+      device_infos.push_back(entry.info);
 
-        alsa_device.close();
-      }
-      catch(...) {} // ignore error and try next
+      if (!callback(entry.info))
+        break;
     }
 
     std::swap(device_infos_,device_infos);
 
 #ifndef NDEBUG
     std::cerr << "AlsaBackend: " << device_descriptions.size() << " devices found ("
-              << device_infos_.size() << " usable)" << std::endl;
+              << device_infos_.size() << " usable, " << probed << " probed)" << std::endl;
 #endif
   }
 
@@ -22,12 +22,30 @@
 
 #include "AudioBackend.h"
 #include <alsa/asoundlib.h>
+#include <poll.h>
 #include <memory>
 
 namespace audio {
 
   /**
-   * Alsa Backend
+   * @class AlsaBackend
+   * @brief Alsa Backend
+   *
+   * The backend waits for the device on its poll descriptors. The software
+   * parameters of the device wake up the writer once a period is available
+   * and start the playback as soon as the buffer is filled. A blocking
+   * write() can be interrupted with wakeup(), which signals an eventfd that
+   * is polled along with the device.
+   *
+   * If the device supports it, the audio data is copied directly into the
+   * memory mapped ring buffer of the device (SND_PCM_ACCESS_MMAP_INTERLEAVED).
+   * Otherwise the backend falls back to snd_pcm_writei().
+   *
+   * The capabilities of probed devices are cached by device name and card
+   * id and shared by all backend instances. The cache entries of a card are
+   * invalidated by the device monitor (see waitDeviceChange()), which
+   * listens to the ALSA control events of the cards and watches /dev/snd
+   * for added or removed cards.
    */
   class AlsaBackend : public Backend
   {
@@ -41,16 +59,22 @@ namespace audio {
     AlsaBackend& operator=(AlsaBackend&&) noexcept;
 
     std::vector<DeviceInfo> devices() override;
+    void scanDevices(const DeviceCallback& callback) override;
+    bool hasDeviceMonitor() const override
+      { return true; }
+    bool waitDeviceChange(microseconds timeout) override;
     void configure(const DeviceConfig& config) override;
     DeviceConfig configuration() override;
     DeviceConfig open() override;
     void close() override;
     void start() override;
     void stop() override;
-    void write(const void* data, size_t bytes) override;
+    size_t write(const void* data, size_t bytes) override;
     void flush() override;
     void drain() override;
     microseconds latency() override;
+    std::uint64_t xruns() const override;
+    void wakeup() override;
     BackendState state() const override;
 
   private:
@@ -78,6 +102,7 @@ namespace audio {
 
     struct AlsaDeviceConfig
     {
+      snd_pcm_access_t access;
       snd_pcm_format_t format;
       unsigned int channels;
       unsigned int rate;
@@ -85,6 +110,8 @@ namespace audio {
       snd_pcm_uframes_t buffer_size;
     };
 
+    class AlsaMonitor;
+
     class AlsaDevice {
     public:
       explicit AlsaDevice(const std::string& name);
@@ -95,17 +122,19 @@ namespace audio {
       AlsaDevice& operator=(const AlsaDevice& device) = delete;
       AlsaDevice& operator=(AlsaDevice&& device) noexcept;
 
-      void open();
+      void open(int mode = 0);
       void close();
       AlsaDeviceConfig setup(const AlsaDeviceConfig& config);
       void prepare();
       void start();
-      void write(const void* data, size_t bytes);
+      size_t write(const void* data, size_t bytes, int wakeup_fd = -1);
       void drop();
       void drain();
       AlsaDeviceCaps grope();
       snd_pcm_state_t state();
       microseconds delay();
+      std::uint64_t xruns() const
+        { return xruns_; }
 
       static std::vector<AlsaDeviceDescription> getAvailableDevices();
 
@@ -113,19 +142,36 @@ namespace audio {
       std::string name_;
       snd_pcm_t* pcm_;
       unsigned int rate_; // cache
+      snd_pcm_access_t access_; // cache
+      snd_pcm_uframes_t avail_min_; // cache
+      snd_pcm_uframes_t buffer_size_; // cache
+      snd_pcm_uframes_t start_threshold_; // cache
+      std::uint64_t xruns_; // recovered underruns
+      std::vector<pollfd> poll_fds_; // device descriptors + wakeup descriptor
+
+      void setupAccess(snd_pcm_hw_params_t* hw_params, AlsaDeviceConfig& config);
+      void setupSoftware(const AlsaDeviceConfig& config);
+      snd_pcm_sframes_t transfer(const void* data, snd_pcm_uframes_t frames);
+      snd_pcm_sframes_t transferMmap(const void* data, snd_pcm_uframes_t frames);
+      void startAtThreshold();
+      bool wait(int wakeup_fd);
+      void recover(int error);
     };
 
     BackendState state_;
     audio::DeviceConfig cfg_;
     std::vector<DeviceInfo> device_infos_;
     std::unique_ptr<AlsaDevice> alsa_device_;
+    std::unique_ptr<AlsaMonitor> monitor_;
+    int wakeup_fd_;
 
+    void clearWakeup();
     bool validateAlsaDevice(const std::string& name,
                             bool open_succeeded,
                             bool grope_succeeded,
                             const AlsaDeviceCaps& caps);
 
-    void scanAlsaDevices();
+    bool probeAlsaDevice(const AlsaDeviceDescription& descr, DeviceInfo& info, bool& usable);
 
     // debug helper
     friend std::ostream& operator<<(std::ostream&, const AlsaDeviceCaps&);
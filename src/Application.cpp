@@ -119,6 +119,7 @@ void Application::initActions()
     {
       {kActionQuit,            sigc::mem_fun(*this, &Application::onQuit)},
       {kActionStart,           sigc::mem_fun(*this, &Application::onStart)},
+      {kActionPause,           sigc::mem_fun(*this, &Application::onPause)},
       {kActionTempo,           sigc::mem_fun(*this, &Application::onTempo)},
       {kActionTempoChange,     sigc::mem_fun(*this, &Application::onTempoChange)},
       {kActionTempoScale,      sigc::mem_fun(*this, &Application::onTempoScale)},
@@ -238,7 +239,11 @@ void Application::initProfiles()
 void Application::initTicker()
 {
   loadSelectedSoundTheme();
+  updateTickerVolume();
+  ticker_.setRealtime(settings::preferences()->get_boolean(settings::kKeyPrefsAudioRealtime));
   configureAudioBackend();
+  updateTickerStandby();
+  updateTransportTimer();
 }
 
 namespace {
@@ -263,6 +268,9 @@ namespace {
 #endif
 #if HAVE_PULSEAUDIO
       case audio::BackendIdentifier::kPulseAudio: details += "PulseAudio ("; break;
+#endif
+#if HAVE_JACK
+      case audio::BackendIdentifier::kJACK: details += "JACK ("; break;
 #endif
       default: details += "unknown ("; break;
       };
@@ -347,34 +355,31 @@ double Application::getCurrentVolume() const
     return global_volume;
 }
 
-void Application::updateTickerSound(Accent accent, double volume)
+void Application::updateTickerSound(Accent accent)
 {
   if (accent == kAccentOff)
     return;
 
-  if (volume <= 0.0)
-    volume = getCurrentVolume();
-
   audio::SoundParameters params;
 
   if (settings_sound_params_[accent])
     SettingsListDelegate<SoundTheme>::loadParameters(settings_sound_params_[accent], params);
 
-  params.volume *= volume / 100.0;
   ticker_.setSound(accent, params);
 }
 
-void Application::updateTickerSound(const AccentFlags& flags, double volume)
+void Application::updateTickerSound(const AccentFlags& flags)
 {
-  if (flags.none())
-    return;
-
-  if (volume <= 0.0)
-    volume = getCurrentVolume();
-
   for (auto accent : {kAccentWeak, kAccentMid, kAccentStrong})
     if (flags[accent])
-      updateTickerSound(accent, volume);
+      updateTickerSound(accent);
+}
+
+// The volume is applied by the ticker in real-time, i.e. the accent sounds
+// are not synthesized again.
+void Application::updateTickerVolume()
+{
+  ticker_.setVolume(getCurrentVolume());
 }
 
 void Application::configureAudioBackend()
@@ -383,39 +388,34 @@ void Application::configureAudioBackend()
   Message error_message;
 
   try {
-    // dispose old backend and install a temporary dummy backend
-    ticker_.getBackend();
-
     settings::AudioBackend backend = (settings::AudioBackend)
       settings::preferences()->get_enum(settings::kKeyPrefsAudioBackend);
 
     auto backend_id = settings::audioBackendToIdentifier(backend);
 
-    // create new backend
-    if (auto new_backend = audio::createBackend(backend_id);
-        new_backend != nullptr)
-    {
-      // save device list
-      auto audio_devices = new_backend->devices();
+    // enumerate the devices in the background (see onDeviceTimer)
+    device_scanner_.scan(backend_id);
+    startDeviceTimer();
 
-      std::vector<Glib::ustring> dev_list;
-      dev_list.reserve(audio_devices.size());
-
-      std::transform(audio_devices.begin(), audio_devices.end(), std::back_inserter(dev_list),
-                     [] (const auto& dev) { return dev.name; });
+    // create new backend
+    auto new_backend = audio::createBackend(backend_id);
 
+    if (new_backend == nullptr)
+    {
+      // dispose old backend and install a temporary dummy backend
+      ticker_.getBackend();
+    }
+    else
+    {
       // configure and install new backend
       auto device_config = audio::kDefaultConfig;
       device_config.name = currentAudioDevice();
+      device_config.latency = currentLatencyProfile();
 
       new_backend->configure(device_config);
-      ticker_.setBackend( std::move(new_backend) );
 
-      // update device list action state
-      Glib::Variant<std::vector<Glib::ustring>> dev_list_state
-        = Glib::Variant<std::vector<Glib::ustring>>::create(dev_list);
-
-      lookupSimpleAction(kActionAudioDeviceList)->set_state(dev_list_state);
+      // the ticker switches to the new backend while the old one keeps playing
+      ticker_.setBackend( std::move(new_backend) );
     }
   }
   catch(const audio::BackendError& e)
@@ -441,13 +441,20 @@ void Application::configureAudioDevice()
     audio::DeviceConfig device_config =
     {
       currentAudioDevice(),
-      audio::kDefaultSpec
+      audio::kDefaultSpec,
+      currentLatencyProfile()
     };
 
-    if (auto backend = ticker_.getBackend(); backend)
+    settings::AudioBackend backend = (settings::AudioBackend)
+      settings::preferences()->get_enum(settings::kKeyPrefsAudioBackend);
+
+    // A new instance of the backend is opened while the current device keeps
+    // playing (see audio::Ticker::swapBackend).
+    if (auto new_backend = audio::createBackend(settings::audioBackendToIdentifier(backend));
+        new_backend != nullptr)
     {
-      backend->configure(device_config);
-      ticker_.setBackend(std::move(backend));
+      new_backend->configure(device_config);
+      ticker_.setBackend(std::move(new_backend));
     }
   }
   catch(...)
@@ -458,6 +465,20 @@ void Application::configureAudioDevice()
   }
 }
 
+void Application::updateTickerStandby()
+{
+  try {
+    ticker_.setStandby(settings::preferences()->get_boolean(settings::kKeyPrefsAudioStandby));
+    startCommandTimer();
+  }
+  catch(...)
+  {
+    Message error_message = getDefaultMessage(MessageIdentifier::kAudioError);
+    error_message.details = getErrorDetails(std::current_exception());
+    signal_message_.emit(error_message);
+  }
+}
+
 Glib::RefPtr<Gio::SimpleAction> Application::lookupSimpleAction(const Glib::ustring& name)
 {
   Glib::RefPtr<Gio::Action> action = lookup_action(name);
@@ -643,10 +664,10 @@ void Application::onVolumeChange(const Glib::VariantBase& value)
 void Application::onVolumeMute(const Glib::VariantBase& value)
 {
   lookupSimpleAction(kActionVolumeMute)->set_state(value);
-  updateTickerSound(kAccentMaskAll);
+  updateTickerVolume();
 }
 
-double Application::getReferenceTempo() const
+double Application::getReferenceTempo()
 {
   double ref_tempo = 0.0;
 
@@ -654,7 +675,8 @@ double Application::getReferenceTempo() const
       state.test(audio::Ticker::StateFlag::kStarted)
       && !state.test(audio::Ticker::StateFlag::kError))
   {
-    const auto& info = ticker_.getInfo();
+    // peek at the status without consuming it (see onInfoTimer)
+    const auto info = ticker_.getInfo(false);
 
     if (info.generator == audio::kRegularGenerator)
     {
@@ -1246,6 +1268,7 @@ void Application::onStart(const Glib::VariantBase& value)
     {
       ticker_.start();
       startInfoTimer();
+      startCommandTimer();
     }
     else
     {
@@ -1280,6 +1303,34 @@ void Application::onStart(const Glib::VariantBase& value)
   }
 
   lookupSimpleAction(kActionStart)->set_state(new_state);
+
+  // a new session is never paused
+  lookupSimpleAction(kActionPause)->set_state(Glib::Variant<bool>::create(false));
+}
+
+void Application::onPause(const Glib::VariantBase& value)
+{
+  Glib::Variant<bool> new_state
+    = Glib::VariantBase::cast_dynamic<Glib::Variant<bool>>(value);
+
+  // only a started metronome can be paused
+  if (!queryStart())
+    return;
+
+  try {
+    if (new_state.get())
+      ticker_.pause();
+    else
+      ticker_.resume();
+  }
+  catch(...)
+  {
+    // this will handle the error
+    change_action_state(kActionStart, Glib::Variant<bool>::create(false));
+    return;
+  }
+
+  lookupSimpleAction(kActionPause)->set_state(new_state);
 }
 
 Glib::ustring Application::currentAudioDeviceKey()
@@ -1303,6 +1354,14 @@ Glib::ustring Application::currentAudioDevice()
     return "";
 }
 
+audio::LatencyProfile Application::currentLatencyProfile()
+{
+  settings::AudioLatency latency = (settings::AudioLatency)
+    settings::preferences()->get_enum(settings::kKeyPrefsAudioLatency);
+
+  return settings::audioLatencyToProfile(latency);
+}
+
 void Application::onSettingsPrefsChanged(const Glib::ustring& key)
 {
   if (key == settings::kKeyPrefsLinkSoundTheme)
@@ -1322,10 +1381,22 @@ void Application::onSettingsPrefsChanged(const Glib::ustring& key)
   {
     configureAudioBackend();
   }
-  else if (key == currentAudioDeviceKey())
+  else if (key == currentAudioDeviceKey() || key == settings::kKeyPrefsAudioLatency)
   {
     configureAudioDevice();
   }
+  else if (key == settings::kKeyPrefsAudioRealtime)
+  {
+    ticker_.setRealtime(settings::preferences()->get_boolean(settings::kKeyPrefsAudioRealtime));
+  }
+  else if (key == settings::kKeyPrefsAudioStandby)
+  {
+    updateTickerStandby();
+  }
+  else if (key == settings::kKeyPrefsAudioTransport)
+  {
+    updateTransportTimer();
+  }
 }
 
 void Application::onSettingsStateChanged(const Glib::ustring& key)
@@ -1348,7 +1419,7 @@ void Application::onSettingsSoundChanged(const Glib::ustring& key)
     if (queryVolumeMute())
       activate_action(kActionVolumeMute);
     else
-      updateTickerSound(kAccentMaskAll);
+      updateTickerVolume();
   }
   else if (key == settings::kKeySettingsListSelectedEntry)
   {
@@ -1424,6 +1495,100 @@ bool Application::onInfoTimer()
   }
 }
 
+namespace {
+  constexpr milliseconds kTransportTimerInterval = 100ms;
+}
+
+void Application::updateTransportTimer()
+{
+  transport_timer_connection_.disconnect();
+  transport_ = {};
+
+  if (settings::preferences()->get_boolean(settings::kKeyPrefsAudioTransport))
+  {
+    transport_timer_connection_ = Glib::signal_timeout()
+      .connect(sigc::mem_fun(*this, &Application::onTransportTimer),
+               kTransportTimerInterval.count());
+  }
+}
+
+bool Application::onTransportTimer()
+{
+  audio::Transport transport;
+
+  // follow the changes of the transport only, so that the user can still
+  // start, stop or change the tempo of the metronome while it is rolling
+  if (ticker_.transport(transport))
+  {
+    if (transport.rolling != transport_.rolling)
+      change_action_state(kActionStart, Glib::Variant<bool>::create(transport.rolling));
+
+    if (transport.tempo > 0.0 && transport.tempo != transport_.tempo)
+      activate_action(kActionTempo, Glib::Variant<double>::create(transport.tempo));
+  }
+  else transport = {};
+
+  transport_ = transport;
+  return true;
+}
+
+namespace {
+  constexpr milliseconds kCommandTimerInterval = 100ms;
+}
+
+void Application::startCommandTimer()
+{
+  if (!command_timer_connection_.connected())
+  {
+    command_timer_connection_ = Glib::signal_timeout()
+      .connect(sigc::mem_fun(*this, &Application::onCommandTimer),
+               kCommandTimerInterval.count());
+  }
+}
+
+bool Application::onCommandTimer()
+{
+  // deliver the commands that did not fit into the command queue of the
+  // audio thread (see audio::Ticker::flush) as long as the thread is running
+  ticker_.flush();
+  return ticker_.state().test(audio::Ticker::StateFlag::kRunning);
+}
+
+namespace {
+  constexpr milliseconds kDeviceTimerInterval = 100ms;
+}
+
+void Application::startDeviceTimer()
+{
+  if (!device_timer_connection_.connected())
+  {
+    device_timer_connection_ = Glib::signal_timeout()
+      .connect(sigc::mem_fun(*this, &Application::onDeviceTimer),
+               kDeviceTimerInterval.count());
+  }
+}
+
+bool Application::onDeviceTimer()
+{
+  // the final result is available once the scanner became inactive
+  bool active = device_scanner_.active();
+
+  if (std::vector<audio::DeviceInfo> devices; device_scanner_.update(devices))
+  {
+    std::vector<Glib::ustring> dev_list;
+    dev_list.reserve(devices.size());
+
+    std::transform(devices.begin(), devices.end(), std::back_inserter(dev_list),
+                   [] (const auto& dev) { return dev.name; });
+
+    Glib::Variant<std::vector<Glib::ustring>> dev_list_state
+      = Glib::Variant<std::vector<Glib::ustring>>::create(dev_list);
+
+    lookupSimpleAction(kActionAudioDeviceList)->set_state(dev_list_state);
+  }
+  return active;
+}
+
 void Application::startDropVolumeTimer(double drop)
 {
   setVolumeDrop(std::max(getVolumeDrop(), std::clamp(drop, 0.0, 100.0)));
@@ -1460,7 +1625,7 @@ bool Application::onDropVolumeTimer()
 void Application::setVolumeDrop(double drop)
 {
   volume_drop_ = std::clamp(drop, 0.0, 100.0);
-  updateTickerSound(kAccentMaskAll);
+  updateTickerVolume();
 }
 
 std::pair<double,bool> Application::validateTempo(double value)
@@ -23,6 +23,7 @@
 #include "ProfileManager.h"
 #include "Action.h"
 #include "Ticker.h"
+#include "DeviceScanner.h"
 #include "TapAnalyser.h"
 #include "Message.h"
 #include "Meter.h"
@@ -47,11 +48,16 @@ public:
   sigc::signal<void, const audio::Ticker::Info&> signalTickerInfo()
     { return signal_ticker_info_; }
 
+  audio::Ticker::Stats tickerStats() const
+    { return ticker_.stats(); }
+
 private:
   audio::Ticker ticker_;
+  audio::DeviceScanner device_scanner_;
   TapAnalyser tap_analyser_;
   ProfileManager profile_manager_;
   double volume_drop_{0.0};
+  audio::Transport transport_;
 
   // Current sound theme parameter settings
   std::array<Glib::RefPtr<Gio::Settings>, kNumAccents> settings_sound_params_;
@@ -60,6 +66,9 @@ private:
   sigc::connection settings_state_connection_;
   sigc::connection info_timer_connection_;
   sigc::connection volume_timer_connection_;
+  sigc::connection transport_timer_connection_;
+  sigc::connection command_timer_connection_;
+  sigc::connection device_timer_connection_;
   std::array<sigc::connection, kNumAccents> settings_sound_params_connections_;
 
   // Signals
@@ -77,10 +86,12 @@ private:
 
   void loadSelectedSoundTheme();
   double getCurrentVolume() const;
-  void updateTickerSound(Accent accent, double volume = -1.0);
-  void updateTickerSound(const AccentFlags& flags, double volume = -1.0);
+  void updateTickerSound(Accent accent);
+  void updateTickerSound(const AccentFlags& flags);
+  void updateTickerVolume();
   void configureAudioBackend();
   void configureAudioDevice();
+  void updateTickerStandby();
 
   Glib::RefPtr<Gio::SimpleAction> lookupSimpleAction(const Glib::ustring& name);
 
@@ -104,7 +115,7 @@ private:
   void onVolumeMute(const Glib::VariantBase& value);
 
   // Tempo
-  double getReferenceTempo() const;
+  double getReferenceTempo();
   void onTempo(const Glib::VariantBase& value);
   void onTempoChange(const Glib::VariantBase& value);
   void onTempoScale(const Glib::VariantBase& value);
@@ -157,10 +168,12 @@ private:
 
   // Transport and Volume
   void onStart(const Glib::VariantBase& value);
+  void onPause(const Glib::VariantBase& value);
 
   // Audio Device
   Glib::ustring currentAudioDeviceKey();
   Glib::ustring currentAudioDevice();
+  audio::LatencyProfile currentLatencyProfile();
 
   // Settings
   void onSettingsPrefsChanged(const Glib::ustring& key);
@@ -173,6 +186,15 @@ private:
   void stopInfoTimer();
   bool onInfoTimer();
 
+  void updateTransportTimer();
+  bool onTransportTimer();
+
+  void startCommandTimer();
+  bool onCommandTimer();
+
+  void startDeviceTimer();
+  bool onDeviceTimer();
+
   void startDropVolumeTimer(double drop = 50.0);
   void stopDropVolumeTimer();
   bool isDropVolumeTimerRunning();
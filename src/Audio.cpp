@@ -22,6 +22,50 @@
 
 namespace audio {
 
+  namespace {
+
+    const LatencyParameters kLatencyUltraLow =
+    {
+      10ms,   // max_chunk
+      5ms,    // avg_chunk
+      50ms,   // fill_buffer
+      5ms,    // period
+      20ms    // buffer
+    };
+
+    const LatencyParameters kLatencyNormal =
+    {
+      80ms,   // max_chunk
+      50ms,   // avg_chunk
+      200ms,  // fill_buffer
+      20ms,   // period
+      80ms    // buffer
+    };
+
+    const LatencyParameters kLatencyPowerSave =
+    {
+      200ms,  // max_chunk
+      150ms,  // avg_chunk
+      400ms,  // fill_buffer
+      100ms,  // period
+      400ms   // buffer
+    };
+
+  }//unnamed namespace
+
+  const LatencyParameters& latencyParameters(LatencyProfile profile)
+  {
+    switch (profile)
+    {
+    case LatencyProfile::kUltraLow: return kLatencyUltraLow; break;
+    case LatencyProfile::kPowerSave: return kLatencyPowerSave; break;
+    case LatencyProfile::kNormal:
+      [[fallthrough]];
+    default: return kLatencyNormal;
+      break;
+    };
+  }
+
   bool operator==(const StreamSpec& lhs, const StreamSpec& rhs)
   {
     return lhs.format == rhs.format
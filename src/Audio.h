@@ -106,6 +106,33 @@ namespace audio {
     kDefaultChannels
   };
 
+  /**
+   * Latency profiles trade the responsiveness of the audio stream (i.e. how
+   * fast parameter changes become audible) for power consumption (number of
+   * wake-ups of the audio thread and the device).
+   */
+  enum class LatencyProfile : unsigned char
+  {
+    kUltraLow   = 0,
+    kNormal     = 1,
+    kPowerSave  = 2
+  };
+
+  constexpr LatencyProfile kDefaultLatencyProfile = LatencyProfile::kNormal;
+
+  /** Buffer durations of a latency profile. */
+  struct LatencyParameters
+  {
+    microseconds max_chunk;    //!< Maximum duration of a generated chunk
+    microseconds avg_chunk;    //!< Preferred duration of a generated chunk
+    microseconds fill_buffer;  //!< Duration of the silence at stream start
+    microseconds period;       //!< Preferred period size of the device
+    microseconds buffer;       //!< Preferred buffer size of the device
+  };
+
+  /** Returns the buffer durations of a latency profile. */
+  const LatencyParameters& latencyParameters(LatencyProfile profile);
+
   // SampleValueType
   template<SampleFormat Format> struct SampleValueType
   {};
@@ -33,6 +33,9 @@
 #ifdef HAVE_PULSEAUDIO
 #include "PulseAudio.h"
 #endif
+#ifdef HAVE_JACK
+#include "Jack.h"
+#endif
 
 namespace audio {
 
@@ -48,6 +51,9 @@ namespace audio {
 #endif
 #ifdef HAVE_PULSEAUDIO
       BackendIdentifier::kPulseAudio,
+#endif
+#ifdef HAVE_JACK
+      BackendIdentifier::kJACK,
 #endif
     };
     return backends;
@@ -73,6 +79,11 @@ namespace audio {
     case BackendIdentifier::kPulseAudio:
       backend = std::make_unique<PulseAudioBackend>();
       break;
+#endif
+#ifdef HAVE_JACK
+    case BackendIdentifier::kJACK:
+      backend = std::make_unique<JackBackend>();
+      break;
 #endif
     case BackendIdentifier::kNone:
       backend = std::make_unique<DummyBackend>();
@@ -24,6 +24,8 @@
 #include "Error.h"
 #include <vector>
 #include <memory>
+#include <functional>
+#include <cstdint>
 
 namespace audio {
 
@@ -40,14 +42,30 @@ namespace audio {
     SampleRate     rate;          //!< Preferred sample rate
   };
 
-  /** A structure to configure an audio device. */
+  /**
+   * @brief A structure to configure an audio device
+   *
+   * The period and buffer sizes are ignored by Backend::configure(). They are
+   * set in the configuration that is returned by Backend::open() by backends
+   * that know the buffer layout of the device (0 otherwise).
+   */
   struct DeviceConfig
   {
-    std::string name;
-    StreamSpec  spec;
+    std::string     name;
+    StreamSpec      spec;
+    LatencyProfile  latency {kDefaultLatencyProfile};
+    size_t          period_frames {0};  //!< Period size of the device in frames
+    size_t          buffer_frames {0};  //!< Buffer size of the device in frames
   };
 
-  const DeviceConfig kDefaultConfig = { "", kDefaultSpec };
+  const DeviceConfig kDefaultConfig = { "", kDefaultSpec, kDefaultLatencyProfile };
+
+  /** The state of the transport of a sound server (see Backend::transport()). */
+  struct Transport
+  {
+    bool    rolling {false};  //!< Transport is rolling (or starting)
+    double  tempo {0.0};      //!< Tempo in beats per minute (0 if unknown)
+  };
 
   enum class BackendState
   {
@@ -56,6 +74,30 @@ namespace audio {
     kRunning  = 2
   };
 
+  /** The way audio data is transferred to a backend. */
+  enum class BackendMode
+  {
+    kPush  = 0,  //!< The client writes audio data with the blocking write()
+    kPull  = 1   //!< The backend requests audio data from a RenderCallback
+  };
+
+  /**
+   * @class RenderCallback
+   * @brief Interface of a client that provides audio data in pull mode
+   */
+  class RenderCallback {
+  public:
+    virtual ~RenderCallback() {}
+
+    /**
+     * @brief Fill a buffer with the given number of frames
+     *
+     * This function is called by the backend from a real-time (device) thread
+     * and must neither block nor throw.
+     */
+    virtual void render(void* data, size_t frames) noexcept = 0;
+  };
+
   /**
    * @class Backend
    *
@@ -65,7 +107,8 @@ namespace audio {
    * -# Open:    After configuration use open() to check the configuration and
    *             open the audio device.
    * -# Running: Call start() to reach the Running mode from the Open mode.
-   *             In this state you can use the blocking i/o operations (write).
+   *             In this state you can use the blocking i/o operations (write)
+   *             or, in pull mode, the backend calls the render callback.
    *
    * The backend state is changed with the following transitions:
    *
@@ -76,23 +119,74 @@ namespace audio {
    *   -# Open    --> Config    [@ref close()]
 
    * All other attempts to change the state result in a state transition error.
+   *
+   * Backends that operate in pull mode (see mode()) do not accept write()
+   * calls. Instead they request the audio data from a RenderCallback, that
+   * has to be installed with setRenderCallback() before the backend is opened.
+   *
+   * Backends that are able to detect buffer underruns report the number of
+   * underruns since the device was opened with xruns().
+   *
+   * A blocking write() can be interrupted from another thread with wakeup(),
+   * e.g. to stop the audio thread or to swap the backend without waiting for
+   * the device. The interrupted write() returns without writing the remaining
+   * data, i.e. it returns less than the requested number of bytes. A wakeup
+   * that arrives while no write() is in progress interrupts the next write()
+   * (until the backend is restarted or flushed).
+   *
+   * The audio data that is queued in the device is discarded with flush(),
+   * which also discards pending wakeups, while drain() waits until the queued
+   * data was played.
+   *
+   * Backends with precise timing information report the playback position
+   * of the running stream with position(), i.e. the duration of the audio
+   * data that was actually played by the device since the stream started.
+   *
+   * The available devices are listed with devices(). Backends that probe the
+   * devices one by one report them incrementally with scanDevices(), which
+   * stops as soon as the callback returns false. Backends that are able to
+   * detect changes of the available devices (e.g. hotplug events) return
+   * true from hasDeviceMonitor() and block in waitDeviceChange() until the
+   * device list might have changed. Since probing the devices can take a
+   * while, the device functions are usually called on a separate backend
+   * instance in a background thread (see DeviceScanner).
+   *
+   * Backends of sound servers with a transport (e.g. JACK) report the state
+   * of the transport with transport(). Unlike the other functions this one
+   * is thread-safe and can be called in any state.
    */
   class Backend {
   public:
     virtual ~Backend() {}
 
+    using DeviceCallback = std::function<bool(const DeviceInfo&)>;
+
     virtual std::vector<DeviceInfo> devices() = 0;
+    virtual void scanDevices(const DeviceCallback& callback)
+      {
+        for (const auto& device : devices())
+          if (!callback(device))
+            break;
+      }
+    virtual bool hasDeviceMonitor() const { return false; }
+    virtual bool waitDeviceChange(microseconds timeout) { return false; }
     virtual void configure(const DeviceConfig& config) = 0;
     virtual DeviceConfig configuration() = 0;
     virtual DeviceConfig open() = 0;
     virtual void close() = 0;
     virtual void start() = 0;
     virtual void stop() = 0;
-    virtual void write(const void* data, size_t bytes) = 0;
+    virtual size_t write(const void* data, size_t bytes) = 0;
     virtual void flush() = 0;
     virtual void drain() = 0;
     virtual microseconds latency() { return 0us; }
+    virtual microseconds position() { return 0us; }
+    virtual std::uint64_t xruns() const { return 0; }
+    virtual void wakeup() {}
+    virtual bool transport(Transport& transport) { return false; }
     virtual BackendState state() const = 0;
+    virtual BackendMode mode() const { return BackendMode::kPush; }
+    virtual void setRenderCallback(RenderCallback* callback) {}
   };
 
   enum class BackendIdentifier
@@ -106,6 +200,9 @@ namespace audio {
 #endif
 #if HAVE_PULSEAUDIO
     kPulseAudio = 3,
+#endif
+#if HAVE_JACK
+    kJACK = 4,
 #endif
   };
 
@@ -22,13 +22,21 @@
 #endif
 
 #include "AudioBackendDummy.h"
-#include <thread>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <time.h>
+
+#ifndef NDEBUG
+# include <iostream>
+#endif
 
 namespace audio {
 
   namespace {
 
+    using std::chrono::nanoseconds;
+
     const std::string kDummyDeviceName = ""; // Default
 
     const DeviceInfo kDummyInfo =
@@ -45,13 +53,39 @@ namespace audio {
 
     const DeviceConfig kDummyConfig = { kDummyDeviceName, kDefaultSpec };
 
+    constexpr std::uint64_t kNanosPerSecond = 1000000000;
+
+    nanoseconds monotonicNow()
+    {
+      timespec ts;
+      clock_gettime(CLOCK_MONOTONIC, &ts);
+      return std::chrono::seconds(ts.tv_sec) + nanoseconds(ts.tv_nsec);
+    }
+
+    void sleepUntil(nanoseconds time)
+    {
+      timespec ts;
+      ts.tv_sec = time / 1s;
+      ts.tv_nsec = (time % 1s).count();
+
+      while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR);
+    }
+
   }//unnamed namespace
 
-  DummyBackend::DummyBackend()
+  DummyBackend::DummyBackend(BackendMode mode, const DummyDevice& device)
     : state_(BackendState::kConfig),
-      cfg_(kDummyConfig)
+      mode_(mode),
+      cfg_(kDummyConfig),
+      device_(device)
   {}
 
+  DummyBackend::~DummyBackend()
+  {
+    if (state_ == BackendState::kRunning)
+      stop();
+  }
+
   std::vector<DeviceInfo> DummyBackend::devices()
   { return {kDummyInfo}; }
 
@@ -64,8 +98,36 @@ namespace audio {
   DeviceConfig DummyBackend::open()
   {
     assert(state_ == BackendState::kConfig);
+
+    const StreamSpec& spec = kDummyConfig.spec;
+    const LatencyParameters& params = latencyParameters(cfg_.latency);
+
+    period_frames_ = device_.period_frames > 0
+      ? device_.period_frames : usecsToFrames(params.period, spec);
+    buffer_frames_ = device_.buffer_frames > 0
+      ? device_.buffer_frames : usecsToFrames(params.buffer, spec);
+
+    period_frames_ = std::max<size_t>(period_frames_, 1);
+    buffer_frames_ = std::max(buffer_frames_, period_frames_);
+
+    if (mode_ == BackendMode::kPull)
+    {
+      if (!callback_)
+        throw BackendError(BackendIdentifier::kNone, state_, "missing render callback");
+
+      period_buffer_.reinterpret(spec);
+      period_buffer_.resize(period_frames_ * frameSize(spec));
+    }
+
+    xruns_ = 0;
     state_ = BackendState::kOpen;
-    return kDummyConfig;
+
+    DeviceConfig actual_cfg = kDummyConfig;
+    actual_cfg.latency = cfg_.latency;
+    actual_cfg.period_frames = period_frames_;
+    actual_cfg.buffer_frames = buffer_frames_;
+
+    return actual_cfg;
   }
 
   void DummyBackend::close()
@@ -77,29 +139,251 @@ namespace audio {
   void DummyBackend::start()
   {
     assert(state_ == BackendState::kOpen);
+
+    // discard wakeups of the previous run
+    wakeup_flag_.store(false, std::memory_order_relaxed);
+
+    const nanoseconds now = monotonicNow();
+
+    running_ = false;
+    start_time_ = now;
+    queued_frames_ = 0;
+    played_frames_ = 0;
+    next_xrun_ = device_.xrun_offset > 0us ? now + device_.xrun_offset : nanoseconds(0);
+
+    if (mode_ == BackendMode::kPull)
+    {
+      running_ = true;
+      period_thread_flag_.store(true, std::memory_order_release);
+      period_thread_ = std::thread(&DummyBackend::periodThreadFunction, this);
+    }
+
     state_ = BackendState::kRunning;
   }
 
   void DummyBackend::stop()
   {
     assert(state_ == BackendState::kRunning);
+
+    if (period_thread_.joinable())
+    {
+      period_thread_flag_.store(false, std::memory_order_release);
+      period_thread_.join();
+    }
+    else flush();
+
+    running_ = false;
     state_ = BackendState::kOpen;
   }
 
-  void DummyBackend::write(const void* data, size_t bytes)
+  size_t DummyBackend::write(const void* data, size_t bytes)
   {
     assert(state_ == BackendState::kRunning);
-    if ( bytes > 0 )
-      std::this_thread::sleep_for( audio::bytesToUsecs(bytes, kDummyConfig.spec) );
+
+    if (mode_ == BackendMode::kPull)
+      throw BackendError(BackendIdentifier::kNone, state_, "write not available in pull mode");
+
+    const size_t frame_size = frameSize(kDummyConfig.spec);
+    size_t frames = bytes / frame_size;
+
+    while (frames > 0 && !wakeup_flag_.load(std::memory_order_acquire))
+    {
+      const nanoseconds now = monotonicNow();
+      update(now);
+
+      size_t avail = buffer_frames_ - queued_frames_;
+      if (running_)
+      {
+        // the device releases the ring buffer in whole periods
+        size_t consumed = std::min(elapsedFrames(now), queued_frames_);
+        consumed -= consumed % period_frames_;
+
+        avail += consumed;
+        if (avail == 0)
+        {
+          sleepUntil(framesToTime(consumed + period_frames_));
+          continue;
+        }
+      }
+
+      const size_t count = std::min(avail, frames);
+      queued_frames_ += count;
+      frames -= count;
+
+      // start threshold: the device starts with a filled buffer
+      if (!running_ && queued_frames_ >= buffer_frames_)
+      {
+        running_ = true;
+        start_time_ = now;
+      }
+    }
+
+    return bytes - frames * frame_size;
+  }
+
+  void DummyBackend::flush()
+  {
+    if (mode_ == BackendMode::kPull)
+      return;
+
+    const nanoseconds now = monotonicNow();
+    update(now);
+
+    if (running_)
+      played_frames_ += std::min(elapsedFrames(now), queued_frames_);
+
+    queued_frames_ = 0;
+    running_ = false;
+
+    wakeup_flag_.store(false, std::memory_order_relaxed);
+  }
+
+  void DummyBackend::drain()
+  {
+    if (mode_ == BackendMode::kPull)
+      return;
+
+    const nanoseconds now = monotonicNow();
+    update(now);
+
+    if (queued_frames_ == 0)
+      return;
+
+    if (!running_)
+    {
+      running_ = true;
+      start_time_ = now;
+    }
+
+    sleepUntil(framesToTime(queued_frames_));
+
+    played_frames_ += queued_frames_;
+    queued_frames_ = 0;
+    running_ = false;
   }
 
-  void DummyBackend::flush() {}
+  microseconds DummyBackend::latency()
+  {
+    if (state_ != BackendState::kRunning)
+      return 0us;
+
+    if (mode_ == BackendMode::kPull)
+      return framesToUsecs(period_frames_, kDummyConfig.spec) + device_.output_latency;
+
+    const nanoseconds now = monotonicNow();
+    update(now);
+
+    size_t delay = queued_frames_;
+    if (running_)
+      delay -= std::min(elapsedFrames(now), queued_frames_);
+
+    return framesToUsecs(delay, kDummyConfig.spec) + device_.output_latency;
+  }
+
+  microseconds DummyBackend::position()
+  {
+    if (state_ != BackendState::kRunning)
+      return 0us;
 
-  void DummyBackend::drain() {}
+    const nanoseconds now = monotonicNow();
+    size_t frames = played_frames_;
+
+    if (mode_ == BackendMode::kPull)
+      frames = elapsedFrames(now);
+    else
+    {
+      update(now);
+      if (running_)
+        frames += std::min(elapsedFrames(now), queued_frames_);
+    }
+
+    return std::max(framesToUsecs(frames, kDummyConfig.spec) - device_.output_latency, 0us);
+  }
+
+  std::uint64_t DummyBackend::xruns() const
+  { return xruns_; }
+
+  void DummyBackend::wakeup()
+  { wakeup_flag_.store(true, std::memory_order_release); }
 
   BackendState DummyBackend::state() const
   {
     return state_;
   }
 
+  BackendMode DummyBackend::mode() const
+  {
+    return mode_;
+  }
+
+  void DummyBackend::setRenderCallback(RenderCallback* callback)
+  {
+    assert(state_ == BackendState::kConfig);
+    callback_ = callback;
+  }
+
+  void DummyBackend::update(nanoseconds now)
+  {
+    if (running_)
+    {
+      const nanoseconds dry_time = framesToTime(queued_frames_);
+
+      if (next_xrun_ > nanoseconds(0) && next_xrun_ <= now && next_xrun_ < dry_time)
+        underrun(next_xrun_);
+      else if (dry_time < now)
+        underrun(dry_time);
+    }
+
+    // skip injected xruns that are due (or missed while the device was stopped)
+    while (next_xrun_ > nanoseconds(0) && next_xrun_ <= now)
+    {
+      if (device_.xrun_interval > 0us)
+        next_xrun_ += device_.xrun_interval;
+      else
+        next_xrun_ = nanoseconds(0);
+    }
+  }
+
+  void DummyBackend::underrun(nanoseconds time)
+  {
+    played_frames_ += std::min(elapsedFrames(time), queued_frames_);
+    queued_frames_ = 0;
+    running_ = false;
+    ++xruns_;
+
+#ifndef NDEBUG
+    std::cerr << "DummyBackend: underrun after "
+              << std::chrono::duration_cast<microseconds>(time - start_time_).count()
+              << "us of playback" << std::endl;
+#endif
+  }
+
+  size_t DummyBackend::elapsedFrames(nanoseconds now) const
+  {
+    if (now <= start_time_)
+      return 0;
+
+    const std::uint64_t elapsed = (now - start_time_).count();
+    return elapsed * kDummyConfig.spec.rate / kNanosPerSecond;
+  }
+
+  DummyBackend::nanoseconds DummyBackend::framesToTime(size_t frames) const
+  {
+    // round up to the first point in time the frames are played
+    const std::uint64_t rate = kDummyConfig.spec.rate;
+    return start_time_ + nanoseconds((frames * kNanosPerSecond + rate - 1) / rate);
+  }
+
+  void DummyBackend::periodThreadFunction() noexcept
+  {
+    const size_t frames = period_buffer_.frames();
+
+    // deadlines are derived from the frame count to avoid rounding drift
+    for (size_t period = 1; period_thread_flag_.load(std::memory_order_acquire); ++period)
+    {
+      callback_->render(period_buffer_.data(), frames);
+      sleepUntil(framesToTime(period * frames));
+    }
+  }
+
 }//namespace audio
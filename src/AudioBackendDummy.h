@@ -21,13 +21,56 @@
 #define GMetronome_AudioBackendDummy_h
 
 #include "AudioBackend.h"
+#include "AudioBuffer.h"
+
+#include <thread>
+#include <atomic>
+#include <chrono>
 
 namespace audio {
 
+  /**
+   * @brief Buffer layout and fault injection of the virtual dummy device
+   *
+   * Zero period or buffer sizes are taken from the latency profile of the
+   * device configuration.
+   */
+  struct DummyDevice
+  {
+    size_t        period_frames {0};     //!< Period size in frames
+    size_t        buffer_frames {0};     //!< Ring buffer size in frames
+    microseconds  output_latency {0us};  //!< Latency behind the ring buffer
+    microseconds  xrun_offset {0us};     //!< Time of the first injected xrun (0: none)
+    microseconds  xrun_interval {0us};   //!< Time between injected xruns (0: once)
+  };
+
+  /**
+   * @class DummyBackend
+   * @brief A backend without audio output
+   *
+   * The backend emulates a sound card with a ring buffer, that is consumed
+   * at the sample rate by a virtual device clock. All waits sleep until
+   * absolute deadlines of the monotonic clock, so that the device clock
+   * does not drift from the wall clock, no matter how much the individual
+   * sleeps overshoot.
+   *
+   * In push mode write() blocks until the data fits into the ring buffer.
+   * Space becomes available at period boundaries and the device starts
+   * as soon as the buffer is filled. If the device runs out of data it
+   * stops and counts an underrun. Additionally underruns can be injected
+   * at scheduled times, which drop the content of the ring buffer. The
+   * backend reports the fill level of the ring buffer (plus the output
+   * latency) with latency() and the playback position with position().
+   *
+   * In pull mode a thread requests the audio data from the render callback
+   * in real time, one period at a time.
+   */
   class DummyBackend : public Backend{
 
   public:
-    DummyBackend();
+    explicit DummyBackend(BackendMode mode = BackendMode::kPush,
+                          const DummyDevice& device = {});
+    ~DummyBackend();
 
     std::vector<DeviceInfo> devices() override;
     void configure(const DeviceConfig& config) override;
@@ -36,14 +79,48 @@ namespace audio {
     void close() override;
     void start() override;
     void stop() override;
-    void write(const void* data, size_t bytes) override;
+    size_t write(const void* data, size_t bytes) override;
     void flush() override;
     void drain() override;
+    microseconds latency() override;
+    microseconds position() override;
+    std::uint64_t xruns() const override;
+    void wakeup() override;
     BackendState state() const override;
+    BackendMode mode() const override;
+    void setRenderCallback(RenderCallback* callback) override;
 
   private:
+    using nanoseconds = std::chrono::nanoseconds;
+
     BackendState state_;
+    BackendMode mode_;
     DeviceConfig cfg_;
+    DummyDevice device_;
+
+    // virtual device
+    size_t period_frames_{0};
+    size_t buffer_frames_{0};
+    bool running_{false};        // device clock is running
+    nanoseconds start_time_{0};  // start of the device clock
+    size_t queued_frames_{0};    // frames written since the device (re)started
+    size_t played_frames_{0};    // frames played before the device (re)started
+    nanoseconds next_xrun_{0};   // time of the next injected xrun (0: none)
+    std::uint64_t xruns_{0};
+    std::atomic<bool> wakeup_flag_{false};
+
+    void update(nanoseconds now);
+    void underrun(nanoseconds time);
+    size_t elapsedFrames(nanoseconds now) const;
+    nanoseconds framesToTime(size_t frames) const;
+
+    // pull mode
+    RenderCallback* callback_{nullptr};
+    ByteBuffer period_buffer_;
+    std::thread period_thread_;
+    std::atomic<bool> period_thread_flag_{false};
+
+    void periodThreadFunction() noexcept;
   };
   
 }//namespace audio
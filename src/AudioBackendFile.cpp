@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "AudioBackendFile.h"
+#include <array>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+namespace audio {
+
+  namespace {
+
+    const DeviceInfo kFileInfo =
+    {
+      "",
+      "WAV File",
+      1,
+      2,
+      2,
+      8000,
+      192000,
+      kDefaultRate
+    };
+
+    // WAVE format tags
+    constexpr std::uint16_t kWaveFormatPCM       = 0x0001;
+    constexpr std::uint16_t kWaveFormatIEEEFloat = 0x0003;
+
+    // RIFF header (12) + fmt chunk (8 + 18) + fact chunk (8 + 4) + data chunk header (8)
+    constexpr size_t kHeaderSize = 58;
+
+    // the chunk sizes of the RIFF format are 32 bit values
+    constexpr std::uint64_t kMaxDataBytes =
+      std::numeric_limits<std::uint32_t>::max() - kHeaderSize;
+
+    // output buffer of the file stream
+    constexpr size_t kFileBufferSize = 1 << 20;
+
+    bool isSupported(const StreamSpec& spec)
+    {
+      switch (spec.format) {
+      case SampleFormat::kU8:
+      case SampleFormat::kS16LE:
+      case SampleFormat::kS32LE:
+      case SampleFormat::kFloat32LE:
+        break;
+      default:
+        return false;
+      };
+
+      return spec.channels >= 1 && spec.channels <= 2 && spec.rate > 0;
+    }
+
+    template<typename T>
+    std::uint8_t* putLE(std::uint8_t* out, T value)
+    {
+      for (size_t n = 0; n < sizeof(T); ++n)
+        *out++ = static_cast<std::uint8_t>(value >> (8 * n));
+      return out;
+    }
+
+    std::uint8_t* putTag(std::uint8_t* out, const char* tag)
+    {
+      std::memcpy(out, tag, 4);
+      return out + 4;
+    }
+
+  }//unnamed namespace
+
+  FileBackend::FileBackend()
+    : state_(BackendState::kConfig),
+      cfg_(kDefaultConfig)
+  {}
+
+  FileBackend::~FileBackend()
+  {
+    try {
+      if (state_ == BackendState::kRunning)
+        stop();
+      if (state_ == BackendState::kOpen)
+        close();
+    }
+    catch(...) {}
+  }
+
+  std::vector<DeviceInfo> FileBackend::devices()
+  { return {kFileInfo}; }
+
+  void FileBackend::configure(const DeviceConfig& config)
+  { cfg_ = config; }
+
+  DeviceConfig FileBackend::configuration()
+  { return cfg_; }
+
+  DeviceConfig FileBackend::open()
+  {
+    assert(state_ == BackendState::kConfig);
+
+    if (cfg_.name.empty())
+      throw BackendError(BackendIdentifier::kNone, state_, "missing file name");
+
+    if (!isSupported(cfg_.spec))
+      throw BackendError(BackendIdentifier::kNone, state_, "unsupported stream specification");
+
+    file_ = std::fopen(cfg_.name.c_str(), "wb");
+    if (file_ == nullptr)
+      throwFileError("failed to open file");
+
+    // collect the small chunks of the stream generators
+    std::setvbuf(file_, nullptr, _IOFBF, kFileBufferSize);
+
+    data_bytes_ = 0;
+
+    try {
+      writeHeader();
+    }
+    catch (...) {
+      std::fclose(file_);
+      file_ = nullptr;
+      throw;
+    }
+
+    state_ = BackendState::kOpen;
+
+    DeviceConfig actual_cfg = cfg_;
+    actual_cfg.period_frames = 0;
+    actual_cfg.buffer_frames = 0;
+
+    return actual_cfg;
+  }
+
+  void FileBackend::close()
+  {
+    assert(state_ == BackendState::kOpen);
+
+    // chunks are padded to an even size (see writeHeader)
+    bool failed = (data_bytes_ & 1) && std::fputc(0, file_) == EOF;
+
+    failed = (std::fclose(file_) != 0) || failed;
+    file_ = nullptr;
+
+    state_ = BackendState::kConfig;
+
+    if (failed)
+      throwFileError("failed to close file");
+  }
+
+  void FileBackend::start()
+  {
+    assert(state_ == BackendState::kOpen);
+    state_ = BackendState::kRunning;
+  }
+
+  void FileBackend::stop()
+  {
+    assert(state_ == BackendState::kRunning);
+    state_ = BackendState::kOpen;
+    writeHeader();
+  }
+
+  size_t FileBackend::write(const void* data, size_t bytes)
+  {
+    assert(state_ == BackendState::kRunning);
+
+    if (data_bytes_ + bytes > kMaxDataBytes)
+      throw BackendError(BackendIdentifier::kNone, state_, "file size limit exceeded");
+
+    if (std::fwrite(data, 1, bytes, file_) != bytes)
+      throwFileError("failed to write file");
+
+    data_bytes_ += bytes;
+
+    return bytes;
+  }
+
+  void FileBackend::flush() {}
+
+  void FileBackend::drain()
+  {
+    if (std::fflush(file_) != 0)
+      throwFileError("failed to write file");
+  }
+
+  microseconds FileBackend::position()
+  {
+    return bytesToUsecs(data_bytes_, cfg_.spec);
+  }
+
+  BackendState FileBackend::state() const
+  {
+    return state_;
+  }
+
+  void FileBackend::writeHeader()
+  {
+    const StreamSpec& spec = cfg_.spec;
+
+    const std::uint16_t format_tag = isFloatingPoint(spec.format)
+      ? kWaveFormatIEEEFloat : kWaveFormatPCM;
+
+    const std::uint16_t block_align = frameSize(spec);
+    const std::uint16_t bits = 8 * sampleSize(spec.format);
+    const std::uint32_t data_size = data_bytes_;
+    const std::uint32_t frames = data_bytes_ / block_align;
+
+    std::array<std::uint8_t, kHeaderSize> header;
+
+    auto out = header.data();
+
+    out = putTag(out, "RIFF");
+    out = putLE<std::uint32_t>(out, kHeaderSize - 8 + data_size + (data_size & 1));
+    out = putTag(out, "WAVE");
+
+    // the fact chunk is required for non-PCM formats, so we use the
+    // extended fmt chunk (cbSize = 0) for all formats
+    out = putTag(out, "fmt ");
+    out = putLE<std::uint32_t>(out, 18);
+    out = putLE<std::uint16_t>(out, format_tag);
+    out = putLE<std::uint16_t>(out, spec.channels);
+    out = putLE<std::uint32_t>(out, spec.rate);
+    out = putLE<std::uint32_t>(out, spec.rate * block_align);
+    out = putLE<std::uint16_t>(out, block_align);
+    out = putLE<std::uint16_t>(out, bits);
+    out = putLE<std::uint16_t>(out, 0);
+
+    out = putTag(out, "fact");
+    out = putLE<std::uint32_t>(out, 4);
+    out = putLE<std::uint32_t>(out, frames);
+
+    out = putTag(out, "data");
+    out = putLE<std::uint32_t>(out, data_size);
+
+    assert(out == header.data() + header.size());
+
+    if (std::fseek(file_, 0, SEEK_SET) != 0
+        || std::fwrite(header.data(), 1, header.size(), file_) != header.size()
+        || std::fseek(file_, 0, SEEK_END) != 0
+        || std::fflush(file_) != 0)
+    {
+      throwFileError("failed to write file header");
+    }
+  }
+
+  void FileBackend::throwFileError(const std::string& what)
+  {
+    throw BackendError(BackendIdentifier::kNone, state_,
+                       what + " '" + cfg_.name + "' (" + std::strerror(errno) + ")");
+  }
+
+}//namespace audio
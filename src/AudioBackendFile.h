@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef GMetronome_AudioBackendFile_h
+#define GMetronome_AudioBackendFile_h
+
+#include "AudioBackend.h"
+#include <cstdio>
+
+namespace audio {
+
+  /**
+   * @class FileBackend
+   * @brief A backend that writes the audio stream to a WAV file
+   *
+   * The device name of the configuration is the path of the file. Unlike the
+   * backends of sound cards, write() does not wait for the device, i.e. a
+   * client can render a stream as fast as the CPU allows (e.g. to export a
+   * click track). The header of the file is completed by stop().
+   *
+   * Supported sample formats are kU8, kS16LE, kS32LE (PCM) and kFloat32LE
+   * (IEEE float) with one or two channels.
+   */
+  class FileBackend : public Backend {
+
+  public:
+    FileBackend();
+    ~FileBackend();
+
+    std::vector<DeviceInfo> devices() override;
+    void configure(const DeviceConfig& config) override;
+    DeviceConfig configuration() override;
+    DeviceConfig open() override;
+    void close() override;
+    void start() override;
+    void stop() override;
+    size_t write(const void* data, size_t bytes) override;
+    void flush() override;
+    void drain() override;
+    microseconds position() override;
+    BackendState state() const override;
+
+  private:
+    BackendState state_;
+    DeviceConfig cfg_;
+    std::FILE* file_{nullptr};
+    std::uint64_t data_bytes_{0};
+
+    void writeHeader();
+    [[noreturn]] void throwFileError(const std::string& what);
+  };
+
+}//namespace audio
+#endif//GMetronome_AudioBackendFile_h
@@ -22,6 +22,7 @@
 #endif
 
 #include "AudioBuffer.h"
+#include <limits>
 #include <cassert>
 
 #ifndef NDEBUG
@@ -115,4 +116,51 @@ namespace audio {
     };
   }
 
+  template<SampleFormat Format>
+  void fillSilence(SampleContainerView<Format, ByteBuffer::pointer> samples)
+  {
+    using ValueType = typename SampleValueType<Format>::type;
+
+    if constexpr (isUnsigned(Format))
+    {
+      constexpr ValueType kZeroLevel = (std::numeric_limits<ValueType>::max() >> 1) + 1;
+      for (auto& sample : samples)
+        sample = kZeroLevel;
+    }
+    else
+    {
+      for (auto& sample : samples)
+        sample = ValueType(0);
+    }
+  }
+
+  void fillSilence(ByteBuffer& buffer)
+  {
+    using Fmt = SampleFormat;
+
+    switch(buffer.spec().format)
+    {
+    case Fmt::kU8: fillSilence(viewSamples<Fmt::kU8>(buffer)); break;
+    case Fmt::kU16LE: fillSilence(viewSamples<Fmt::kU16LE>(buffer)); break;
+    case Fmt::kU16BE: fillSilence(viewSamples<Fmt::kU16BE>(buffer)); break;
+    case Fmt::kS8:
+    case Fmt::kS16LE:
+    case Fmt::kS16BE:
+    case Fmt::kS32LE:
+    case Fmt::kS32BE:
+    case Fmt::kFloat32LE:
+    case Fmt::kFloat32BE:
+      // all bits zero
+      std::fill(buffer.begin(), buffer.end(), 0);
+      break;
+    case Fmt::kUnknown:
+      [[fallthrough]];
+    default:
+#ifndef NDEBUG
+      std::cerr << "AudioBuffer: unable to fill silence (unknown sample format)" << std::endl;
+#endif
+      break;
+    };
+  }
+
 }//namespace audio
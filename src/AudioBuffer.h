@@ -879,5 +879,11 @@ namespace audio {
    */
   void resample(const ByteBuffer& source, ByteBuffer& target, const ChannelMap& map = {});
 
+  /**
+   * Fills the buffer with the zero level of its sample format (e.g. 0x80 for
+   * unsigned 8 bit samples).
+   */
+  void fillSilence(ByteBuffer& buffer);
+
 }//namespace audio
 #endif//GMetronome_AudioBuffer_h
@@ -0,0 +1,338 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Benchmarks of the synthesis and stream generation hot paths
+ *
+ * Usage: gmetronome-bench [PATTERN]  (or: make bench BENCH_FILTER=PATTERN)
+ *
+ * Runs all benchmarks whose name contains PATTERN and reports the time per
+ * frame and the number of heap allocations per call. The program does not
+ * depend on GTK and is built with 'make bench'.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "Audio.h"
+#include "AudioBuffer.h"
+#include "Filter.h"
+#include "Generator.h"
+#include "Synthesizer.h"
+#include "WavetableLibrary.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  std::atomic<size_t> allocations {0};
+
+  void* allocate(std::size_t size)
+  {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* ptr = std::malloc(size == 0 ? 1 : size); ptr)
+      return ptr;
+    else
+      throw std::bad_alloc();
+  }
+
+}//unnamed namespace
+
+// count all heap allocations of the program
+void* operator new(std::size_t size)
+{ return allocate(size); }
+
+void* operator new[](std::size_t size)
+{ return allocate(size); }
+
+void operator delete(void* ptr) noexcept
+{ std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept
+{ std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept
+{ std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{ std::free(ptr); }
+
+namespace {
+
+  using namespace audio;
+
+  using Clock = std::chrono::steady_clock;
+
+  // minimum run time and number of calls of a benchmark
+  constexpr std::chrono::milliseconds kMinDuration = 200ms;
+  constexpr size_t kMinCalls = 10;
+
+  const StreamSpec kFilterSpec = { filter::kDefaultSampleFormat, kDefaultRate, 2 };
+
+  std::string pattern;
+
+  /**
+   * Calls the function repeatedly and prints the time per frame and the
+   * number of allocations per call. The function returns the number of
+   * frames that it processed. The first call is not measured, since it
+   * may allocate resources.
+   */
+  template<typename Function>
+  void measure(const std::string& name, Function&& fu)
+  {
+    if (name.find(pattern) == std::string::npos)
+      return;
+
+    fu(); // warm up
+
+    size_t calls = 0;
+    size_t frames = 0;
+    size_t allocs_start = allocations.load(std::memory_order_relaxed);
+
+    auto start = Clock::now();
+    auto elapsed = Clock::duration::zero();
+    do {
+      frames += fu();
+      ++calls;
+      elapsed = Clock::now() - start;
+    }
+    while (elapsed < kMinDuration || calls < kMinCalls);
+
+    size_t allocs = allocations.load(std::memory_order_relaxed) - allocs_start;
+
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    double ns_per_frame = ns / std::max<size_t>(frames, 1);
+
+    std::printf("%-36s %10.3f ns/frame %10.1f frames/call %8.2f allocs/call\n",
+                name.c_str(), ns_per_frame, (double) frames / calls, (double) allocs / calls);
+  }
+
+  std::vector<std::pair<std::string, SoundParameters>> soundPresets()
+  {
+    SoundParameters tone;
+    tone.mix = -100.0f;
+
+    SoundParameters percussion;
+    percussion.mix = 100.0f;
+    percussion.percussion_cutoff = 5000.0f;
+
+    SoundParameters mixed;
+    mixed.tone_timbre = 1.5f;
+    mixed.tone_detune = 20.0f;
+    mixed.mix = 0.0f;
+
+    SoundParameters highpass = mixed;
+    highpass.percussion_filter = PercussionFilter::kHighpass;
+    highpass.percussion_resonance = 50.0f;
+
+    SoundParameters bandpass = mixed;
+    bandpass.percussion_filter = PercussionFilter::kBandpass;
+    bandpass.percussion_resonance = 100.0f;
+
+    SoundParameters fir_lowpass = mixed;
+    fir_lowpass.percussion_filter = PercussionFilter::kFirLowpass;
+
+    return {
+      {"default", SoundParameters{}},
+      {"tone", tone},
+      {"percussion", percussion},
+      {"mixed", mixed},
+      {"highpass", highpass},
+      {"bandpass", bandpass},
+      {"fir-lowpass", fir_lowpass}
+    };
+  }
+
+  void benchSynthesizer()
+  {
+    Synthesizer synth(kDefaultSpec);
+    ByteBuffer buffer(kDefaultSpec, kSoundDuration);
+
+    for (const auto& [name, params] : soundPresets())
+    {
+      measure("synthesizer/" + name, [&] () {
+        synth.update(buffer, params);
+        return buffer.frames();
+      });
+    }
+  }
+
+  void benchFilters()
+  {
+    const Wavetable sine_tbl = WavetableBuilder::build(kFilterSpec.rate, SineRecipe());
+    const Wavetable sawtooth_tbl = WavetableBuilder::build(kFilterSpec.rate, SawtoothRecipe());
+
+    ByteBuffer buffer(kFilterSpec, kSoundDuration);
+    ByteBuffer other(kFilterSpec, kSoundDuration);
+
+    const size_t frames = buffer.frames();
+
+    filter::std::Noise noise(0.5f);
+    noise.prepare(kFilterSpec);
+    noise.process(other);
+    measure("filter/noise", [&] () { noise.process(buffer); return frames; });
+
+    filter::std::Zero zero;
+    zero.prepare(kFilterSpec);
+    measure("filter/zero", [&] () { zero.process(buffer); return frames; });
+
+    filter::std::Lowpass lowpass(5000.0f);
+    lowpass.prepare(kFilterSpec);
+    measure("filter/lowpass", [&] () { lowpass.process(buffer); return frames; });
+
+    filter::std::Biquad biquad(filter::BiquadType::kLowpass, 5000.0f);
+    biquad.prepare(kFilterSpec);
+    measure("filter/biquad", [&] () { biquad.process(buffer); return frames; });
+
+    filter::std::Wave sine(&sine_tbl, filter::std::Wave::Parameters {1000.0f, 1.0f, 0.0f, 10.0f});
+    sine.prepare(kFilterSpec);
+    measure("filter/wave-sine", [&] () { sine.process(buffer); return frames; });
+
+    filter::std::Wave sawtooth(&sawtooth_tbl, filter::std::Wave::Parameters {1000.0f, 1.0f, 0.0f, 10.0f});
+    sawtooth.prepare(kFilterSpec);
+    measure("filter/wave-sawtooth", [&] () { sawtooth.process(buffer); return frames; });
+
+    filter::std::Gain gain(0.5f);
+    gain.prepare(kFilterSpec);
+    measure("filter/gain", [&] () { gain.process(buffer); return frames; });
+
+    filter::std::Gain envelope(filter::Automation {
+        {0ms, 0.0f}, {5ms, 1.0f}, {10ms, 1.0f}, {40ms, 0.0f} });
+    envelope.prepare(kFilterSpec);
+    measure("filter/gain-envelope", [&] () { envelope.process(buffer); return frames; });
+
+    filter::std::Normalize normalize;
+    normalize.prepare(kFilterSpec);
+    measure("filter/normalize", [&] () { normalize.process(buffer); return frames; });
+
+    filter::std::Mix mix(&other);
+    mix.prepare(kFilterSpec);
+    mix.setPan(0.3f);
+    measure("filter/mix", [&] () { mix.process(buffer); return frames; });
+  }
+
+  void benchResample()
+  {
+    using Fmt = SampleFormat;
+
+    const std::vector<std::pair<std::string, SampleFormat>> formats = {
+      {"u8", Fmt::kU8},
+      {"s8", Fmt::kS8},
+      {"s16le", Fmt::kS16LE},
+      {"s16be", Fmt::kS16BE},
+      {"u16le", Fmt::kU16LE},
+      {"u16be", Fmt::kU16BE},
+      {"s32le", Fmt::kS32LE},
+      {"s32be", Fmt::kS32BE},
+      {"float32le", Fmt::kFloat32LE},
+      {"float32be", Fmt::kFloat32BE}
+    };
+
+    ByteBuffer source(kFilterSpec, kSoundDuration);
+
+    filter::std::Noise noise(0.5f);
+    noise.process(source);
+
+    for (const auto& [name, format] : formats)
+    {
+      StreamSpec spec = {format, kFilterSpec.rate, kFilterSpec.channels};
+      ByteBuffer target(spec, kSoundDuration);
+
+      measure("resample/" + name, [&] () {
+        resample(source, target);
+        return source.frames();
+      });
+    }
+  }
+
+  void benchStreamController()
+  {
+    Synthesizer synth(kDefaultSpec);
+
+    auto makeController = [&] (LatencyProfile latency) {
+      auto ctrl = std::make_unique<BeatStreamController>(kDefaultSpec);
+      ctrl->prepare(kDefaultSpec, latency);
+
+      for (Accent accent : {kAccentWeak, kAccentMid, kAccentStrong})
+      {
+        ByteBuffer sound = synth.create(SoundParameters{});
+        ctrl->swapSound(accent, sound);
+      }
+
+      Meter meter = kMeterSimple4;
+      ctrl->swapMeter(meter);
+      ctrl->setTempo(120.0);
+      ctrl->start(kFillBufferGenerator);
+      return ctrl;
+    };
+
+    const std::vector<std::pair<std::string, LatencyProfile>> profiles = {
+      {"ultra-low", LatencyProfile::kUltraLow},
+      {"normal", LatencyProfile::kNormal},
+      {"power-save", LatencyProfile::kPowerSave}
+    };
+
+    const size_t frame_size = frameSize(kDefaultSpec);
+
+    for (const auto& [name, latency] : profiles)
+    {
+      // push mode: one chunk per call (see Ticker)
+      auto push_ctrl = makeController(latency);
+      measure("controller/cycle-" + name, [&] () {
+        const void* data;
+        size_t bytes;
+        push_ctrl->cycle(data, bytes);
+        return bytes / frame_size;
+      });
+
+      // pull mode: render one period per call, as a pull-mode backend would
+      auto pull_ctrl = makeController(latency);
+      ByteBuffer period(kDefaultSpec, latencyParameters(latency).period);
+      measure("controller/render-" + name, [&] () {
+        pull_ctrl->render(period.data(), period.frames());
+        return period.frames();
+      });
+    }
+  }
+
+}//unnamed namespace
+
+int main(int argc, char* argv[])
+{
+  if (argc > 1)
+    pattern = argv[1];
+
+  benchSynthesizer();
+  benchFilters();
+  benchResample();
+  benchStreamController();
+
+  return EXIT_SUCCESS;
+}
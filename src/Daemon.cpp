@@ -0,0 +1,784 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "Daemon.h"
+#include "Error.h"
+#include "ProfileIOLocalXml.h"
+
+#include <giomm/init.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef NDEBUG
+# include <iostream>
+#endif
+
+namespace {
+
+  using namespace std::chrono_literals;
+
+  // update interval of the info subscribers (see Application::onInfoTimer)
+  constexpr std::chrono::milliseconds kInfoInterval = 60ms;
+
+  // maximum length of a command line
+  constexpr size_t kMaxLineLength = 4096;
+
+  // info lines are dropped for clients that do not keep up
+  constexpr size_t kMaxInfoBacklog = 16 * 1024;
+
+  // clients that do not read their replies are disconnected
+  constexpr size_t kMaxOutputBacklog = 256 * 1024;
+
+  constexpr int kListenBacklog = 8;
+
+  class CommandError : public GMetronomeError {
+  public:
+    explicit CommandError(const std::string& what) : GMetronomeError(what)
+      { }
+  };
+
+  GMetronomeError systemError(const std::string& what)
+  {
+    return GMetronomeError(what + " (" + std::strerror(errno) + ")");
+  }
+
+  bool setDescriptorFlags(int fd)
+  {
+    int fl = fcntl(fd, F_GETFL);
+    int fd_fl = fcntl(fd, F_GETFD);
+
+    return fl != -1 && fd_fl != -1
+      && fcntl(fd, F_SETFL, fl | O_NONBLOCK) != -1
+      && fcntl(fd, F_SETFD, fd_fl | FD_CLOEXEC) != -1;
+  }
+
+  std::vector<std::string> splitArguments(const std::string& args)
+  {
+    std::vector<std::string> tokens;
+    std::istringstream stream(args);
+    for (std::string token; stream >> token; )
+      tokens.push_back(std::move(token));
+    return tokens;
+  }
+
+  void expectArguments(const std::vector<std::string>& args, size_t min, size_t max)
+  {
+    if (args.size() < min)
+      throw CommandError("missing argument");
+    if (args.size() > max)
+      throw CommandError("too many arguments");
+  }
+
+  double parseNumber(const std::string& arg, double min, double max)
+  {
+    const char* begin = arg.c_str();
+    char* end = nullptr;
+
+    errno = 0;
+    double value = std::strtod(begin, &end);
+
+    if (end == begin || *end != '\0' || errno != 0 || !std::isfinite(value))
+      throw CommandError("invalid number '" + arg + "'");
+
+    if (value < min || value > max)
+      throw CommandError("number out of range '" + arg + "'");
+
+    return value;
+  }
+
+  int parseInteger(const std::string& arg, int min, int max)
+  {
+    double value = parseNumber(arg, min, max);
+
+    if (value != std::trunc(value))
+      throw CommandError("invalid integer '" + arg + "'");
+
+    return static_cast<int>(value);
+  }
+
+  bool parseSwitch(const std::string& arg)
+  {
+    if (arg == "on")
+      return true;
+    else if (arg == "off")
+      return false;
+    else
+      throw CommandError("expected 'on' or 'off'");
+  }
+
+  // DIVISION BEATS [ACCENTS], e.g. "2 4 30202020"
+  Meter parseMeter(const std::vector<std::string>& args)
+  {
+    int division = parseInteger(args[0], 1, Meter::kMaxDivision);
+    int beats = parseInteger(args[1], 1, Meter::kMaxBeats);
+
+    // accentuate the beats like the predefined meters by default
+    AccentPattern pattern(division * beats, kAccentOff);
+    for (int beat = 0; beat < beats; ++beat)
+      pattern[beat * division] = (beat == 0 && beats > 1) ? kAccentStrong : kAccentMid;
+
+    if (args.size() > 2)
+    {
+      const std::string& accents = args[2];
+
+      if (accents.size() != pattern.size()
+          || accents.find_first_not_of("0123") != std::string::npos)
+        throw CommandError("invalid accent pattern '" + accents + "'");
+
+      for (size_t index = 0; index < accents.size(); ++index)
+        pattern[index] = static_cast<Accent>(accents[index] - '0');
+    }
+    return Meter(division, beats, pattern);
+  }
+
+  const Meter& profileMeter(const Profile::Content& content)
+  {
+    const std::string& slot = content.meter_select;
+
+    if (slot == "meter-simple-2")
+      return content.meter_simple_2;
+    else if (slot == "meter-simple-3")
+      return content.meter_simple_3;
+    else if (slot == "meter-simple-4")
+      return content.meter_simple_4;
+    else if (slot == "meter-compound-2")
+      return content.meter_compound_2;
+    else if (slot == "meter-compound-3")
+      return content.meter_compound_3;
+    else if (slot == "meter-compound-4")
+      return content.meter_compound_4;
+    else
+      return content.meter_custom;
+  }
+
+  const char* accelModeName(audio::Ticker::AccelMode mode)
+  {
+    switch (mode) {
+    case audio::Ticker::AccelMode::kContinuous: return "continuous";
+    case audio::Ticker::AccelMode::kStepwise: return "stepwise";
+    default: return "off";
+    };
+  }
+
+  // removes line breaks from user-defined strings (e.g. profile titles)
+  std::string singleLine(std::string text)
+  {
+    std::replace_if(text.begin(), text.end(),
+                    [] (char c) { return c == '\n' || c == '\r'; }, ' ');
+    return text;
+  }
+
+}//unnamed namespace
+
+Daemon::Daemon(const Options& options)
+  : options_{options}
+{
+  if (pipe(quit_pipe_) != 0)
+    throw systemError("failed to create pipe");
+
+  if (!setDescriptorFlags(quit_pipe_[0]) || !setDescriptorFlags(quit_pipe_[1]))
+  {
+    ::close(quit_pipe_[0]);
+    ::close(quit_pipe_[1]);
+    throw systemError("failed to set up pipe");
+  }
+
+  try {
+    initTicker();
+    openSocket();
+  }
+  catch (...) {
+    ::close(quit_pipe_[0]);
+    ::close(quit_pipe_[1]);
+    throw;
+  }
+}
+
+Daemon::~Daemon()
+{
+  // deliver the pending replies (e.g. to "shutdown") on a best-effort basis
+  for (auto& client : clients_)
+  {
+    writeClient(client);
+    closeClient(client);
+  }
+
+  closeSocket();
+
+  ::close(quit_pipe_[0]);
+  ::close(quit_pipe_[1]);
+
+  ticker_.reset();
+}
+
+std::string Daemon::defaultSocketPath()
+{
+  if (const char* dir = std::getenv("XDG_RUNTIME_DIR"); dir && *dir)
+    return std::string(dir) + "/gmetronomed.sock";
+
+  const char* tmp = std::getenv("TMPDIR");
+  if (!tmp || !*tmp)
+    tmp = "/tmp";
+
+  return std::string(tmp) + "/gmetronomed-" + std::to_string(getuid()) + ".sock";
+}
+
+void Daemon::initTicker()
+{
+  for (auto accent : {kAccentWeak, kAccentMid, kAccentStrong})
+    ticker_.setSound(accent, audio::defaultSoundParameters(accent));
+
+  ticker_.setVolume(100.0);
+  ticker_.setRealtime(options_.realtime);
+
+  if (auto backend = audio::createBackend(options_.backend); backend != nullptr)
+  {
+    auto device_config = audio::kDefaultConfig;
+    device_config.name = options_.device;
+    device_config.latency = options_.latency;
+
+    backend->configure(device_config);
+    ticker_.setBackend(std::move(backend));
+  }
+
+  ticker_.setStandby(options_.standby);
+}
+
+void Daemon::openSocket()
+{
+  const std::string& path = options_.socket_path;
+
+  sockaddr_un addr {};
+  addr.sun_family = AF_UNIX;
+
+  if (path.empty() || path.size() >= sizeof(addr.sun_path))
+    throw GMetronomeError("invalid socket path '" + path + "'");
+
+  std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+  listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd_ < 0)
+    throw systemError("failed to create socket");
+
+  try {
+    if (!setDescriptorFlags(listen_fd_))
+      throw systemError("failed to set up socket");
+
+    // a socket file without a listener is a leftover of a previous instance
+    if (connect(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0
+        || errno == EAGAIN || errno == EINPROGRESS)
+      throw GMetronomeError("another instance is listening on '" + path + "'");
+    else if (errno == ECONNREFUSED)
+      unlink(path.c_str());
+
+    // only the user may connect to the daemon
+    mode_t old_mask = umask(S_IRWXG | S_IRWXO);
+    int bind_result = bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    umask(old_mask);
+
+    if (bind_result != 0)
+      throw systemError("failed to bind socket '" + path + "'");
+
+    if (listen(listen_fd_, kListenBacklog) != 0)
+    {
+      unlink(path.c_str());
+      throw systemError("failed to listen on socket '" + path + "'");
+    }
+  }
+  catch (...) {
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    throw;
+  }
+}
+
+void Daemon::closeSocket()
+{
+  if (listen_fd_ >= 0)
+  {
+    ::close(listen_fd_);
+    unlink(options_.socket_path.c_str());
+    listen_fd_ = -1;
+  }
+}
+
+void Daemon::run()
+{
+  std::vector<pollfd> fds;
+
+  running_ = true;
+  while (running_)
+  {
+    fds.clear();
+    fds.push_back({quit_pipe_[0], POLLIN, 0});
+    fds.push_back({listen_fd_, POLLIN, 0});
+
+    for (const auto& client : clients_)
+    {
+      short events = client.output.empty() ? POLLIN : (POLLIN | POLLOUT);
+      fds.push_back({client.fd, events, 0});
+    }
+
+    // the status frames of the audio thread are polled while it is started
+    // and deferred commands are delivered while it is running (see Ticker::flush)
+    const auto state = ticker_.state();
+    const bool polling = state.test(audio::Ticker::StateFlag::kStarted)
+      || (state.test(audio::Ticker::StateFlag::kRunning) && ticker_.flush());
+    const int timeout = polling ? static_cast<int>(kInfoInterval.count()) : -1;
+
+    if (poll(fds.data(), fds.size(), timeout) < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      else
+        throw systemError("failed to poll");
+    }
+
+    if (fds[0].revents != 0)
+      break;
+
+    if (fds[1].revents & POLLIN)
+      acceptClient();
+
+    // new clients are appended to clients_ and polled in the next iteration
+    for (size_t index = 2; index < fds.size(); ++index)
+    {
+      Client& client = clients_[index - 2];
+
+      if (fds[index].revents & (POLLIN | POLLHUP | POLLERR))
+        readClient(client);
+
+      if (client.fd >= 0 && (fds[index].revents & POLLOUT))
+        writeClient(client);
+    }
+
+    ticker_.flush();
+    pollInfo();
+
+    clients_.erase(std::remove_if(clients_.begin(), clients_.end(),
+                                  [] (const auto& client) { return client.fd < 0; }),
+                   clients_.end());
+  }
+  running_ = false;
+}
+
+void Daemon::quit() noexcept
+{
+  const char byte = 0;
+  [[maybe_unused]] auto result = ::write(quit_pipe_[1], &byte, 1);
+}
+
+void Daemon::acceptClient()
+{
+  int fd = accept(listen_fd_, nullptr, nullptr);
+  if (fd < 0)
+    return;
+
+  if (!setDescriptorFlags(fd))
+  {
+    ::close(fd);
+    return;
+  }
+
+  clients_.push_back({fd});
+}
+
+void Daemon::readClient(Client& client)
+{
+  char buffer[4096];
+
+  ssize_t bytes = ::read(client.fd, buffer, sizeof(buffer));
+
+  if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+    return;
+
+  if (bytes <= 0)
+  {
+    closeClient(client);
+    return;
+  }
+
+  client.input.append(buffer, bytes);
+
+  std::string::size_type begin = 0;
+  for (auto end = client.input.find('\n');
+       end != std::string::npos && !client.closing;
+       end = client.input.find('\n', begin))
+  {
+    std::string line = client.input.substr(begin, end - begin);
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+
+    handleLine(client, line);
+    begin = end + 1;
+  }
+  client.input.erase(0, begin);
+
+  if (client.input.size() > kMaxLineLength)
+  {
+    client.output += "error line too long\n";
+    client.closing = true;
+  }
+
+  writeClient(client);
+}
+
+void Daemon::writeClient(Client& client)
+{
+  while (client.fd >= 0 && !client.output.empty())
+  {
+    ssize_t bytes = ::write(client.fd, client.output.data(), client.output.size());
+
+    if (bytes < 0)
+    {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        closeClient(client);
+      break;
+    }
+    client.output.erase(0, bytes);
+  }
+
+  if (client.fd >= 0
+      && ((client.closing && client.output.empty())
+          || client.output.size() > kMaxOutputBacklog))
+  {
+    closeClient(client);
+  }
+}
+
+void Daemon::closeClient(Client& client)
+{
+  if (client.fd >= 0)
+  {
+    ::close(client.fd);
+    client.fd = -1;
+  }
+}
+
+void Daemon::handleLine(Client& client, const std::string& line)
+{
+  auto begin = line.find_first_not_of(" \t");
+  if (begin == std::string::npos)
+    return; // empty line
+
+  auto end = line.find_first_of(" \t", begin);
+
+  std::string command = line.substr(begin, end - begin);
+  std::string args;
+
+  if (end != std::string::npos)
+  {
+    if (auto args_begin = line.find_first_not_of(" \t", end); args_begin != std::string::npos)
+      args = line.substr(args_begin);
+  }
+
+  try {
+    handleCommand(client, command, args);
+    client.output += "ok\n";
+  }
+  catch (const std::exception& e) {
+    client.output += "error " + singleLine(e.what()) + "\n";
+  }
+}
+
+void Daemon::handleCommand(Client& client, const std::string& command, const std::string& line)
+{
+  auto args = splitArguments(line);
+
+  if (command == "start")
+  {
+    expectArguments(args, 0, 0);
+    start();
+  }
+  else if (command == "stop")
+  {
+    expectArguments(args, 0, 0);
+    stop();
+  }
+  else if (command == "pause")
+  {
+    expectArguments(args, 0, 0);
+    if (!ticker_.state().test(audio::Ticker::StateFlag::kStarted))
+      throw CommandError("metronome not started");
+
+    ticker_.pause();
+    broadcast("state paused\n");
+  }
+  else if (command == "resume")
+  {
+    expectArguments(args, 0, 0);
+    if (!ticker_.state().test(audio::Ticker::StateFlag::kStarted))
+      throw CommandError("metronome not started");
+
+    ticker_.resume();
+    broadcast("state started\n");
+  }
+  else if (command == "tempo")
+  {
+    expectArguments(args, 1, 1);
+    ticker_.setTempo(parseNumber(args[0], Profile::kMinTempo, Profile::kMaxTempo));
+  }
+  else if (command == "count-in")
+  {
+    expectArguments(args, 1, 1);
+    ticker_.setCountIn(parseInteger(args[0], Profile::kMinCountIn, Profile::kMaxCountIn));
+  }
+  else if (command == "meter")
+  {
+    if (args.size() == 1 && args[0] == "off")
+      ticker_.resetMeter();
+    else
+    {
+      expectArguments(args, 2, 3);
+      ticker_.setMeter(parseMeter(args));
+    }
+  }
+  else if (command == "accel")
+  {
+    expectArguments(args, 1, 4);
+
+    if (args[0] == "off")
+    {
+      expectArguments(args, 1, 1);
+      ticker_.stopAcceleration();
+    }
+    else if (args[0] == "continuous")
+    {
+      expectArguments(args, 3, 3);
+      double accel = parseNumber(args[1], Profile::kMinTrainerAccel, Profile::kMaxTrainerAccel);
+      double target = parseNumber(args[2], Profile::kMinTrainerTarget, Profile::kMaxTrainerTarget);
+      ticker_.accelerate(accel, target);
+    }
+    else if (args[0] == "stepwise")
+    {
+      expectArguments(args, 4, 4);
+      int hold = parseInteger(args[1], Profile::kMinTrainerHold, Profile::kMaxTrainerHold);
+      double step = parseNumber(args[2], Profile::kMinTrainerStep, Profile::kMaxTrainerStep);
+      double target = parseNumber(args[3], Profile::kMinTrainerTarget, Profile::kMaxTrainerTarget);
+      ticker_.accelerate(hold, step, target);
+    }
+    else throw CommandError("unknown acceleration mode '" + args[0] + "'");
+  }
+  else if (command == "sync")
+  {
+    expectArguments(args, 2, 3);
+
+    double beats = parseNumber(args[0], -1e9, 1e9);
+    double tempo = parseNumber(args[1], Profile::kMinTempo, Profile::kMaxTempo);
+    auto time = audio::Ticker::kDefaultSyncTime;
+
+    if (args.size() > 2)
+      time = std::chrono::duration_cast<audio::microseconds>(
+        std::chrono::duration<double, std::milli>(parseNumber(args[2], 0.0, 60000.0)));
+
+    ticker_.synchronize(beats, tempo, time);
+  }
+  else if (command == "volume")
+  {
+    expectArguments(args, 1, 1);
+    ticker_.setVolume(parseNumber(args[0], 0.0, 125.0));
+  }
+  else if (command == "profiles")
+  {
+    expectArguments(args, 0, 0);
+
+    Gio::init();
+    ProfileIOLocalXml profile_io;
+
+    for (const auto& primer : profile_io.list())
+      client.output += "profile " + singleLine(primer.id) + " "
+        + singleLine(primer.header.title) + "\n";
+  }
+  else if (command == "profile")
+  {
+    if (line.empty())
+      throw CommandError("missing argument");
+
+    // the profiles are reloaded, since the application might have changed them
+    Gio::init();
+    ProfileIOLocalXml profile_io;
+
+    applyProfile(profile_io.load(line).content);
+  }
+  else if (command == "info")
+  {
+    expectArguments(args, 1, 1);
+    client.info = parseSwitch(args[0]);
+  }
+  else if (command == "status")
+  {
+    expectArguments(args, 0, 0);
+
+    auto state = ticker_.state();
+    auto stats = ticker_.stats();
+
+    const char* state_name = state.test(audio::Ticker::StateFlag::kError) ? "error"
+      : state.test(audio::Ticker::StateFlag::kPaused) ? "paused"
+      : state.test(audio::Ticker::StateFlag::kStarted) ? "started" : "stopped";
+
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer),
+                  "status %s cycles=%" PRIu64 " xruns=%" PRIu64 " realtime=%s"
+                  " first-click=%lld\n",
+                  state_name, stats.cycles, stats.xruns,
+                  ticker_.realtimeStatus().policy != audio::RealtimePolicy::kNone ? "yes" : "no",
+                  static_cast<long long>(
+                    std::chrono::duration_cast<audio::microseconds>(stats.first_click.last).count()));
+
+    client.output += buffer;
+  }
+  else if (command == "quit")
+  {
+    expectArguments(args, 0, 0);
+    client.closing = true;
+  }
+  else if (command == "shutdown")
+  {
+    expectArguments(args, 0, 0);
+    running_ = false;
+  }
+  else throw CommandError("unknown command '" + command + "'");
+}
+
+void Daemon::start()
+{
+  try {
+    ticker_.start();
+  }
+  catch (...) {
+    ticker_.reset();
+    throw;
+  }
+  broadcast("state started\n");
+}
+
+void Daemon::stop()
+{
+  try {
+    ticker_.stop();
+  }
+  catch (...) {
+    ticker_.reset();
+    broadcast("state stopped\n");
+    throw;
+  }
+  broadcast("state stopped\n");
+}
+
+void Daemon::applyProfile(const Profile::Content& content)
+{
+  ticker_.setTempo(content.tempo);
+  ticker_.setCountIn(content.count_in);
+
+  if (content.meter_enabled)
+    ticker_.setMeter(profileMeter(content));
+  else
+    ticker_.resetMeter();
+
+  if (!content.trainer_enabled)
+    ticker_.stopAcceleration();
+  else if (content.trainer_mode == Profile::TrainerMode::kContinuous)
+    ticker_.accelerate(content.trainer_accel, content.trainer_target);
+  else
+    ticker_.accelerate(content.trainer_hold, content.trainer_step, content.trainer_target);
+}
+
+void Daemon::pollInfo()
+{
+  auto state = ticker_.state();
+
+  if (state.test(audio::Ticker::StateFlag::kError))
+  {
+    std::string what = "unknown error";
+    try {
+      ticker_.stop(); // rethrows the error of the audio thread
+    }
+    catch (const std::exception& e) {
+      what = e.what();
+    }
+    catch (...) {}
+
+    ticker_.reset();
+
+#ifndef NDEBUG
+    std::cerr << "Daemon: audio error (" << what << ")" << std::endl;
+#endif
+    broadcast("state error " + singleLine(what) + "\n");
+  }
+  else if (state.test(audio::Ticker::StateFlag::kStarted) && ticker_.hasInfo())
+  {
+    broadcastInfo(ticker_.getInfo(true));
+  }
+}
+
+void Daemon::broadcastInfo(const audio::Ticker::Info& info)
+{
+  char buffer[512];
+  std::snprintf(buffer, sizeof(buffer),
+                "info seq=%" PRIu64 " time=%lld position=%.4f tempo=%.3f"
+                " accel=%s acceleration=%.3f target=%.3f hold=%d count-in=%d"
+                " beats=%d division=%d accent=%d next=%lld latency=%lld\n",
+                info.sequence,
+                static_cast<long long>(info.timestamp.count()),
+                info.position,
+                info.tempo,
+                accelModeName(info.mode),
+                info.acceleration,
+                info.target,
+                info.hold,
+                info.count_in,
+                info.beats,
+                info.division,
+                info.accent,
+                static_cast<long long>(info.next_accent_delay.count()),
+                static_cast<long long>(info.backend_latency.count()));
+
+  broadcast(buffer);
+}
+
+void Daemon::broadcast(const std::string& line)
+{
+  for (auto& client : clients_)
+  {
+    if (client.fd < 0 || !client.info || client.output.size() > kMaxInfoBacklog)
+      continue;
+
+    client.output += line;
+    writeClient(client);
+  }
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef GMetronome_Daemon_h
+#define GMetronome_Daemon_h
+
+#include "Ticker.h"
+#include "AudioBackend.h"
+#include "Profile.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @class Daemon
+ * @brief A headless metronome that is controlled over a Unix domain socket
+ *
+ * The daemon accepts text commands (one per line) from any number of local
+ * clients and answers each command with a line "ok" or "error <message>",
+ * optionally preceded by data lines (e.g. "profile <id> <title>"). Clients
+ * that subscribed with "info on" additionally receive the status frames of
+ * the audio thread (see Ticker::Info) as "info <key>=<value>..." lines while
+ * the metronome is running, as well as "state started|stopped|error" lines.
+ * Run "gmetronomed --help" for the command set.
+ *
+ * The daemon is single-threaded: run() multiplexes the connections with
+ * poll(2) and forwards the commands to the Ticker, so it needs neither GTK
+ * nor a Glib main loop.
+ */
+class Daemon {
+public:
+  struct Options
+  {
+    std::string               socket_path;
+    audio::BackendIdentifier  backend {audio::BackendIdentifier::kNone};
+    std::string               device;
+    audio::LatencyProfile     latency {audio::kDefaultLatencyProfile};
+    bool                      realtime {false};
+    bool                      standby {false};
+  };
+
+  explicit Daemon(const Options& options);
+  ~Daemon();
+
+  Daemon(const Daemon&) = delete;
+  Daemon& operator=(const Daemon&) = delete;
+
+  /**
+   * @brief Serve the clients until quit() is called or a client sends
+   * the "shutdown" command
+   */
+  void run();
+
+  /**
+   * @brief Terminate run()
+   *
+   * This function is async-signal-safe, i.e. it can be called from a
+   * signal handler.
+   */
+  void quit() noexcept;
+
+  /**
+   * @brief The default socket path
+   *
+   * The socket is placed in $XDG_RUNTIME_DIR or in the temporary directory
+   * of the system (with the user id in the name).
+   */
+  static std::string defaultSocketPath();
+
+private:
+  struct Client
+  {
+    int          fd {-1};
+    std::string  input;
+    std::string  output;
+    bool         info {false};
+    bool         closing {false};
+  };
+
+  Options options_;
+  audio::Ticker ticker_;
+  int listen_fd_{-1};
+  int quit_pipe_[2]{-1, -1};
+  bool running_{false};
+  std::vector<Client> clients_;
+
+  void initTicker();
+  void openSocket();
+  void closeSocket();
+
+  void acceptClient();
+  void readClient(Client& client);
+  void writeClient(Client& client);
+  void closeClient(Client& client);
+
+  void handleLine(Client& client, const std::string& line);
+  void handleCommand(Client& client, const std::string& command, const std::string& args);
+
+  void start();
+  void stop();
+  void applyProfile(const Profile::Content& content);
+
+  void pollInfo();
+  void broadcastInfo(const audio::Ticker::Info& info);
+  void broadcast(const std::string& line);
+};
+
+#endif//GMetronome_Daemon_h
@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Headless metronome daemon
+ *
+ * Usage: gmetronomed [OPTION]...
+ *
+ * Runs the audio engine without GTK and serves the clients of a Unix domain
+ * socket (see Daemon), e.g.
+ *
+ *   $ printf 'tempo 96\nstart\n' | nc -U -q1 $XDG_RUNTIME_DIR/gmetronomed.sock
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "Daemon.h"
+
+#include <getopt.h>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+  Daemon* daemon_instance = nullptr;
+
+  void onSignal(int)
+  {
+    if (daemon_instance)
+      daemon_instance->quit();
+  }
+
+  class UsageError : public std::runtime_error {
+  public:
+    explicit UsageError(const std::string& what) : std::runtime_error(what)
+      { }
+  };
+
+  void printUsage(std::FILE* out)
+  {
+    std::fputs(
+      "Usage: gmetronomed [OPTION]...\n"
+      "Run the metronome without user interface, controlled by a Unix domain socket.\n"
+      "\n"
+      "  -s, --socket=PATH      socket path (default: $XDG_RUNTIME_DIR/gmetronomed.sock)\n"
+      "  -b, --backend=NAME     audio backend: none"
+#if HAVE_ALSA
+      ", alsa"
+#endif
+#if HAVE_OSS
+      ", oss"
+#endif
+#if HAVE_PULSEAUDIO
+      ", pulseaudio"
+#endif
+#if HAVE_JACK
+      ", jack"
+#endif
+      "\n"
+      "  -d, --device=NAME      audio device (default: default device)\n"
+      "  -l, --latency=PROFILE  ultra-low, normal, power-save (default: normal)\n"
+      "  -r, --realtime         use real-time scheduling for the audio thread\n"
+      "  -S, --standby          keep the audio device open while stopped\n"
+      "  -h, --help             display this help and exit\n"
+      "\n"
+      "Commands (one per line, answered by 'ok' or 'error <message>'):\n"
+      "  start | stop\n"
+      "  pause | resume         keep the beat phase while silent\n"
+      "  tempo BPM\n"
+      "  count-in BEATS\n"
+      "  meter DIVISION BEATS [ACCENTS] | meter off\n"
+      "      ACCENTS: one digit per (sub)beat, 0 (off) to 3 (strong)\n"
+      "  accel continuous BPM_PER_MINUTE TARGET\n"
+      "  accel stepwise HOLD STEP TARGET | accel off\n"
+      "  sync BEATS TEMPO [MILLISECONDS]\n"
+      "  volume PERCENT\n"
+      "  profiles               list the profiles of the application\n"
+      "  profile ID             load a profile\n"
+      "  info on|off            subscribe to the status of the audio thread\n"
+      "  status\n"
+      "  quit                   close the connection\n"
+      "  shutdown               terminate the daemon\n",
+      out);
+  }
+
+  // the first backend that works without further configuration
+  audio::BackendIdentifier defaultBackend()
+  {
+#if HAVE_ALSA
+    return audio::BackendIdentifier::kALSA;
+#elif HAVE_PULSEAUDIO
+    return audio::BackendIdentifier::kPulseAudio;
+#elif HAVE_OSS
+    return audio::BackendIdentifier::kOSS;
+#else
+    return audio::BackendIdentifier::kNone;
+#endif
+  }
+
+  audio::BackendIdentifier parseBackend(const std::string& arg)
+  {
+    if (arg == "none")
+      return audio::BackendIdentifier::kNone;
+#if HAVE_ALSA
+    else if (arg == "alsa")
+      return audio::BackendIdentifier::kALSA;
+#endif
+#if HAVE_OSS
+    else if (arg == "oss")
+      return audio::BackendIdentifier::kOSS;
+#endif
+#if HAVE_PULSEAUDIO
+    else if (arg == "pulseaudio")
+      return audio::BackendIdentifier::kPulseAudio;
+#endif
+#if HAVE_JACK
+    else if (arg == "jack")
+      return audio::BackendIdentifier::kJACK;
+#endif
+    else
+      throw UsageError("unsupported audio backend: '" + arg + "'");
+  }
+
+  audio::LatencyProfile parseLatency(const std::string& arg)
+  {
+    if (arg == "ultra-low")
+      return audio::LatencyProfile::kUltraLow;
+    else if (arg == "normal")
+      return audio::LatencyProfile::kNormal;
+    else if (arg == "power-save")
+      return audio::LatencyProfile::kPowerSave;
+    else
+      throw UsageError("invalid latency profile: '" + arg + "'");
+  }
+
+  Daemon::Options parseOptions(int argc, char* argv[])
+  {
+    const struct option long_options[] = {
+      {"socket",   required_argument, nullptr, 's'},
+      {"backend",  required_argument, nullptr, 'b'},
+      {"device",   required_argument, nullptr, 'd'},
+      {"latency",  required_argument, nullptr, 'l'},
+      {"realtime", no_argument,       nullptr, 'r'},
+      {"standby",  no_argument,       nullptr, 'S'},
+      {"help",     no_argument,       nullptr, 'h'},
+      {nullptr, 0, nullptr, 0}
+    };
+
+    Daemon::Options opts;
+    opts.socket_path = Daemon::defaultSocketPath();
+    opts.backend = defaultBackend();
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "s:b:d:l:rSh", long_options, nullptr)) != -1)
+    {
+      switch (opt) {
+      case 's': opts.socket_path = optarg; break;
+      case 'b': opts.backend = parseBackend(optarg); break;
+      case 'd': opts.device = optarg; break;
+      case 'l': opts.latency = parseLatency(optarg); break;
+      case 'r': opts.realtime = true; break;
+      case 'S': opts.standby = true; break;
+      case 'h': printUsage(stdout); std::exit(EXIT_SUCCESS); break;
+      default:
+        throw UsageError("");
+      };
+    }
+
+    if (optind < argc)
+      throw UsageError("too many arguments");
+
+    return opts;
+  }
+
+}//unnamed namespace
+
+int main(int argc, char* argv[])
+{
+  try {
+    Daemon daemon(parseOptions(argc, argv));
+
+    daemon_instance = &daemon;
+
+    struct sigaction action {};
+    action.sa_handler = onSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    // disconnected clients are detected by write errors
+    std::signal(SIGPIPE, SIG_IGN);
+
+    try {
+      daemon.run();
+    }
+    catch (...) {
+      daemon_instance = nullptr;
+      throw;
+    }
+    daemon_instance = nullptr;
+  }
+  catch (const UsageError& e) {
+    if (*e.what() != '\0')
+      std::fprintf(stderr, "gmetronomed: %s\n", e.what());
+    std::fputs("Try 'gmetronomed --help' for more information.\n", stderr);
+    return EXIT_FAILURE;
+  }
+  catch (const std::exception& e) {
+    std::fprintf(stderr, "gmetronomed: %s\n", e.what());
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "DeviceScanner.h"
+
+#ifndef NDEBUG
+# include <iostream>
+#endif
+
+namespace audio {
+
+  namespace {
+
+    // maximum time to wait for device changes before checking for new requests
+    constexpr microseconds kMonitorTimeout = 250ms;
+
+  }//unnamed namespace
+
+  DeviceScanner::DeviceScanner()
+  {
+    worker_ = std::thread(&DeviceScanner::workerFunction, this);
+  }
+
+  DeviceScanner::~DeviceScanner()
+  {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      quit_ = true;
+    }
+    cond_var_.notify_one();
+
+    if (worker_.joinable())
+      worker_.join();
+  }
+
+  void DeviceScanner::scan(BackendIdentifier id)
+  {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+
+      in_id_ = id;
+      ++in_request_;
+
+      devices_.clear();
+      ++sequence_;
+
+      active_.store(true, std::memory_order_release);
+    }
+    cond_var_.notify_one();
+  }
+
+  bool DeviceScanner::update(std::vector<DeviceInfo>& devices)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    if (sequence_ == out_sequence_)
+      return false;
+
+    devices = devices_;
+    out_sequence_ = sequence_;
+
+    return true;
+  }
+
+  bool DeviceScanner::isCancelled()
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return quit_ || in_request_ != request_;
+  }
+
+  void DeviceScanner::workerFunction()
+  {
+    std::unique_lock<std::mutex> lck(mutex_);
+
+    while (true)
+    {
+      cond_var_.wait(lck, [&] { return quit_ || in_request_ != request_; });
+
+      if (quit_)
+        break;
+
+      request_ = in_request_;
+      BackendIdentifier id = in_id_;
+
+      lck.unlock();
+
+      try {
+        if (auto backend = createBackend(id); backend != nullptr)
+        {
+          // publish the devices as soon as they are probed
+          backend->scanDevices([&] (const DeviceInfo& device) {
+            std::lock_guard<std::mutex> guard(mutex_);
+
+            if (quit_ || in_request_ != request_)
+              return false;
+
+            devices_.push_back(device);
+            ++sequence_;
+            return true;
+          });
+
+          if (backend->hasDeviceMonitor())
+          {
+            while (!isCancelled())
+            {
+              if (!backend->waitDeviceChange(kMonitorTimeout))
+                continue;
+
+              // publish the new list at once (unchanged devices are cached)
+              auto devices = backend->devices();
+
+              std::lock_guard<std::mutex> guard(mutex_);
+
+              if (quit_ || in_request_ != request_)
+                break;
+
+              devices_ = std::move(devices);
+              ++sequence_;
+            }
+          }
+        }
+      }
+      catch(...)
+      {
+#ifndef NDEBUG
+        std::cerr << "DeviceScanner: failed to scan devices" << std::endl;
+#endif
+      }
+
+      lck.lock();
+
+      if (in_request_ == request_)
+        active_.store(false, std::memory_order_release);
+    }
+  }
+
+}//namespace audio
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef GMetronome_DeviceScanner_h
+#define GMetronome_DeviceScanner_h
+
+#include "AudioBackend.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace audio {
+
+  /**
+   * @class DeviceScanner
+   * @brief Enumerates the devices of an audio backend on a background thread
+   *
+   * The worker thread probes the devices of a separate backend instance and
+   * publishes them one by one (see Backend::scanDevices), so that clients
+   * can show the first devices while the others are still being probed.
+   * If the backend provides a device monitor, the worker keeps listening for
+   * device changes (e.g. hotplug events) after the scan and publishes a new
+   * device list whenever the devices changed.
+   *
+   * The results are polled with update(), e.g. from a timer of the UI.
+   */
+  class DeviceScanner {
+  public:
+    DeviceScanner();
+    ~DeviceScanner();
+
+    DeviceScanner(const DeviceScanner&) = delete;
+    DeviceScanner& operator=(const DeviceScanner&) = delete;
+
+    /**
+     * @brief Start to enumerate the devices of a backend
+     * A scan that is in progress is aborted and the device list is cleared.
+     */
+    void scan(BackendIdentifier id);
+
+    /**
+     * @brief Get the current device list
+     * @param devices  Receives the device list if it changed since the last call
+     * @return Whether the device list changed
+     */
+    bool update(std::vector<DeviceInfo>& devices);
+
+    /**
+     * @brief Whether the device list might still change
+     * This is the case while a scan is in progress or the devices are monitored.
+     */
+    bool active() const
+      { return active_.load(std::memory_order_acquire); }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cond_var_;
+    BackendIdentifier in_id_{BackendIdentifier::kNone};
+    std::uint64_t in_request_{0};
+    std::uint64_t request_{0};
+    bool quit_{false};
+
+    std::vector<DeviceInfo> devices_;
+    std::uint64_t sequence_{0};
+    std::uint64_t out_sequence_{0};
+    std::atomic<bool> active_{false};
+
+    std::thread worker_;
+
+    void workerFunction();
+    bool isCancelled();
+  };
+
+}//namespace audio
+#endif//GMetronome_DeviceScanner_h
@@ -18,3 +18,62 @@
  */
 
 #include "Filter.h"
+
+namespace audio {
+namespace filter {
+
+  namespace {
+
+    // number of output samples that are accumulated in registers
+    constexpr size_t kConvolveBlock = 8;
+
+  }//unnamed namespace
+
+// Let the dynamic loader pick a kernel for the instruction set of the CPU
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+# define GMETRONOME_CONVOLVE_TARGETS __attribute__((target_clones("avx2","default")))
+#else
+# define GMETRONOME_CONVOLVE_TARGETS
+#endif
+
+  // Note: std:: refers to filter::std inside this namespace
+  GMETRONOME_CONVOLVE_TARGETS
+  void convolve(const float* kernel, size_t taps,
+                const float* in, float* out, size_t count)
+  {
+    const float* origin = in + taps - 1;
+
+    // Process blocks of output samples and keep the partial sums in a
+    // fixed size array, that the compiler maps to vector registers.
+    // The taps are summed up in the same order as in the generic FIR
+    // implementation.
+    size_t i = 0;
+    for (; i + kConvolveBlock <= count; i += kConvolveBlock)
+    {
+      float acc[kConvolveBlock] = {};
+
+      for (size_t j = 0; j < taps; ++j)
+      {
+        const float k = kernel[j];
+        const float* src = origin + i - j;
+
+        for (size_t n = 0; n < kConvolveBlock; ++n)
+          acc[n] += k * src[n];
+      }
+
+      for (size_t n = 0; n < kConvolveBlock; ++n)
+        out[i + n] = acc[n];
+    }
+
+    for (; i < count; ++i)
+    {
+      float sum = 0.0f;
+      for (size_t j = 0; j < taps; ++j)
+        sum += kernel[j] * origin[i - j];
+
+      out[i] = sum;
+    }
+  }
+
+}//namespace filter
+}//namespace audio
@@ -32,6 +32,7 @@
 #include <initializer_list>
 #include <cmath>
 #include <type_traits>
+#include <cstring>
 
 #ifndef NDEBUG
 # include <iostream>
@@ -266,20 +267,45 @@ namespace filter {
     void prepend(std::initializer_list<Point> list)
       { insert(begin(), std::move(list)); }
 
+    /** Removes all points but keeps the allocated memory. */
+    void clear()
+      { points_.clear(); }
+
+    /** Allocates memory for the given number of points. */
+    void reserve(size_t points)
+      { points_.reserve(points); }
+
   private:
     PointContainer points_;
 
+    // Stable insertion sort, since std::stable_sort allocates a temporary
+    // buffer. The points are few and usually inserted in order.
     void sort() {
-      std::stable_sort(points_.begin(), points_.end(),
-                       [] (const auto&  lhs, const auto& rhs) {
-                         return lhs.time < rhs.time;
-                       });
+      auto less = [] (const auto&  lhs, const auto& rhs) {
+                    return lhs.time < rhs.time;
+                  };
+      for (auto it = points_.begin(); it != points_.end(); ++it)
+        std::rotate(std::upper_bound(points_.begin(), it, *it, less), it, std::next(it));
     }
   };
 
+  /**
+   * @brief Convolution of contiguous float samples with a filter kernel
+   *
+   * Computes out[i] = sum(kernel[j] * in[taps - 1 + i - j]) for count
+   * output samples, i.e. the input is expected to be preceded by taps - 1
+   * samples (e.g. zeros). The input and output ranges must not overlap.
+   */
+  void convolve(const float* kernel, std::size_t taps,
+                const float* in, float* out, std::size_t count);
+
   /**
    * @class FIR
    * @brief Compute the convolution of an audio buffer and a filter kernel
+   *
+   * Buffers in the native float format are deinterleaved and convolved
+   * with a vectorizable kernel (see convolve), other formats are processed
+   * with the generic sample views.
    */
   template<SampleFormat Format = kDefaultSampleFormat>
   class FIR {
@@ -300,6 +326,57 @@ namespace filter {
       }
 
     void process(ByteBuffer& buffer)
+      {
+        if (isContiguous(buffer))
+          processContiguous(buffer);
+        else
+          processGeneric(buffer);
+      }
+
+  private:
+    std::vector<float> kernel_;
+    std::vector<float> in_;
+    std::vector<float> out_;
+
+    static constexpr bool isNative()
+      { return !SampleView<Format, ByteBuffer::pointer>::hasSwapEndian(); }
+
+    bool isContiguous(const ByteBuffer& buffer) const
+      {
+        if constexpr (isNative() && sizeof(float) == sampleSize(Format))
+          return buffer.format() == Format && !kernel_.empty();
+        else
+          return false;
+      }
+
+    void processContiguous(ByteBuffer& buffer)
+      {
+        const std::size_t taps = kernel_.size();
+        const std::size_t frames = buffer.frames();
+        const std::size_t channels = buffer.channels();
+        const std::size_t frame_size = frameSize(buffer.spec());
+
+        in_.resize(taps - 1 + frames);
+        out_.resize(frames);
+
+        // the first taps - 1 samples are zero (see convolve)
+        std::fill_n(in_.begin(), taps - 1, 0.0f);
+
+        for (std::size_t c = 0; c < channels; ++c)
+        {
+          Byte* data = buffer.data() + c * sizeof(float);
+
+          for (std::size_t f = 0; f < frames; ++f)
+            std::memcpy(&in_[taps - 1 + f], data + f * frame_size, sizeof(float));
+
+          convolve(kernel_.data(), taps, in_.data(), out_.data(), frames);
+
+          for (std::size_t f = 0; f < frames; ++f)
+            std::memcpy(data + f * frame_size, &out_[f], sizeof(float));
+        }
+      }
+
+    void processGeneric(ByteBuffer& buffer)
       {
         auto channels = viewChannels<Format>(buffer);
         for (auto& channel : channels)
@@ -318,8 +395,6 @@ namespace filter {
           }
         }
       }
-  private:
-    std::vector<float> kernel_;
   };
 
   /**
@@ -405,6 +480,161 @@ namespace filter {
       }
   };
 
+  /** Response types of the Biquad filter */
+  enum class BiquadType
+  {
+    kLowpass,
+    kHighpass,
+    kBandpass
+  };
+
+  /**
+   * @class Biquad
+   * @brief Second order IIR filter (lowpass, highpass or bandpass)
+   *
+   * The coefficients are computed according to the well-known "Audio EQ
+   * Cookbook" by R. Bristow-Johnson. The cost per sample is constant, i.e.
+   * independent of the steepness and the resonance of the filter. Every
+   * buffer is processed with a cleared filter state.
+   */
+  template<SampleFormat Format = kDefaultSampleFormat>
+  class Biquad {
+    static_assert(isFloatingPoint(Format),
+      "this filter only supports floating point types");
+
+  public:
+    /** Quality factor of a Butterworth filter (no resonance peak) */
+    static constexpr float kButterworthQ = 0.70710678f;
+
+    explicit Biquad(BiquadType type = BiquadType::kLowpass,
+                    float cutoff = 100.0f, float q = kButterworthQ)
+      : type_{type}, cutoff_{cutoff}, q_{q}
+      { /* nothing */ }
+
+    void setType(BiquadType type)
+      {
+        if (type_ != type)
+        {
+          type_ = type;
+          need_rebuild_coefficients_ = true;
+        }
+      }
+    void setCutoff(float cutoff)
+      {
+        if (cutoff_ != cutoff)
+        {
+          cutoff_ = cutoff;
+          need_rebuild_coefficients_ = true;
+        }
+      }
+    /** Set the quality factor (resonance) of the filter */
+    void setResonance(float q)
+      {
+        if (q_ != q)
+        {
+          q_ = q;
+          need_rebuild_coefficients_ = true;
+        }
+      }
+    void prepare(const StreamSpec& spec)
+      {
+        assert( isFloatingPoint(spec.format) );
+        assert( spec.channels == 2 );
+
+        if (rate_ != spec.rate)
+        {
+          rate_ = spec.rate;
+          need_rebuild_coefficients_ = true;
+        }
+      }
+    void process(ByteBuffer& buffer)
+      {
+        assert(buffer.channels() == 2);
+
+        if (need_rebuild_coefficients_)
+          rebuildCoefficients();
+
+        // The channels are filtered in the same loop to interleave the
+        // independent recursions of the channels.
+        std::array<float, 2> z1 = {0.0f, 0.0f};
+        std::array<float, 2> z2 = {0.0f, 0.0f};
+
+        auto frames = viewFrames<Format>(buffer);
+        for (auto& frame : frames)
+        {
+          // transposed direct form II
+          for (std::size_t c = 0; c < 2; ++c)
+          {
+            float x = frame[c];
+            float y = b0_ * x + z1[c];
+            z1[c] = b1_ * x - a1_ * y + z2[c];
+            z2[c] = b2_ * x - a2_ * y;
+            frame[c] = y;
+          }
+        }
+      }
+
+  private:
+    BiquadType type_;
+    float cutoff_;
+    float q_;
+    float rate_{44100.0};
+    bool need_rebuild_coefficients_{true};
+
+    float b0_{1.0f};
+    float b1_{0.0f};
+    float b2_{0.0f};
+    float a1_{0.0f};
+    float a2_{0.0f};
+
+    void rebuildCoefficients()
+      {
+        // keep the cutoff frequency below the nyquist frequency
+        double fc = std::clamp(cutoff_ / rate_, 0.0001f, 0.49f);
+        double q = std::max(q_, 0.1f);
+
+        double w0 = 2.0 * M_PI * fc;
+        double cos_w0 = std::cos(w0);
+        double alpha = std::sin(w0) / (2.0 * q);
+
+        double b0, b1, b2;
+        switch (type_)
+        {
+        case BiquadType::kHighpass:
+          b0 = (1.0 + cos_w0) / 2.0;
+          b1 = -(1.0 + cos_w0);
+          b2 = (1.0 + cos_w0) / 2.0;
+          break;
+        case BiquadType::kBandpass:
+          // constant 0 dB peak gain
+          b0 = alpha;
+          b1 = 0.0;
+          b2 = -alpha;
+          break;
+        case BiquadType::kLowpass:
+          [[fallthrough]];
+        default:
+          b0 = (1.0 - cos_w0) / 2.0;
+          b1 = 1.0 - cos_w0;
+          b2 = (1.0 - cos_w0) / 2.0;
+          break;
+        };
+
+        double a0 = 1.0 + alpha;
+        double a1 = -2.0 * cos_w0;
+        double a2 = 1.0 - alpha;
+
+        // normalize coefficients
+        b0_ = b0 / a0;
+        b1_ = b1 / a0;
+        b2_ = b2 / a0;
+        a1_ = a1 / a0;
+        a2_ = a2 / a0;
+
+        need_rebuild_coefficients_ = false;
+      }
+  };
+
   /**
    * @class Zero
    *
@@ -449,11 +679,18 @@ namespace filter {
         amp_r_{0.0f}
       { /* nothing */ }
 
-    void setEnvelope(Automation envelope)
+    /**
+     * Copies the envelope into the memory of the current one, i.e. the
+     * function does not allocate if the envelope fits (see reserve).
+     */
+    void setEnvelope(const Automation& envelope)
       {
-        envelope_ = std::move(envelope);
+        envelope_ = envelope;
         mode_ = Mode::kAutomation;
       }
+    /** Allocates memory for an envelope with the given number of points. */
+    void reserve(size_t points)
+      { envelope_.reserve(points); }
     void setAmplitude(float amp_l, float amp_r)
       {
         amp_l_ = amp_l;
@@ -709,7 +946,7 @@ namespace filter {
 
         auto frames = viewFrames<Format>(buffer);
         float max = 0.0f;
-        for (const auto& frame : frames)
+        for (auto&& frame : frames)
           max = std::max(max, std::max(std::abs(frame[0]), std::abs(frame[1])));
 
         if (max != 0.0f)
@@ -812,6 +1049,7 @@ namespace filter {
     // some shortcuts for default filters
     using FIR       = Filter<FIR<kDefaultSampleFormat>>;
     using Lowpass   = Filter<Lowpass<kDefaultSampleFormat>>;
+    using Biquad    = Filter<Biquad<kDefaultSampleFormat>>;
     using Zero      = Filter<Zero<kDefaultSampleFormat>>;
     using Gain      = Filter<Gain<kDefaultSampleFormat>>;
     using Noise     = Filter<Noise<kDefaultSampleFormat>>;
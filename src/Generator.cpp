@@ -34,9 +34,6 @@
 namespace audio {
 
   namespace {
-    constexpr microseconds kMaxChunkDuration = 80ms;
-    constexpr microseconds kAvgChunkDuration = 50ms;
-    constexpr microseconds kFillBufferDuration = 200ms;
 
     // not implemented yet
     // constexpr microseconds kDrainBufferDuration = 50ms;
@@ -47,14 +44,14 @@ namespace audio {
   //
   void FillBufferGenerator::prepare(BeatStreamController& ctrl)
   {
-    max_chunk_frames_ = std::min(usecsToFrames(kMaxChunkDuration, ctrl.spec()),
-                                 ctrl.sound(kAccentOff).frames());
+    max_chunk_frames_ = std::min(usecsToFrames(ctrl.latency().max_chunk, ctrl.spec()),
+                                 ctrl.silence().frames());
 
-    avg_chunk_frames_ = usecsToFrames(kAvgChunkDuration, ctrl.spec());
+    avg_chunk_frames_ = usecsToFrames(ctrl.latency().avg_chunk, ctrl.spec());
 
     double percentage = (frames_total_ > 0) ? 100.0 * frames_done_ / frames_total_ : 0;
 
-    frames_total_ = usecsToFrames(kFillBufferDuration, ctrl.spec());
+    frames_total_ = usecsToFrames(ctrl.latency().fill_buffer, ctrl.spec());
     frames_done_ = frames_total_ / 100.0 * percentage;
   }
 
@@ -77,9 +74,12 @@ namespace audio {
     if (frames_left <= max_chunk_frames_)
       frames_chunk = frames_left;
     else
-      frames_chunk = frames_left / std::lround( (double) frames_left / avg_chunk_frames_ );
+      frames_chunk = ctrl.alignFrames(
+        frames_left / std::lround( (double) frames_left / avg_chunk_frames_ ));
 
-    data = ctrl.sound(kAccentOff).data();
+    frames_chunk = std::min(frames_chunk, ctrl.frameLimit());
+
+    data = ctrl.silence().data();
     bytes = frames_chunk * frameSize(ctrl.spec());
 
     frames_done_ += frames_chunk;
@@ -134,10 +134,10 @@ namespace audio {
 
   void PreCountGenerator::prepare(BeatStreamController& ctrl)
   {
-    max_chunk_frames_ = std::min(usecsToFrames(kMaxChunkDuration, ctrl.spec()),
-                                 ctrl.sound(kAccentOff).frames());
+    max_chunk_frames_ = std::min(usecsToFrames(ctrl.latency().max_chunk, ctrl.spec()),
+                                 ctrl.silence().frames());
 
-    avg_chunk_frames_ = usecsToFrames(kAvgChunkDuration, ctrl.spec());
+    avg_chunk_frames_ = usecsToFrames(ctrl.latency().avg_chunk, ctrl.spec());
 
     updateFramesLeft(ctrl);
   }
@@ -168,25 +168,27 @@ namespace audio {
   {
     auto& k = ctrl.kinematics();
 
+    auto& mixer = ctrl.mixer();
+
+    if (accent_point_) // start a new sound
+      mixer.start(ctrl.sound(kAccentMid), ctrl.accentGain(kAccentMid));
+
     size_t frames_chunk = 0;
-    if (accent_point_) // play sound
+    if (mixer.active()) // play the sounds up to the next accent
     {
-      const auto& sound_buffer = ctrl.sound(kAccentMid);
-
-      frames_chunk = std::min(sound_buffer.frames(), frames_left_);
-      data = sound_buffer.data();
-      bytes = frames_chunk * frameSize(ctrl.spec());
+      frames_chunk = mixer.mix(std::min(frames_left_, ctrl.frameLimit()), data, bytes);
     }
     else // play silence
     {
-      const auto& sound_buffer = ctrl.sound(kAccentOff);
+      const auto& sound_buffer = ctrl.silence();
 
       if (frames_left_ <= max_chunk_frames_)
         frames_chunk = frames_left_;
       else
-        frames_chunk = frames_left_ / std::lround( (double) frames_left_ / avg_chunk_frames_ );
+        frames_chunk = ctrl.alignFrames(
+          frames_left_ / std::lround( (double) frames_left_ / avg_chunk_frames_ ));
 
-      frames_chunk = std::min(sound_buffer.frames(), frames_chunk);
+      frames_chunk = std::min({sound_buffer.frames(), frames_chunk, ctrl.frameLimit()});
       data = sound_buffer.data();
       bytes = frames_chunk * frameSize(ctrl.spec());
     }
@@ -216,7 +218,9 @@ namespace audio {
   {
     auto& k = ctrl.kinematics();
 
-    k.step(framesToUsecs(frames_chunk, ctrl.spec()));
+    // step with the exact duration (no rounding to microseconds), since
+    // small chunks would accumulate the rounding errors
+    k.step(physics::seconds_dbl {(double) frames_chunk / ctrl.spec().rate});
 
     assert(frames_left_ >= frames_chunk);
     frames_left_ -= frames_chunk;
@@ -330,10 +334,10 @@ namespace audio {
 
   void RegularGenerator::prepare(BeatStreamController& ctrl)
   {
-    max_chunk_frames_ = std::min(usecsToFrames(kMaxChunkDuration, ctrl.spec()),
-                                 ctrl.sound(kAccentOff).frames());
+    max_chunk_frames_ = std::min(usecsToFrames(ctrl.latency().max_chunk, ctrl.spec()),
+                                 ctrl.silence().frames());
 
-    avg_chunk_frames_ = usecsToFrames(kAvgChunkDuration, ctrl.spec());
+    avg_chunk_frames_ = usecsToFrames(ctrl.latency().avg_chunk, ctrl.spec());
 
     updateFramesLeft(ctrl);
   }
@@ -378,26 +382,27 @@ namespace audio {
     const Meter& meter = ctrl.meter();
     const AccentPattern& accents = meter.accents();
 
-    size_t frames_chunk = 0;
-    if (accent_point_) // play sound
-    {
-      const auto& sound_buffer = ctrl.sound(accents[accent_]);
+    auto& mixer = ctrl.mixer();
 
-      frames_chunk = std::min(sound_buffer.frames(), frames_left_);
+    if (accent_point_) // start a new sound
+      mixer.start(ctrl.sound(accents[accent_]), ctrl.accentGain(accents[accent_]));
 
-      data = sound_buffer.data();
-      bytes = frames_chunk * frameSize(ctrl.spec());
+    size_t frames_chunk = 0;
+    if (mixer.active()) // play the sounds up to the next accent
+    {
+      frames_chunk = mixer.mix(std::min(frames_left_, ctrl.frameLimit()), data, bytes);
     }
     else // play silence
     {
-      const auto& sound_buffer = ctrl.sound(kAccentOff);
+      const auto& sound_buffer = ctrl.silence();
 
       if (frames_left_ <= max_chunk_frames_)
         frames_chunk = frames_left_;
       else
-        frames_chunk = frames_left_ / std::lround( (double) frames_left_ / avg_chunk_frames_ );
+        frames_chunk = ctrl.alignFrames(
+          frames_left_ / std::lround( (double) frames_left_ / avg_chunk_frames_ ));
 
-      frames_chunk = std::min(sound_buffer.frames(), frames_chunk);
+      frames_chunk = std::min({sound_buffer.frames(), frames_chunk, ctrl.frameLimit()});
 
       data = sound_buffer.data();
       bytes = frames_chunk * frameSize(ctrl.spec());
@@ -450,7 +455,9 @@ namespace audio {
     const Meter& meter = ctrl.meter();
     const AccentPattern& accents = meter.accents();
 
-    k.step(framesToUsecs(frames_chunk, ctrl.spec()));
+    // step with the exact duration (no rounding to microseconds), since
+    // small chunks would accumulate the rounding errors
+    k.step(physics::seconds_dbl {(double) frames_chunk / ctrl.spec().rate});
 
     assert(frames_left_ >= frames_chunk);
     frames_left_ -= frames_chunk;
@@ -560,4 +567,34 @@ namespace audio {
     // not implemented yet
   }
 
+  // IdleGenerator
+  //
+  void IdleGenerator::prepare(BeatStreamController& ctrl)
+  {
+    size_t frames = ctrl.periodFrames();
+    if (frames == 0)
+      frames = usecsToFrames(ctrl.latency().avg_chunk, ctrl.spec());
+
+    chunk_frames_ = std::min(frames, ctrl.silence().frames());
+  }
+
+  void IdleGenerator::cycle(BeatStreamController& ctrl,
+                            const void*& data, size_t& bytes)
+  {
+    const size_t frames_chunk = std::min(chunk_frames_, ctrl.frameLimit());
+
+    data = ctrl.silence().data();
+    bytes = frames_chunk * frameSize(ctrl.spec());
+  }
+
+  void IdleGenerator::updateStatus(BeatStreamController& ctrl, StreamStatus& status)
+  {
+    status.position = - ctrl.countIn();
+    status.tempo = ctrl.tempo();
+    status.acceleration = 0.0;
+    status.accent = -1;
+    status.next_accent_delay = 0us;
+    status.generator = kIdleGenerator;
+  }
+
 }//namespace audio
@@ -21,16 +21,20 @@
 #define GMetronome_Generator_h
 
 #include "AudioBuffer.h"
-#include "SoundLibrary.h"
+#include "Mixer.h"
+#include "Realtime.h"
+#include "Synthesizer.h"
 #include "Meter.h"
 #include "Physics.h"
 #include "Error.h"
 
 #include <algorithm>
+#include <array>
 #include <tuple>
 #include <type_traits>
 #include <string>
 #include <limits>
+#include <cstring>
 
 namespace audio {
 
@@ -40,6 +44,8 @@ namespace audio {
 
   constexpr GeneratorId kInvalidGenerator = std::numeric_limits<GeneratorId>::max();
 
+  constexpr size_t kNoFrameLimit = std::numeric_limits<size_t>::max();
+
   enum class TempoMode
   {
     kConstant   = 0,
@@ -109,7 +115,30 @@ namespace audio {
     void synchronize(double beats, double tempo, microseconds time);
     void swapMeter(Meter& meter);
     void resetMeter();
-    void setSound(Accent accent, const SoundParameters& params);
+
+    /**
+     * @brief Replace the sound of an accent
+     *
+     * The sound buffers are exchanged without copying or allocating memory.
+     * Buffers that do not match the current stream specification are rejected.
+     *
+     * @return True on success, false otherwise
+     */
+    bool swapSound(Accent accent, ByteBuffer& buffer);
+
+    /**
+     * @brief Set the gain (amplitude ratio) of an accent
+     *
+     * The gain applies to the sounds of the accent that start after the
+     * call, i.e. a playing sound is not affected.
+     */
+    void setAccentGain(Accent accent, float gain);
+
+    /**
+     * @brief Set the master gain (amplitude ratio) of the stream
+     * Changes are ramped by the mixer (see VoiceMixer::setGain).
+     */
+    void setGain(float gain);
 
     double tempo() const
       { return tempo_; }
@@ -137,18 +166,131 @@ namespace audio {
       { return meter_; }
     const bool isMeterEnabled() const
       { return meter_enabled_; }
-    const ByteBuffer& sound(Accent a)
+    const ByteBuffer& sound(Accent a) const
       { return sounds_[a]; }
+    float accentGain(Accent a) const
+      { return accent_gains_[a]; }
+    float gain() const
+      { return mixer_.gain(); }
+    const ByteBuffer& silence() const
+      { return silence_; }
+    const LatencyParameters& latency() const
+      { return latencyParameters(latency_); }
+    VoiceMixer& mixer()
+      { return mixer_; }
     physics::BeatKinematics& kinematics()
       { return k_; }
     const physics::BeatKinematics& kinematics() const
       { return k_; }
 
-    void prepare(const StreamSpec& spec);
+    /**
+     * @brief Prepare the stream for a new specification and latency profile
+     *
+     * The latency profile determines the chunk sizes of the generators.
+     * If the period size of the device is known, the generators align larger
+     * chunks of silence to whole periods (see alignFrames()).
+     * This function might allocate memory.
+     */
+    void prepare(const StreamSpec& spec,
+                 LatencyProfile latency = kDefaultLatencyProfile,
+                 size_t period_frames = 0);
+
+    /**
+     * @brief Buffers of the stream for a specification and latency profile
+     *
+     * The buffers are allocated in advance with allocateBuffers(), e.g. on
+     * another thread, and handed to prepare(Buffers&, size_t).
+     */
+    struct Buffers
+    {
+      StreamSpec spec {kDefaultSpec};
+      LatencyProfile latency {kDefaultLatencyProfile};
+      ByteBuffer silence;
+      std::array<ByteBuffer, kNumAccents> sounds;
+      ByteBuffer block;
+    };
+
+    /**
+     * @brief Allocate the buffers of the stream for a specification and
+     *        latency profile (the sounds are silent)
+     */
+    static Buffers allocateBuffers(const StreamSpec& spec,
+                                   LatencyProfile latency = kDefaultLatencyProfile);
+
+    /** Lock buffers that were allocated in advance into RAM. */
+    static bool lockMemory(const Buffers& buffers);
+
+    /**
+     * @brief Prepare the stream with buffers that were allocated in advance
+     *
+     * Same as prepare(), but the buffers of the stream are exchanged with the
+     * given buffers without allocating memory. The sounds are only exchanged
+     * if the specification changes. On return the argument holds the old
+     * buffers, which can be released on another thread.
+     */
+    void prepare(Buffers& buffers, size_t period_frames = 0);
+
+    /** The period size of the device in frames (0 if unknown). */
+    size_t periodFrames() const
+      { return period_frames_; }
+
+    /**
+     * @brief Align a chunk size to the period size of the device
+     *
+     * Chunks of at least one period are rounded down to whole periods,
+     * smaller chunks are not changed.
+     */
+    size_t alignFrames(size_t frames) const
+      {
+        if (period_frames_ > 0 && frames >= period_frames_)
+          return frames - frames % period_frames_;
+        else
+          return frames;
+      }
+
+    /**
+     * @brief Lock the buffers of the stream into RAM
+     *
+     * Locks the sounds, the silence buffer and the output block of the mixer
+     * (see audio::lockMemory). The buffers are reallocated by prepare(), so
+     * the function needs to be called again afterwards.
+     */
+    bool lockMemory() const;
 
     void start(GeneratorId gen);
     void stop();
-    void cycle(const void*& data, size_t& bytes);
+
+    /**
+     * @brief Produce the next chunk of the stream
+     *
+     * The chunk is owned by the controller and remains valid until the next
+     * call to a non-const member function.
+     *
+     * @param data       Receives a pointer to the chunk
+     * @param bytes      Receives the size of the chunk in bytes
+     * @param max_frames Maximum size of the chunk in frames
+     */
+    void cycle(const void*& data, size_t& bytes, size_t max_frames = kNoFrameLimit);
+
+    /**
+     * @brief Fill a caller-provided buffer with the next frames of the stream
+     *
+     * This is the counterpart of cycle() for backends that request a fixed
+     * number of frames from a callback (see BackendMode::kPull).
+     */
+    void render(void* buffer, size_t frames);
+
+    /**
+     * @brief Fill a caller-provided buffer with silence
+     *
+     * The state of the stream (e.g. the kinematics and the active generator)
+     * is not affected.
+     */
+    void renderSilence(void* buffer, size_t frames) const;
+
+    /** The maximum chunk size (in frames) of the current cycle. */
+    size_t frameLimit() const
+      { return frame_limit_; }
 
     const StreamStatus& status();
 
@@ -168,9 +310,15 @@ namespace audio {
     Meter default_meter_{kMeter1};
     Meter meter_{kMeter1};
     bool meter_enabled_{false};
-    SoundLibrary sounds_;
+    std::array<ByteBuffer, kNumAccents> sounds_;
+    std::array<float, kNumAccents> accent_gains_;
+    ByteBuffer silence_;
+    VoiceMixer mixer_;
+    LatencyProfile latency_{kDefaultLatencyProfile};
+    size_t period_frames_{0};
     physics::BeatKinematics k_;
     StreamStatus stream_status_;
+    size_t frame_limit_{kNoFrameLimit};
     StreamGeneratorBase* g_{nullptr};
 
     friend StreamGeneratorBase;
@@ -218,14 +366,19 @@ namespace audio {
   StreamController<Gs...>::StreamController(const StreamSpec& spec)
     : spec_{spec}
   {
-    SoundParameters silence;
-    silence.volume = 0.0;
-
-    sounds_.insert(kAccentOff, silence);
-    sounds_.insert(kAccentWeak, SoundParameters{});
-    sounds_.insert(kAccentMid, SoundParameters{});
-    sounds_.insert(kAccentStrong, SoundParameters{});
-    sounds_.prepare(spec_);
+    accent_gains_.fill(1.0f);
+
+    // start with silence until the first sounds arrive
+    for (auto& sound : sounds_)
+    {
+      sound.resize(spec_, kSoundDuration);
+      fillSilence(sound);
+    }
+
+    silence_.resize(spec_, std::max<microseconds>(kSoundDuration, latency().max_chunk));
+    fillSilence(silence_);
+
+    mixer_.prepare(spec_, silence_.frames());
   }
 
   template<typename...Gs>
@@ -309,35 +462,144 @@ namespace audio {
   }
 
   template<typename...Gs>
-  void StreamController<Gs...>::setSound(Accent accent, const SoundParameters& params)
+  bool StreamController<Gs...>::swapSound(Accent accent, ByteBuffer& buffer)
   {
-    sounds_.update(accent, params);
+    if (buffer.spec() != spec_ || buffer.frames() < sounds_[accent].frames())
+      return false;
+
+    sounds_[accent].swap(buffer);
     if (g_) g_->onSoundChanged(*this, accent);
+
+    return true;
   }
 
   template<typename...Gs>
-  void StreamController<Gs...>::prepare(const StreamSpec& spec)
+  void StreamController<Gs...>::setAccentGain(Accent accent, float gain)
+  {
+    accent_gains_[accent] = std::max(gain, 0.0f);
+  }
+
+  template<typename...Gs>
+  void StreamController<Gs...>::setGain(float gain)
+  {
+    mixer_.setGain(gain);
+  }
+
+  template<typename...Gs>
+  void StreamController<Gs...>::prepare(const StreamSpec& spec,
+                                        LatencyProfile latency,
+                                        size_t period_frames)
   {
     assert(spec.rate > 0);
 
-    if (spec != spec_)
+    period_frames_ = period_frames;
+
+    if (spec != spec_ || latency != latency_)
     {
-      sounds_.prepare(spec);
+      latency_ = latency;
+
+      // the silence buffer covers the largest chunk of the latency profile
+      silence_.resize(spec, std::max<microseconds>(kSoundDuration, this->latency().max_chunk));
+      fillSilence(silence_);
+    }
 
-      // Since a change of the stream specification may necessitate resizing
-      // the sound buffers we update the sounds immediately to prevent memory
-      // allocations during real-time processing.
-      sounds_.apply();
+    if (spec != spec_)
+    {
+      // Sounds of the old stream specification can not be played anymore.
+      // We replace them with silence until the re-rendered sounds arrive
+      // (see swapSound) and allocate the memory now to prevent allocations
+      // during real-time processing.
+      for (auto& sound : sounds_)
+      {
+        sound.resize(spec, kSoundDuration);
+        fillSilence(sound);
+      }
 
       spec_ = spec;
     }
 
+    // the mixer produces chunks of the same maximum size as the silence buffer
+    mixer_.prepare(spec_, silence_.frames());
+
+    std::apply( [this] (auto&&... args) { (args.prepare(*this), ...);}, gs_ );
+  }
+
+  template<typename...Gs>
+  typename StreamController<Gs...>::Buffers
+  StreamController<Gs...>::allocateBuffers(const StreamSpec& spec, LatencyProfile latency)
+  {
+    assert(spec.rate > 0);
+
+    Buffers buffers;
+    buffers.spec = spec;
+    buffers.latency = latency;
+
+    // same sizes as in prepare()
+    buffers.silence.resize(spec, std::max<microseconds>(kSoundDuration,
+                                                        latencyParameters(latency).max_chunk));
+    fillSilence(buffers.silence);
+
+    for (auto& sound : buffers.sounds)
+    {
+      sound.resize(spec, kSoundDuration);
+      fillSilence(sound);
+    }
+
+    buffers.block = ByteBuffer(spec, buffers.silence.size());
+
+    return buffers;
+  }
+
+  template<typename...Gs>
+  bool StreamController<Gs...>::lockMemory(const Buffers& buffers)
+  {
+    bool locked = audio::lockMemory(buffers.silence) && audio::lockMemory(buffers.block);
+
+    for (const auto& sound : buffers.sounds)
+      locked = audio::lockMemory(sound) && locked;
+
+    return locked;
+  }
+
+  template<typename...Gs>
+  void StreamController<Gs...>::prepare(Buffers& buffers, size_t period_frames)
+  {
+    assert(buffers.spec.rate > 0);
+
+    period_frames_ = period_frames;
+    latency_ = buffers.latency;
+
+    silence_.swap(buffers.silence);
+
+    if (buffers.spec != spec_)
+    {
+      // silent until the re-rendered sounds arrive (see swapSound)
+      for (size_t i = 0; i < sounds_.size(); ++i)
+        sounds_[i].swap(buffers.sounds[i]);
+
+      spec_ = buffers.spec;
+    }
+
+    mixer_.prepare(spec_, buffers.block);
+
     std::apply( [this] (auto&&... args) { (args.prepare(*this), ...);}, gs_ );
   }
 
+  template<typename...Gs>
+  bool StreamController<Gs...>::lockMemory() const
+  {
+    bool locked = audio::lockMemory(silence_) && mixer_.lockMemory();
+
+    for (const auto& sound : sounds_)
+      locked = audio::lockMemory(sound) && locked;
+
+    return locked;
+  }
+
   template<typename...Gs>
   void StreamController<Gs...>::start(GeneratorId gen)
   {
+    mixer_.reset();
     switchGenerator(gen);
     if (g_) g_->onStart(*this);
   }
@@ -349,9 +611,61 @@ namespace audio {
   }
 
   template<typename...Gs>
-  void StreamController<Gs...>::cycle(const void*& data, size_t& bytes)
+  void StreamController<Gs...>::cycle(const void*& data, size_t& bytes, size_t max_frames)
   {
+    frame_limit_ = max_frames;
+
     if (g_) g_->cycle(*this, data, bytes);
+
+    frame_limit_ = kNoFrameLimit;
+  }
+
+  template<typename...Gs>
+  void StreamController<Gs...>::render(void* buffer, size_t frames)
+  {
+    const size_t frame_size = frameSize(spec_);
+
+    auto out = static_cast<ByteBuffer::pointer>(buffer);
+
+    while (frames > 0)
+    {
+      const void* data = nullptr;
+      size_t bytes = 0;
+
+      cycle(data, bytes, frames);
+
+      size_t chunk_frames = std::min(bytes / frame_size, frames);
+      if (chunk_frames == 0 || data == nullptr)
+        break;
+
+      std::memcpy(out, data, chunk_frames * frame_size);
+
+      out += chunk_frames * frame_size;
+      frames -= chunk_frames;
+    }
+
+    // the generator did not produce enough frames (e.g. no active generator)
+    renderSilence(out, frames);
+  }
+
+  template<typename...Gs>
+  void StreamController<Gs...>::renderSilence(void* buffer, size_t frames) const
+  {
+    const size_t frame_size = frameSize(spec_);
+
+    auto out = static_cast<ByteBuffer::pointer>(buffer);
+
+    while (frames > 0)
+    {
+      size_t chunk_frames = std::min(silence_.frames(), frames);
+      if (chunk_frames == 0)
+        break;
+
+      std::memcpy(out, silence_.data(), chunk_frames * frame_size);
+
+      out += chunk_frames * frame_size;
+      frames -= chunk_frames;
+    }
   }
 
   template<typename...Gs>
@@ -387,18 +701,21 @@ namespace audio {
   class PreCountGenerator;
   class RegularGenerator;
   class DrainBufferGenerator;
+  class IdleGenerator;
 
   using BeatStreamController = StreamController<
     FillBufferGenerator,
     PreCountGenerator,
     RegularGenerator,
-    DrainBufferGenerator
+    DrainBufferGenerator,
+    IdleGenerator
     >;
 
   constexpr GeneratorId kFillBufferGenerator  = 0;
   constexpr GeneratorId kPreCountGenerator    = 1;
   constexpr GeneratorId kRegularGenerator     = 2;
   constexpr GeneratorId kDrainBufferGenerator = 3;
+  constexpr GeneratorId kIdleGenerator        = 4;
 
   /**
    * @class FillBufferGenerator
@@ -486,6 +803,25 @@ namespace audio {
     void cycle(BeatStreamController& ctrl, const void*& data, size_t& bytes) override;
   };
 
+  /**
+   * @class IdleGenerator
+   *
+   * Plays silence until the generator is switched, e.g. to keep a device
+   * running between two sessions (see Ticker::setStandby()). The chunks do
+   * not exceed the period size of the device, so that the stream responds
+   * quickly to a switch of the generator.
+   */
+  class IdleGenerator : public StreamGenerator<BeatStreamController> {
+  public:
+    void prepare(BeatStreamController& ctrl) override;
+    void cycle(BeatStreamController& ctrl, const void*& data, size_t& bytes) override;
+
+    void updateStatus(BeatStreamController& ctrl, StreamStatus& status) override;
+
+  private:
+    size_t chunk_frames_{0};
+  };
+
   /**
    * @class StreamTimer
    */
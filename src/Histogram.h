@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GMetronome_Histogram_h
+#define GMetronome_Histogram_h
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace audio {
+
+  using std::chrono::nanoseconds;
+
+  /**
+   * @class Histogram
+   * @brief Distribution of durations in power-of-two buckets
+   *
+   * Bucket 0 counts durations below 1ns, bucket n > 0 counts durations
+   * in [2^(n-1), 2^n) ns. The last bucket is open-ended.
+   */
+  struct Histogram
+  {
+    static constexpr std::size_t kNumBuckets = 32;
+
+    std::array<std::uint64_t, kNumBuckets> buckets {};
+    std::uint64_t count {0};
+    nanoseconds   sum {0};
+    nanoseconds   max {0};
+    nanoseconds   last {0};
+
+    /** The bucket of a duration. */
+    static std::size_t bucket(nanoseconds value)
+      {
+        std::size_t b = 0;
+        for (auto v = value.count(); v > 0 && b < kNumBuckets - 1; v >>= 1)
+          ++b;
+        return b;
+      }
+
+    /** The (exclusive) upper bound of a bucket. */
+    static nanoseconds upperBound(std::size_t bucket)
+      { return nanoseconds(std::int64_t(1) << bucket); }
+
+    nanoseconds mean() const
+      { return count > 0 ? sum / static_cast<std::int64_t>(count) : nanoseconds(0); }
+
+    /**
+     * @brief Estimate a percentile of the distribution
+     * @param p  Percentile in the range [0,1]
+     * @return The upper bound of the bucket that contains the percentile
+     *         (limited to the maximum value)
+     */
+    nanoseconds percentile(double p) const
+      {
+        if (count == 0)
+          return nanoseconds(0);
+
+        const auto rank = static_cast<std::uint64_t>(p * (count - 1));
+
+        std::uint64_t accum = 0;
+        for (std::size_t b = 0; b < kNumBuckets; ++b)
+        {
+          accum += buckets[b];
+          if (accum > rank)
+            return std::min(upperBound(b), max);
+        }
+        return max;
+      }
+  };
+
+  /**
+   * @class HistogramRecorder
+   * @brief Records a Histogram without locks
+   *
+   * A single thread records durations (e.g. the audio thread), while other
+   * threads may take snapshots at any time. The recording is wait-free and
+   * does not allocate memory. A snapshot is not atomic as a whole, i.e. the
+   * counters of concurrent recordings might be partially included.
+   */
+  class HistogramRecorder {
+  public:
+    void record(nanoseconds value) noexcept
+      {
+        const auto ns = value.count();
+
+        buckets_[Histogram::bucket(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(ns, std::memory_order_relaxed);
+        last_.store(ns, std::memory_order_relaxed);
+
+        if (ns > max_.load(std::memory_order_relaxed))
+          max_.store(ns, std::memory_order_relaxed);
+      }
+
+    Histogram snapshot() const noexcept
+      {
+        Histogram histogram;
+        for (std::size_t b = 0; b < Histogram::kNumBuckets; ++b)
+          histogram.buckets[b] = buckets_[b].load(std::memory_order_relaxed);
+
+        histogram.count = count_.load(std::memory_order_relaxed);
+        histogram.sum = nanoseconds(sum_.load(std::memory_order_relaxed));
+        histogram.max = nanoseconds(max_.load(std::memory_order_relaxed));
+        histogram.last = nanoseconds(last_.load(std::memory_order_relaxed));
+        return histogram;
+      }
+
+    void reset() noexcept
+      {
+        for (auto& bucket : buckets_)
+          bucket.store(0, std::memory_order_relaxed);
+
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+        last_.store(0, std::memory_order_relaxed);
+      }
+
+  private:
+    std::array<std::atomic<std::uint64_t>, Histogram::kNumBuckets> buckets_ {};
+    std::atomic<std::uint64_t> count_ {0};
+    std::atomic<std::int64_t> sum_ {0};
+    std::atomic<std::int64_t> max_ {0};
+    std::atomic<std::int64_t> last_ {0};
+  };
+
+}//namespace audio
+#endif//GMetronome_Histogram_h
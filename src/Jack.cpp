@@ -0,0 +1,415 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "Jack.h"
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+
+#ifndef NDEBUG
+#  include <iostream>
+#endif
+
+namespace audio {
+
+  namespace {
+
+    class JackBackendError : public BackendError {
+    public:
+      explicit JackBackendError(BackendState state, const std::string& what = "")
+        : BackendError(BackendIdentifier::kJACK, state, what)
+      {}
+    };
+
+    // the metronome supports mono and stereo output
+    constexpr unsigned int kMinChannels = 1;
+    constexpr unsigned int kMaxChannels = 2;
+
+    const std::vector<const char*> kPortNames = {"out_1", "out_2"};
+
+    // JACK uses 32 bit floating point samples in host byte order
+    constexpr SampleFormat kJackFormat =
+      (hostEndian() == Endian::kBig) ? SampleFormat::kFloat32BE : SampleFormat::kFloat32LE;
+
+  }//unnamed namespace
+
+  JackBackend::JackBackend()
+    : state_ {BackendState::kConfig},
+      cfg_ {kDefaultConfig},
+      spec_ {kJackFormat, kDefaultRate, kDefaultChannels},
+      callback_ {nullptr},
+      client_ {nullptr},
+      port_latency_ {0},
+      xruns_ {0},
+      shutdown_ {false}
+  {}
+
+  JackBackend::~JackBackend()
+  {
+    closeClient();
+  }
+
+  std::vector<DeviceInfo> JackBackend::devices()
+  {
+    DeviceInfo info =
+      {
+        "",
+        "Default JACK Server",
+        kMinChannels,
+        kMaxChannels,
+        kDefaultChannels,
+        kDefaultRate,
+        kDefaultRate,
+        kDefaultRate
+      };
+
+    // the sample rate is determined by the server
+    jack_status_t status;
+    if (jack_client_t* client = jack_client_open(PACKAGE_NAME, JackNoStartServer, &status); client)
+    {
+      info.min_rate = info.max_rate = info.rate = jack_get_sample_rate(client);
+      jack_client_close(client);
+    }
+
+    return {info};
+  }
+
+  void JackBackend::configure(const DeviceConfig& config)
+  {
+    assert(state_ == BackendState::kConfig);
+    cfg_ = config;
+  }
+
+  DeviceConfig JackBackend::configuration()
+  { return cfg_; }
+
+  DeviceConfig JackBackend::open()
+  {
+    assert(state_ == BackendState::kConfig);
+
+    if (!callback_)
+      throw JackBackendError(state_, "missing render callback");
+
+    openClient();
+
+    jack_nframes_t buffer_size = 0;
+    try {
+      registerPorts();
+
+      buffer_size = jack_get_buffer_size(client_);
+      allocateBuffer(buffer_size);
+    }
+    catch(...)
+    {
+      closeClient();
+      throw;
+    }
+
+    xruns_ = 0;
+    state_ = BackendState::kOpen;
+
+    DeviceConfig actual_cfg = cfg_;
+    actual_cfg.spec = spec_;
+    actual_cfg.period_frames = buffer_size;
+    actual_cfg.buffer_frames = buffer_size;
+
+    return actual_cfg;
+  }
+
+  void JackBackend::close()
+  {
+    assert(state_ == BackendState::kOpen);
+    closeClient();
+    state_ = BackendState::kConfig;
+  }
+
+  void JackBackend::start()
+  {
+    assert(state_ == BackendState::kOpen);
+
+    if (jack_activate(client_) != 0)
+      throw JackBackendError(state_, "failed to activate JACK client");
+
+    // ports can only be connected by an active client
+    connectPorts();
+
+    state_ = BackendState::kRunning;
+  }
+
+  void JackBackend::stop()
+  {
+    assert(state_ == BackendState::kRunning);
+
+    // the process callback is not called after deactivation
+    if (jack_deactivate(client_) != 0)
+      throw JackBackendError(state_, "failed to deactivate JACK client");
+
+    state_ = BackendState::kOpen;
+  }
+
+  size_t JackBackend::write(const void* data, size_t bytes)
+  {
+    throw JackBackendError(state_, "write not available in pull mode");
+  }
+
+  void JackBackend::flush() {}
+
+  void JackBackend::drain() {}
+
+  microseconds JackBackend::latency()
+  {
+    return framesToUsecs(port_latency_.load(std::memory_order_relaxed), spec_);
+  }
+
+  std::uint64_t JackBackend::xruns() const
+  {
+    return xruns_.load(std::memory_order_relaxed);
+  }
+
+  bool JackBackend::transport(Transport& transport)
+  {
+    std::lock_guard<std::mutex> lock(client_mutex_);
+
+    if (!client_)
+      return false;
+
+    jack_position_t position;
+    jack_transport_state_t state = jack_transport_query(client_, &position);
+
+    transport.rolling = (state == JackTransportRolling || state == JackTransportStarting);
+
+    if (position.valid & JackPositionBBT)
+      transport.tempo = position.beats_per_minute;
+    else
+      transport.tempo = 0.0;
+
+    return true;
+  }
+
+  BackendState JackBackend::state() const
+  {
+    return state_;
+  }
+
+  BackendMode JackBackend::mode() const
+  {
+    return BackendMode::kPull;
+  }
+
+  void JackBackend::setRenderCallback(RenderCallback* callback)
+  {
+    assert(state_ == BackendState::kConfig);
+    callback_ = callback;
+  }
+
+  void JackBackend::openClient()
+  {
+    jack_status_t status;
+    jack_client_t* client = nullptr;
+
+    if (cfg_.name.empty())
+      client = jack_client_open(PACKAGE_NAME, JackNoStartServer, &status);
+    else
+      client = jack_client_open(PACKAGE_NAME,
+                                static_cast<jack_options_t>(JackNoStartServer | JackServerName),
+                                &status,
+                                cfg_.name.c_str());
+    if (!client)
+      throw JackBackendError(state_, "failed to connect to the JACK server");
+
+    shutdown_ = false;
+
+    jack_set_process_callback(client, &processCallback, this);
+    jack_set_buffer_size_callback(client, &bufferSizeCallback, this);
+    jack_set_sample_rate_callback(client, &sampleRateCallback, this);
+    jack_set_latency_callback(client, &latencyCallback, this);
+    jack_set_xrun_callback(client, &xrunCallback, this);
+    jack_on_shutdown(client, &shutdownCallback, this);
+
+    spec_.format = kJackFormat;
+    spec_.rate = jack_get_sample_rate(client);
+    spec_.channels = std::clamp(cfg_.spec.channels, kMinChannels, kMaxChannels);
+
+    std::lock_guard<std::mutex> lock(client_mutex_);
+    client_ = client;
+  }
+
+  void JackBackend::closeClient() noexcept
+  {
+    std::lock_guard<std::mutex> lock(client_mutex_);
+
+    if (client_)
+    {
+      // closing the client deactivates it and unregisters the ports
+      jack_client_close(client_);
+      client_ = nullptr;
+    }
+    ports_.clear();
+  }
+
+  void JackBackend::registerPorts()
+  {
+    ports_.clear();
+
+    for (unsigned int channel = 0; channel < spec_.channels; ++channel)
+    {
+      jack_port_t* port = jack_port_register(client_,
+                                             kPortNames[channel],
+                                             JACK_DEFAULT_AUDIO_TYPE,
+                                             JackPortIsOutput | JackPortIsTerminal,
+                                             0);
+      if (!port)
+        throw JackBackendError(state_, "failed to register JACK port");
+
+      ports_.push_back(port);
+    }
+  }
+
+  void JackBackend::connectPorts()
+  {
+    const char** playback_ports = jack_get_ports(client_,
+                                                 nullptr,
+                                                 JACK_DEFAULT_AUDIO_TYPE,
+                                                 JackPortIsPhysical | JackPortIsInput);
+    if (!playback_ports)
+    {
+#ifndef NDEBUG
+      std::cerr << "JackBackend: no physical playback ports found" << std::endl;
+#endif
+      return;
+    }
+
+    size_t n_playback_ports = 0;
+    while (playback_ports[n_playback_ports])
+      ++n_playback_ports;
+
+    // connect each output port to the corresponding playback port
+    // (a mono output is connected to the first two playback ports)
+    size_t n_connections = std::min(n_playback_ports,
+                                    std::max<size_t>(ports_.size(), kMaxChannels));
+
+    for (size_t n = 0; n < n_connections; ++n)
+    {
+      const char* source = jack_port_name(ports_[n % ports_.size()]);
+
+      int error = jack_connect(client_, source, playback_ports[n]);
+      if (error != 0 && error != EEXIST)
+      {
+#ifndef NDEBUG
+        std::cerr << "JackBackend: failed to connect " << source
+                  << " to " << playback_ports[n] << std::endl;
+#endif
+      }
+    }
+
+    jack_free(playback_ports);
+  }
+
+  void JackBackend::allocateBuffer(jack_nframes_t frames)
+  {
+    buffer_.assign(frames * spec_.channels, 0.0f);
+  }
+
+  int JackBackend::processCallback(jack_nframes_t frames, void* arg)
+  {
+    auto backend = static_cast<JackBackend*>(arg);
+
+    const size_t channels = backend->ports_.size();
+    float* buffer = backend->buffer_.data();
+
+    const bool render = !backend->shutdown_.load(std::memory_order_relaxed)
+      && frames * channels <= backend->buffer_.size();
+
+    if (render)
+      backend->callback_->render(buffer, frames);
+
+    // de-interleave the rendered frames into the port buffers
+    for (size_t channel = 0; channel < channels; ++channel)
+    {
+      auto out = static_cast<jack_default_audio_sample_t*>(
+        jack_port_get_buffer(backend->ports_[channel], frames));
+
+      if (render)
+        for (jack_nframes_t frame = 0; frame < frames; ++frame)
+          out[frame] = buffer[frame * channels + channel];
+      else
+        std::fill_n(out, frames, 0.0f);
+    }
+
+    return 0;
+  }
+
+  int JackBackend::bufferSizeCallback(jack_nframes_t frames, void* arg)
+  {
+    // the process callback is suspended during the change
+    auto backend = static_cast<JackBackend*>(arg);
+    backend->allocateBuffer(frames);
+    return 0;
+  }
+
+  int JackBackend::sampleRateCallback(jack_nframes_t rate, void* arg)
+  {
+    auto backend = static_cast<JackBackend*>(arg);
+    if (rate != backend->spec_.rate)
+    {
+#ifndef NDEBUG
+      std::cerr << "JackBackend: sample rate of the server changed (output muted)" << std::endl;
+#endif
+      backend->shutdown_.store(true, std::memory_order_relaxed);
+    }
+    return 0;
+  }
+
+  void JackBackend::latencyCallback(jack_latency_callback_mode_t mode, void* arg)
+  {
+    if (mode != JackPlaybackLatency)
+      return;
+
+    auto backend = static_cast<JackBackend*>(arg);
+    if (backend->ports_.empty())
+      return;
+
+    jack_latency_range_t range;
+    jack_port_get_latency_range(backend->ports_.front(), JackPlaybackLatency, &range);
+
+    backend->port_latency_.store(range.max, std::memory_order_relaxed);
+  }
+
+  int JackBackend::xrunCallback(void* arg)
+  {
+    auto backend = static_cast<JackBackend*>(arg);
+    backend->xruns_.fetch_add(1, std::memory_order_relaxed);
+    return 0;
+  }
+
+  void JackBackend::shutdownCallback(void* arg)
+  {
+#ifndef NDEBUG
+    std::cerr << "JackBackend: server shut down" << std::endl;
+#endif
+    auto backend = static_cast<JackBackend*>(arg);
+    backend->shutdown_.store(true, std::memory_order_relaxed);
+  }
+
+}//namespace audio
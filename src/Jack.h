@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef GMetronome_Jack_h
+#define GMetronome_Jack_h
+
+#include "AudioBackend.h"
+#include <jack/jack.h>
+#include <jack/transport.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace audio {
+
+  /**
+   * @class JackBackend
+   * @brief JACK Backend
+   *
+   * The backend operates in pull mode (see BackendMode), i.e. the process
+   * callback of the JACK client requests the audio data from the render
+   * callback. The stream specification follows the JACK server (32 bit float
+   * samples with the sample rate of the server) and the period size of the
+   * stream follows the buffer size of the server. The output ports are
+   * connected to the physical playback ports of the server on start.
+   *
+   * The name of the device is the name of the JACK server (empty for the
+   * default server).
+   */
+  class JackBackend : public Backend
+  {
+  public:
+    JackBackend();
+    JackBackend(const JackBackend&) = delete;
+    JackBackend(JackBackend&&) = delete;
+    ~JackBackend();
+
+    JackBackend& operator=(const JackBackend&) = delete;
+    JackBackend& operator=(JackBackend&&) = delete;
+
+    std::vector<DeviceInfo> devices() override;
+    void configure(const DeviceConfig& config) override;
+    DeviceConfig configuration() override;
+    DeviceConfig open() override;
+    void close() override;
+    void start() override;
+    void stop() override;
+    size_t write(const void* data, size_t bytes) override;
+    void flush() override;
+    void drain() override;
+    microseconds latency() override;
+    std::uint64_t xruns() const override;
+    bool transport(Transport& transport) override;
+    BackendState state() const override;
+    BackendMode mode() const override;
+    void setRenderCallback(RenderCallback* callback) override;
+
+  private:
+    BackendState state_;
+    DeviceConfig cfg_;
+    StreamSpec spec_;
+    RenderCallback* callback_;
+    jack_client_t* client_;
+    std::mutex client_mutex_; // protects client_ for transport()
+    std::vector<jack_port_t*> ports_;
+    std::vector<float> buffer_; // interleaved render buffer
+    std::atomic<jack_nframes_t> port_latency_;
+    std::atomic<std::uint64_t> xruns_;
+    std::atomic<bool> shutdown_;
+
+    void openClient();
+    void closeClient() noexcept;
+    void registerPorts();
+    void connectPorts();
+    void allocateBuffer(jack_nframes_t frames);
+
+    static int processCallback(jack_nframes_t frames, void* arg);
+    static int bufferSizeCallback(jack_nframes_t frames, void* arg);
+    static int sampleRateCallback(jack_nframes_t rate, void* arg);
+    static void latencyCallback(jack_latency_callback_mode_t mode, void* arg);
+    static int xrunCallback(void* arg);
+    static void shutdownCallback(void* arg);
+  };
+
+}//namespace audio
+#endif//GMetronome_Jack_h
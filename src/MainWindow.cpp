@@ -29,9 +29,11 @@
 #include "AccentButton.h"
 #include "Settings.h"
 #include "Shortcut.h"
+#include "AllocGuard.h"
 
 #include <glibmm/i18n.h>
 #include <iomanip>
+#include <sstream>
 #include <stdexcept>
 #include <iostream>
 #include <functional>
@@ -303,6 +305,7 @@ void MainWindow::initActions()
         settings::state()
       },
       {kActionFullScreen,              sigc::mem_fun(*this, &MainWindow::onToggleFullScreen)},
+      {kActionShowStats,               sigc::mem_fun(*this, &MainWindow::onShowStats)},
       {kActionPendulumTogglePhase,     sigc::mem_fun(*this, &MainWindow::onPendulumTogglePhase)},
       {kActionTempoQuickSet,           sigc::mem_fun(*this, &MainWindow::onTempoQuickSet)}
     };
@@ -333,6 +336,15 @@ void MainWindow::initUI()
   info_overlay_->add_overlay(*info_revealer_);
   info_revealer_->set_reveal_child(false);
 
+  // initialize audio statistics (hidden by default)
+  stats_label_.set_name("statsLabel");
+  stats_label_.set_halign(Gtk::ALIGN_END);
+  stats_label_.set_valign(Gtk::ALIGN_END);
+  stats_label_.set_xalign(0.0);
+  stats_label_.set_no_show_all(true);
+  info_overlay_->add_overlay(stats_label_);
+  info_overlay_->set_overlay_pass_through(stats_label_, true);
+
   // initialize about dialog
   about_dialog_.set_transient_for(*this);
 
@@ -1072,6 +1084,35 @@ void MainWindow::onToggleFullScreen(const Glib::VariantBase& parameter)
     unfullscreen();
 }
 
+namespace {
+  constexpr unsigned int kStatsTimerInterval = 500; // ms
+}//unnamed namespace
+
+void MainWindow::onShowStats(const Glib::VariantBase& value)
+{
+  auto new_state
+    = Glib::VariantBase::cast_dynamic<Glib::Variant<bool>>(value);
+
+  if (new_state.get())
+  {
+    updateStats();
+    stats_label_.show();
+
+    if (!stats_timer_connection_.connected())
+      stats_timer_connection_ = Glib::signal_timeout()
+        .connect(sigc::mem_fun(*this, &MainWindow::onStatsTimer), kStatsTimerInterval);
+  }
+  else
+  {
+    stats_timer_connection_.disconnect();
+    stats_label_.hide();
+  }
+
+  Glib::RefPtr<Gio::Action> action = lookup_action(kActionShowStats);
+  auto simple_action =  Glib::RefPtr<Gio::SimpleAction>::cast_dynamic(action);
+  simple_action->set_state(value);
+}
+
 void MainWindow::onPendulumTogglePhase(const Glib::VariantBase& value)
 {
   pendulum_.togglePhase();
@@ -1715,6 +1756,70 @@ bool MainWindow::onTapAnimationTimer()
   return value > 0.0;
 }
 
+namespace {
+
+  // a short human readable representation of a duration
+  std::string formatDuration(std::chrono::nanoseconds duration)
+  {
+    using std::chrono::duration_cast;
+    using std::chrono::duration;
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+
+    if (duration < std::chrono::microseconds(10))
+      out << duration.count() << "ns";
+    else if (duration < std::chrono::milliseconds(10))
+      out << duration_cast<duration<double, std::micro>>(duration).count() << "µs";
+    else
+      out << duration_cast<duration<double, std::milli>>(duration).count() << "ms";
+
+    return out.str();
+  }
+
+  std::string formatHistogram(const std::string& name, const audio::Histogram& histogram)
+  {
+    std::ostringstream out;
+    out << std::left << std::setw(7) << name
+        << "mean " << std::setw(9) << formatDuration(histogram.mean())
+        << "p99 " << std::setw(9) << formatDuration(histogram.percentile(0.99))
+        << "max " << formatDuration(histogram.max);
+
+    return out.str();
+  }
+
+}//unnamed namespace
+
+void MainWindow::updateStats()
+{
+  const audio::Ticker::Stats stats = app_->tickerStats();
+
+  std::ostringstream out;
+  out << "cycles " << stats.cycles
+      << "  xruns " << stats.xruns
+      << "  deferred " << stats.deferred_commands
+      << "  cached " << stats.sound_cache_hits
+      << "/" << stats.sound_cache_hits + stats.sound_cache_misses;
+
+  if (audio::AllocGuard::enabled())
+    out << "  allocs " << stats.alloc_violations;
+
+  out << "\n"
+      << formatHistogram("cycle", stats.cycle_time) << "\n"
+      << formatHistogram("write", stats.write_time) << "\n"
+      << formatHistogram("fill", stats.buffer_fill) << "\n"
+      << formatHistogram("synth", stats.render_time) << "\n"
+      << formatHistogram("start", stats.first_click);
+
+  stats_label_.set_text(out.str());
+}
+
+bool MainWindow::onStatsTimer()
+{
+  updateStats();
+  return true;
+}
+
 void MainWindow::onMessage(const Message& message)
 {
   info_topic_label_->set_text(message.topic);
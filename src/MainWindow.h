@@ -67,6 +67,7 @@ private:
   sigc::connection tempo_quick_set_timer_connection_;
   sigc::connection tap_animation_timer_connection_;
   sigc::connection volume_label_hide_timer_connection_;
+  sigc::connection stats_timer_connection_;
 
   // Dialogs
   SettingsDialog* preferences_dialog_;
@@ -101,6 +102,7 @@ private:
   Gtk::Label* info_text_label_;
   Gtk::Label* info_details_label_;
   Gtk::Expander* info_details_expander_;
+  Gtk::Label stats_label_;
   Gtk::Box* main_content_box_;
   Gtk::MenuButton* volume_menu_button_;
   Gtk::Revealer* volume_button_revealer_;
@@ -208,6 +210,7 @@ private:
   void onShowAbout(const Glib::VariantBase& value);
   void onShowPendulum(const Glib::VariantBase& value);
   void onToggleFullScreen(const Glib::VariantBase& value);
+  void onShowStats(const Glib::VariantBase& value);
   void onPendulumTogglePhase(const Glib::VariantBase& value);
   void onTempoQuickSet(const Glib::VariantBase& value);
 
@@ -260,6 +263,9 @@ private:
   bool isTapAnimationTimerRunning();
   bool onTapAnimationTimer();
 
+  void updateStats();
+  bool onStatsTimer();
+
   void onMessage(const Message& message);
   void onMessageResponse(int response);
 
@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "Mixer.h"
+#include "Realtime.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <cassert>
+
+#ifndef NDEBUG
+# include <iostream>
+#endif
+
+namespace audio {
+
+  namespace {
+
+    // Sample arithmetic of a format. The sample values are accumulated in
+    // a wider type and saturated when they are stored.
+    template<SampleFormat Format>
+    struct SampleMath
+    {
+      using ValueType = typename SampleValueType<Format>::type;
+
+      using AccType = std::conditional_t<isFloatingPoint(Format), float,
+                                         std::conditional_t<(sizeof(ValueType) < 4),
+                                                            int32_t, int64_t>>;
+
+      using GainType = std::conditional_t<std::is_same_v<AccType, int64_t>, double, float>;
+
+      static constexpr AccType kOffset = [] () -> AccType {
+        if constexpr (isUnsigned(Format))
+          return AccType(std::numeric_limits<std::make_signed_t<ValueType>>::max()) + 1;
+        else
+          return 0;
+      }();
+
+      static constexpr AccType kMin = isFloatingPoint(Format)
+        ? AccType(-1) : AccType(std::numeric_limits<ValueType>::min());
+      static constexpr AccType kMax = isFloatingPoint(Format)
+        ? AccType(1) : AccType(std::numeric_limits<ValueType>::max());
+
+      static constexpr size_t kSize = sampleSize(Format);
+
+      // signed value of the n-th sample
+      static AccType get(const Byte* data, size_t n)
+        {
+          return AccType(ValueType(SampleView<Format, const Byte*>(data + n * kSize))) - kOffset;
+        }
+
+      static void set(Byte* data, size_t n, AccType value)
+        {
+          SampleView<Format, Byte*>(data + n * kSize)
+            = ValueType(std::clamp(value + kOffset, kMin, kMax));
+        }
+
+      static AccType scale(AccType value, float gain)
+        {
+          return AccType(GainType(value) * GainType(gain));
+        }
+    };
+
+    template<SampleFormat Format>
+    void scaleSamples(Byte* out, const Byte* in, size_t samples, float gain)
+    {
+      using Math = SampleMath<Format>;
+
+      if (gain == 1.0f)
+        std::memcpy(out, in, samples * Math::kSize);
+      else
+        for (size_t n = 0; n < samples; ++n)
+          Math::set(out, n, Math::scale(Math::get(in, n), gain));
+    }
+
+    // Adds the samples of the input to the output and saturates the sums.
+    // The loops have no dependencies between iterations, so the compiler
+    // is able to vectorize them for the native sample formats.
+    template<SampleFormat Format>
+    void mixSamples(Byte* out, const Byte* in, size_t samples, float gain)
+    {
+      using Math = SampleMath<Format>;
+
+      if (gain == 1.0f)
+        for (size_t n = 0; n < samples; ++n)
+          Math::set(out, n, Math::get(out, n) + Math::get(in, n));
+      else
+        for (size_t n = 0; n < samples; ++n)
+          Math::set(out, n, Math::get(out, n) + Math::scale(Math::get(in, n), gain));
+    }
+
+    template<SampleFormat Format>
+    float rampSamples(Byte* data, size_t frames, size_t channels,
+                      float gain, float target, float step)
+    {
+      using Math = SampleMath<Format>;
+
+      for (size_t f = 0, n = 0; f < frames; ++f)
+      {
+        if (gain < target)
+          gain = std::min(gain + step, target);
+        else if (gain > target)
+          gain = std::max(gain - step, target);
+
+        for (size_t c = 0; c < channels; ++c, ++n)
+          Math::set(data, n, Math::scale(Math::get(data, n), gain));
+      }
+      return gain;
+    }
+
+    // calls select(std::integral_constant<SampleFormat, format>) and returns
+    // false for unknown formats
+    template<typename Select>
+    bool selectFormat(SampleFormat format, Select&& select)
+    {
+      using Fmt = SampleFormat;
+
+      switch(format)
+      {
+      case Fmt::kU8: select(std::integral_constant<Fmt, Fmt::kU8>()); break;
+      case Fmt::kS8: select(std::integral_constant<Fmt, Fmt::kS8>()); break;
+      case Fmt::kS16LE: select(std::integral_constant<Fmt, Fmt::kS16LE>()); break;
+      case Fmt::kS16BE: select(std::integral_constant<Fmt, Fmt::kS16BE>()); break;
+      case Fmt::kU16LE: select(std::integral_constant<Fmt, Fmt::kU16LE>()); break;
+      case Fmt::kU16BE: select(std::integral_constant<Fmt, Fmt::kU16BE>()); break;
+      case Fmt::kS32LE: select(std::integral_constant<Fmt, Fmt::kS32LE>()); break;
+      case Fmt::kS32BE: select(std::integral_constant<Fmt, Fmt::kS32BE>()); break;
+      case Fmt::kFloat32LE: select(std::integral_constant<Fmt, Fmt::kFloat32LE>()); break;
+      case Fmt::kFloat32BE: select(std::integral_constant<Fmt, Fmt::kFloat32BE>()); break;
+      case Fmt::kUnknown:
+        [[fallthrough]];
+      default:
+        return false;
+      };
+      return true;
+    }
+
+  }//unnamed namespace
+
+  bool rampGain(void* data, size_t frames, const StreamSpec& spec, float from, float to)
+  {
+    if (frames == 0)
+      return true;
+
+    const float step = (from < to ? to - from : from - to) / frames;
+
+    return selectFormat(spec.format, [&] (auto format) {
+      rampSamples<decltype(format)::value>(static_cast<Byte*>(data), frames,
+                                           spec.channels, from, to, step);
+    });
+  }
+
+  void VoiceMixer::prepare(const StreamSpec& spec, size_t max_frames)
+  {
+    selectFunctions(spec);
+
+    block_.resize(max_frames * frameSize(spec));
+    block_.reinterpret(spec);
+  }
+
+  void VoiceMixer::prepare(const StreamSpec& spec, ByteBuffer& block)
+  {
+    selectFunctions(spec);
+
+    block_.swap(block);
+    block_.reinterpret(spec);
+  }
+
+  void VoiceMixer::selectFunctions(const StreamSpec& spec)
+  {
+    if (spec != spec_)
+      reset();
+
+    auto select = [this] (auto format) {
+      scale_fn_ = scaleSamples<decltype(format)::value>;
+      mix_fn_ = mixSamples<decltype(format)::value>;
+      ramp_fn_ = rampSamples<decltype(format)::value>;
+    };
+
+    if (!selectFormat(spec.format, select))
+    {
+#ifndef NDEBUG
+      std::cerr << "VoiceMixer: unable to mix (unknown sample format)" << std::endl;
+#endif
+      scale_fn_ = nullptr;
+      mix_fn_ = nullptr;
+      ramp_fn_ = nullptr;
+    }
+
+    spec_ = spec;
+
+    // slope of the master gain ramps (per frame)
+    gain_step_ = (spec.rate > 0) ? 1.0f / usecsToFrames(kGainRampTime, spec) : 1.0f;
+  }
+
+  void VoiceMixer::start(const ByteBuffer& sound, float gain)
+  {
+    collect();
+
+    // nothing audible to ramp
+    if (voices_ == 0)
+      gain_ = target_gain_;
+
+    // replace the oldest voice
+    if (voices_ == kMaxVoices)
+    {
+      std::move(voice_.begin() + 1, voice_.end(), voice_.begin());
+      --voices_;
+    }
+
+    voice_[voices_++] = {&sound, 0, gain};
+  }
+
+  bool VoiceMixer::lockMemory() const
+  {
+    return audio::lockMemory(block_);
+  }
+
+  void VoiceMixer::reset()
+  {
+    voices_ = 0;
+    gain_ = target_gain_;
+  }
+
+  void VoiceMixer::setGain(float gain)
+  {
+    target_gain_ = std::max(gain, 0.0f);
+
+    if (voices_ == 0)
+      gain_ = target_gain_;
+  }
+
+  size_t VoiceMixer::mix(size_t max_frames, const void*& data, size_t& bytes)
+  {
+    collect();
+
+    if (voices_ == 0)
+    {
+      bytes = 0;
+      return 0;
+    }
+
+    size_t frames_chunk = max_frames;
+    for (size_t v = 0; v < voices_; ++v)
+      frames_chunk = std::min(frames_chunk, remaining(voice_[v]));
+
+    const size_t frame_size = frameSize(spec_);
+
+    const bool unity_gain = gain_ == 1.0f && target_gain_ == 1.0f;
+
+    if (mix_fn_ == nullptr || (voices_ == 1 && unity_gain && voice_[0].gain == 1.0f))
+    {
+      // hand out the most recent sound without copying
+      Voice& voice = voice_[voices_ - 1];
+      data = voice.sound->data() + voice.pos * frame_size;
+    }
+    else
+    {
+      frames_chunk = std::min(frames_chunk, block_.frames());
+
+      const size_t samples = frames_chunk * spec_.channels;
+
+      // apply a constant master gain together with the voice gains
+      const bool ramping = gain_ != target_gain_;
+      const float master = ramping ? 1.0f : gain_;
+
+      scale_fn_(block_.data(), voice_[0].sound->data() + voice_[0].pos * frame_size,
+                samples, voice_[0].gain * master);
+
+      for (size_t v = 1; v < voices_; ++v)
+        mix_fn_(block_.data(), voice_[v].sound->data() + voice_[v].pos * frame_size,
+                samples, voice_[v].gain * master);
+
+      if (ramping)
+        gain_ = ramp_fn_(block_.data(), frames_chunk, spec_.channels,
+                         gain_, target_gain_, gain_step_);
+
+      data = block_.data();
+    }
+
+    bytes = frames_chunk * frame_size;
+
+    for (size_t v = 0; v < voices_; ++v)
+      voice_[v].pos += frames_chunk;
+
+    collect();
+
+    return frames_chunk;
+  }
+
+  size_t VoiceMixer::remaining(const Voice& voice) const
+  {
+    size_t frames = voice.sound->frames();
+    return (voice.pos < frames) ? frames - voice.pos : 0;
+  }
+
+  void VoiceMixer::collect()
+  {
+    auto last = std::remove_if(voice_.begin(), voice_.begin() + voices_,
+                               [this] (const Voice& v) { return remaining(v) == 0; });
+
+    voices_ = last - voice_.begin();
+  }
+
+}//namespace audio
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GMetronome_Mixer_h
+#define GMetronome_Mixer_h
+
+#include "Audio.h"
+#include "AudioBuffer.h"
+
+#include <array>
+
+namespace audio {
+
+  /**
+   * @class VoiceMixer
+   * @brief Plays overlapping sounds sample-accurately
+   *
+   * Every started sound occupies a voice until it is played completely,
+   * i.e. a sound is no longer truncated by the next one. The number of
+   * voices is bounded; if all voices are busy, the oldest one is replaced.
+   * While a single voice is active the mixer hands out the sound buffer
+   * directly, overlapping voices are summed (with saturation) into an
+   * output block that is allocated in prepare(). All other functions
+   * neither block nor allocate memory.
+   *
+   * Each voice is scaled by the gain that was passed to start() and the
+   * output by a master gain. Changes of the master gain are ramped to
+   * prevent clicks (see kGainRampTime). With unity gains the sound buffers
+   * are still handed out without copying.
+   */
+  class VoiceMixer {
+  public:
+    static constexpr size_t kMaxVoices = 4;
+
+    /** Duration of a master gain ramp from 0 to 1 (or vice versa) */
+    static constexpr microseconds kGainRampTime = 20ms;
+
+    /**
+     * @brief Prepare the mixer for a new stream specification
+     *
+     * Allocates an output block of the given size (in frames). Changing the
+     * specification stops all voices, since the sound buffers are replaced.
+     */
+    void prepare(const StreamSpec& spec, size_t max_frames);
+
+    /**
+     * @brief Prepare the mixer with an output block that was allocated in advance
+     *
+     * Same as above, but the output block is exchanged with the given buffer
+     * (without allocating memory), which receives the old block.
+     */
+    void prepare(const StreamSpec& spec, ByteBuffer& block);
+
+    /**
+     * @brief Start a new voice
+     *
+     * The buffer must remain valid while the voice is playing, but may be
+     * modified (e.g. swapped) in the meantime, if the new content is not
+     * shorter than the old one.
+     *
+     * @param sound The sound buffer
+     * @param gain  Amplitude ratio of the voice
+     */
+    void start(const ByteBuffer& sound, float gain = 1.0f);
+
+    /** Lock the output block into RAM (see audio::lockMemory). */
+    bool lockMemory() const;
+
+    /** Stop all voices. */
+    void reset();
+
+    /** Checks whether there is any voice left to play. */
+    bool active() const
+      { return voices_ > 0; }
+
+    /**
+     * @brief Set the master gain (amplitude ratio)
+     *
+     * If voices are active, the gain is ramped to the new value, otherwise
+     * the change is applied immediately.
+     */
+    void setGain(float gain);
+
+    /** The (target) master gain. */
+    float gain() const
+      { return target_gain_; }
+
+    /**
+     * @brief Produce the next chunk of the mixed voices
+     *
+     * The chunk ends at the latest with the first voice that finishes.
+     * It remains valid until the next call to a non-const member function
+     * or to a function that modifies one of the sound buffers.
+     *
+     * @return The number of frames in the chunk
+     */
+    size_t mix(size_t max_frames, const void*& data, size_t& bytes);
+
+  private:
+    // out = in * gain
+    using ScaleFunction = void (*)(Byte* out, const Byte* in, size_t samples, float gain);
+    // out = out + in * gain
+    using MixFunction = void (*)(Byte* out, const Byte* in, size_t samples, float gain);
+    // ramps the gain frame by frame and returns the final gain
+    using RampFunction = float (*)(Byte* data, size_t frames, size_t channels,
+                                   float gain, float target, float step);
+
+    struct Voice
+    {
+      const ByteBuffer* sound {nullptr};
+      size_t pos {0};
+      float gain {1.0f};
+    };
+
+    StreamSpec spec_ {kDefaultSpec};
+    ByteBuffer block_;
+    std::array<Voice, kMaxVoices> voice_;
+    size_t voices_ {0};
+    float gain_ {1.0f};
+    float target_gain_ {1.0f};
+    float gain_step_ {1.0f};
+    ScaleFunction scale_fn_ {nullptr};
+    MixFunction mix_fn_ {nullptr};
+    RampFunction ramp_fn_ {nullptr};
+
+    size_t remaining(const Voice& voice) const;
+    void collect();
+    void selectFunctions(const StreamSpec& spec);
+  };
+
+  /**
+   * @brief Apply a linear gain ramp to a block of audio data (in place)
+   *
+   * The gain changes frame by frame from one amplitude ratio to the other,
+   * e.g. to fade out the tail of a stream.
+   *
+   * @return false if the sample format is unknown, true otherwise
+   */
+  bool rampGain(void* data, size_t frames, const StreamSpec& spec, float from, float to);
+
+}//namespace audio
+#endif//GMetronome_Mixer_h
@@ -125,17 +125,20 @@ namespace audio {
     : state_(BackendState::kConfig),
       in_cfg_(kOssDefaultConfig),
       out_cfg_(kOssDefaultConfig),
-      fd_(-1)
+      fd_(-1),
+      xruns_(0)
   {}
 
   OssBackend::OssBackend(OssBackend&& backend) noexcept
     : state_ {backend.state_},
       in_cfg_ {std::move(backend.in_cfg_)},
       out_cfg_ {std::move(backend.out_cfg_)},
-      fd_ {backend.fd_}
+      fd_ {backend.fd_},
+      xruns_ {backend.xruns_}
   {
     backend.state_ = BackendState::kConfig;
     backend.fd_ = -1;
+    backend.xruns_ = 0;
   }
 
   OssBackend::~OssBackend()
@@ -169,6 +172,7 @@ namespace audio {
     in_cfg_ = std::move(backend.in_cfg_);
     out_cfg_ = std::move(backend.out_cfg_);
     fd_ = std::exchange(backend.fd_, -1);
+    xruns_ = std::exchange(backend.xruns_, 0);
 
     return *this;
   }
@@ -189,6 +193,7 @@ namespace audio {
   {
     assert(state_ == BackendState::kConfig);
     openAndConfigureDevice(); // updates out_cfg_
+    xruns_ = 0;
     state_ = BackendState::kOpen;
     return out_cfg_;
   }
@@ -219,17 +224,26 @@ namespace audio {
     state_ = BackendState::kOpen;
   }
 
-  void OssBackend::write(const void* data, size_t bytes)
+  size_t OssBackend::write(const void* data, size_t bytes)
   {
     assert(state_ == BackendState::kRunning);
     if (::write (fd_, data, bytes) != (ssize_t) bytes)
       throw OssError(state_, "write failed", errno);
+
+    return bytes;
   }
 
   void OssBackend::flush()
   {
     assert(state_ == BackendState::kRunning);
-    // not implemented yet
+
+    // discard the queued data (the device accepts new data afterwards)
+#ifdef SNDCTL_DSP_HALT_OUTPUT
+    if (ioctl(fd_, SNDCTL_DSP_HALT_OUTPUT, nullptr) == -1)
+#else
+    if (ioctl(fd_, SNDCTL_DSP_RESET, nullptr) == -1)
+#endif
+      throw OssError(state_, "failed to flush device", errno);
   }
 
   void OssBackend::drain()
@@ -252,6 +266,17 @@ namespace audio {
     return r;
   }
 
+  std::uint64_t OssBackend::xruns() const
+  {
+#ifdef SNDCTL_DSP_GETERROR
+    // the driver resets the error counters on every request
+    audio_errinfo info;
+    if (fd_ >= 0 && ioctl(fd_, SNDCTL_DSP_GETERROR, &info) != -1)
+      xruns_ += info.play_underruns;
+#endif
+    return xruns_;
+  }
+
   BackendState OssBackend::state() const
   {
     return state_;
@@ -289,8 +314,15 @@ namespace audio {
     //
     // set buffer size
     //
-    int max_fragments = 16;
-    int size_selector = 8;
+    const auto& latency = latencyParameters(in_cfg_.latency);
+
+    // fragment size is selected by its binary logarithm
+    size_t fragment_bytes = usecsToBytes(latency.period, in_cfg_.spec);
+    int size_selector = 4;
+    while (size_selector < 16 && (size_t(1) << size_selector) < fragment_bytes)
+      ++size_selector;
+
+    int max_fragments = std::clamp(int(latency.buffer / latency.period), 2, 16);
     int frag = (max_fragments << 16) | (size_selector);
 
     if (ioctl(fd_, SNDCTL_DSP_SETFRAGMENT, &frag) == -1)
@@ -328,6 +360,8 @@ namespace audio {
       throw OssError(state_, "failed to set sample rate", errno);
 
     out_cfg_.spec.rate = speed;
+
+    out_cfg_.latency = in_cfg_.latency;
   }
 
   void OssBackend::openAndConfigureDevice()
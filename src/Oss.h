@@ -46,10 +46,11 @@ namespace audio {
     void close() override;
     void start() override;
     void stop() override;
-    void write(const void* data, size_t bytes) override;
+    size_t write(const void* data, size_t bytes) override;
     void flush() override;
     void drain() override;
     microseconds latency() override;
+    std::uint64_t xruns() const override;
     BackendState state() const override;
 
   private:
@@ -57,6 +58,7 @@ namespace audio {
     audio::DeviceConfig in_cfg_;
     audio::DeviceConfig out_cfg_;
     int fd_;
+    mutable std::uint64_t xruns_;
 
     void openDevice();
     void closeDevice();
@@ -21,7 +21,7 @@
 #define GMetronome_ProfileIOLocalXml_h
 
 #include "ProfileIOBase.h"
-#include <gtkmm.h>
+#include <giomm.h>
 #include <map>
 
 class ProfileIOLocalXml : public ProfileIOBase
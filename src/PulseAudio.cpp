@@ -22,6 +22,7 @@
 #endif
 
 #include "PulseAudio.h"
+#include <algorithm>
 #include <cassert>
 #include <utility>
 
@@ -133,7 +134,26 @@ namespace audio {
       (uint32_t) -1  // fragsize
     };
 
-    std::chrono::duration<double> kPAMaxBufferDuration = 90ms;
+    // request the latency of the buffer attributes and keep the timing
+    // information up to date without blocking roundtrips to the server
+    constexpr pa_stream_flags_t kStreamFlags = static_cast<pa_stream_flags_t>(
+      PA_STREAM_ADJUST_LATENCY
+      | PA_STREAM_AUTO_TIMING_UPDATE
+      | PA_STREAM_INTERPOLATE_TIMING
+      | PA_STREAM_START_CORKED);
+
+    // scoped lock of a threaded mainloop
+    class MainloopLock {
+    public:
+      explicit MainloopLock(pa_threaded_mainloop* mainloop) : mainloop_{mainloop}
+        { pa_threaded_mainloop_lock(mainloop_); }
+      ~MainloopLock()
+        { pa_threaded_mainloop_unlock(mainloop_); }
+      MainloopLock(const MainloopLock&) = delete;
+      MainloopLock& operator=(const MainloopLock&) = delete;
+    private:
+      pa_threaded_mainloop* mainloop_;
+    };
 
   }//unnamed namespace
 
@@ -143,26 +163,32 @@ namespace audio {
       cfg_ {kDefaultConfig},
       pa_spec_ {kPADefaultSpec},
       pa_buffer_attr_ {kPADefaultBufferAttr},
-      pa_simple_ {nullptr}
+      pa_mainloop_ {nullptr},
+      pa_context_ {nullptr},
+      pa_stream_ {nullptr},
+      wakeup_ {false},
+      streaming_ {false},
+      underflows_ {0}
   {}
 
   PulseAudioBackend::PulseAudioBackend(PulseAudioBackend&& backend) noexcept
-    : state_ { std::move(backend.state_) },
+    : state_ { std::exchange(backend.state_, BackendState::kConfig) },
       cfg_ { std::move(backend.cfg_) },
-      pa_spec_ { std::move(backend.pa_spec_) },
-      pa_buffer_attr_ { std::move(backend.pa_buffer_attr_) },
-      pa_simple_ { std::move(backend.pa_simple_) }
+      pa_spec_ { std::exchange(backend.pa_spec_, kPADefaultSpec) },
+      pa_buffer_attr_ { std::exchange(backend.pa_buffer_attr_, kPADefaultBufferAttr) },
+      pa_mainloop_ { std::exchange(backend.pa_mainloop_, nullptr) },
+      pa_context_ { std::exchange(backend.pa_context_, nullptr) },
+      pa_stream_ { std::exchange(backend.pa_stream_, nullptr) },
+      wakeup_ { std::exchange(backend.wakeup_, false) },
+      streaming_ { std::exchange(backend.streaming_, false) },
+      underflows_ { backend.underflows_.exchange(0) }
   {
-    backend.state_ = BackendState::kConfig;
-    backend.pa_spec_ = kPADefaultSpec;
-    backend.pa_buffer_attr_ = kPADefaultBufferAttr;
-    backend.pa_simple_ = nullptr;
+    installCallbacks();
   }
 
   PulseAudioBackend::~PulseAudioBackend()
   {
-    if (pa_simple_)
-      pa_simple_free(pa_simple_);
+    disconnect();
   }
 
   PulseAudioBackend& PulseAudioBackend::operator=(PulseAudioBackend&& backend) noexcept
@@ -170,6 +196,8 @@ namespace audio {
     if (this == &backend)
       return *this;
 
+    disconnect();
+
     state_ = std::exchange(backend.state_, BackendState::kConfig);
 
     cfg_ = std::move(backend.cfg_);
@@ -178,10 +206,16 @@ namespace audio {
 
     pa_buffer_attr_ = std::exchange(backend.pa_buffer_attr_, kPADefaultBufferAttr);
 
-    if (pa_simple_)
-      pa_simple_free(pa_simple_);
+    pa_mainloop_ = std::exchange(backend.pa_mainloop_, nullptr);
+    pa_context_ = std::exchange(backend.pa_context_, nullptr);
+    pa_stream_ = std::exchange(backend.pa_stream_, nullptr);
+
+    wakeup_ = std::exchange(backend.wakeup_, false);
+    streaming_ = std::exchange(backend.streaming_, false);
+    underflows_ = backend.underflows_.exchange(0);
 
-    pa_simple_ = std::exchange(backend.pa_simple_, nullptr);
+    // the callbacks refer to the moved object
+    installCallbacks();
 
     return *this;
   }
@@ -206,21 +240,52 @@ namespace audio {
 
     pa_spec_ = specToPA(cfg_.spec);
 
+    if (!pa_sample_spec_valid(&pa_spec_))
+      throw PulseaudioError(state_, "invalid sample specification");
+
+    // the target length of the server side buffer determines the latency,
+    // the minimum request size corresponds to the period size of a device
+    const auto& latency = latencyParameters(cfg_.latency);
+
     pa_buffer_attr_ = kPADefaultBufferAttr;
-    pa_buffer_attr_.maxlength =
-      pa_bytes_per_second(&pa_spec_) * kPAMaxBufferDuration.count();
+    pa_buffer_attr_.tlength = pa_usec_to_bytes(latency.buffer.count(), &pa_spec_);
+    pa_buffer_attr_.minreq = pa_usec_to_bytes(latency.period.count(), &pa_spec_);
+    pa_buffer_attr_.maxlength = pa_buffer_attr_.tlength;
 
+    try {
+      connectContext();
+      connectStream();
+    }
+    catch(...)
+    {
+      disconnect();
+      throw;
+    }
+
+    underflows_ = 0;
     state_ = BackendState::kOpen;
 
     DeviceConfig actual_cfg = cfg_;
     actual_cfg.spec = specFromPA(pa_spec_);
 
+    // the server might have adjusted the buffer attributes
+    const size_t frame_size = pa_frame_size(&pa_spec_);
+    actual_cfg.period_frames = pa_buffer_attr_.minreq / frame_size;
+    actual_cfg.buffer_frames = pa_buffer_attr_.tlength / frame_size;
+
+#ifndef NDEBUG
+    std::cerr << "PulseAudioBackend: buffer attributes (tlength: "
+              << pa_bytes_to_usec(pa_buffer_attr_.tlength, &pa_spec_) << "us, minreq: "
+              << pa_bytes_to_usec(pa_buffer_attr_.minreq, &pa_spec_) << "us)" << std::endl;
+#endif
+
     return actual_cfg;
   }
 
   void PulseAudioBackend::close()
   {
     assert(state_ == BackendState::kOpen);
+    disconnect();
     state_ = BackendState::kConfig;
   }
 
@@ -228,20 +293,14 @@ namespace audio {
   {
     assert(state_ == BackendState::kOpen);
 
-    const char* dev = cfg_.name.empty() ? NULL : cfg_.name.c_str() ;
-
-    int error;
-    pa_simple_ = pa_simple_new( NULL,
-                                PACKAGE_NAME,
-                                PA_STREAM_PLAYBACK,
-                                dev,
-                                "playback",
-                                &pa_spec_,
-                                NULL,
-                                &pa_buffer_attr_,
-                                &error);
-    if (!pa_simple_)
-      throw PulseaudioError(state_, error);
+    MainloopLock lock(pa_mainloop_);
+
+    // discard wakeups of the previous run
+    wakeup_ = false;
+    streaming_ = true;
+
+    // the playback starts as soon as the server side buffer is filled (prebuf)
+    waitForOperation(pa_stream_cork(pa_stream_, 0, &streamSuccessCallback, this));
 
     state_ = BackendState::kRunning;
   }
@@ -250,61 +309,297 @@ namespace audio {
   {
     assert(state_ == BackendState::kRunning);
 
-    if (pa_simple_)
+    MainloopLock lock(pa_mainloop_);
+
+    // the stream runs empty after draining (no underflow)
+    streaming_ = false;
+
+    try {
+      waitForOperation(pa_stream_drain(pa_stream_, &streamSuccessCallback, this));
+    }
+    catch(...)
     {
-      int error;
-      if (pa_simple_drain(pa_simple_, &error) < 0)
-      {
 #ifndef NDEBUG
-        std::cerr << "PulseBackend: draining failed but will continue to stop the backend"
-                  << std::endl;
+      std::cerr << "PulseBackend: draining failed but will continue to stop the backend"
+                << std::endl;
 #endif
-      }
-      pa_simple_free(pa_simple_);
-      pa_simple_ = nullptr;
     }
 
+    waitForOperation(pa_stream_cork(pa_stream_, 1, &streamSuccessCallback, this));
+
     state_ = BackendState::kOpen;
   }
 
-  void PulseAudioBackend::write(const void* data, size_t bytes)
+  size_t PulseAudioBackend::write(const void* data, size_t bytes)
   {
-    int error;
-    if (pa_simple_write(pa_simple_, data, bytes, &error) < 0)
-      throw PulseaudioError(state_, error);
+    assert(state_ == BackendState::kRunning);
+
+    MainloopLock lock(pa_mainloop_);
+
+    const char* ptr = static_cast<const char*>(data);
+    const size_t bytes_total = bytes;
+
+    while (bytes > 0 && !wakeup_)
+    {
+      if (!PA_STREAM_IS_GOOD(pa_stream_get_state(pa_stream_)))
+        throwContextError("stream failed");
+
+      size_t writable = pa_stream_writable_size(pa_stream_);
+      if (writable == (size_t) -1)
+        throwContextError("failed to get writable size");
+
+      if (writable == 0)
+      {
+        // woken up by the request callback or by wakeup()
+        pa_threaded_mainloop_wait(pa_mainloop_);
+        continue;
+      }
+
+      size_t chunk = std::min(writable, bytes);
+
+      if (pa_stream_write(pa_stream_, ptr, chunk, nullptr, 0, PA_SEEK_RELATIVE) < 0)
+        throwContextError("failed to write");
+
+      ptr += chunk;
+      bytes -= chunk;
+    }
+
+    return bytes_total - bytes;
   }
 
   void PulseAudioBackend::flush()
   {
-    int error;
-    if (pa_simple_flush(pa_simple_, &error) < 0)
-      throw PulseaudioError(state_, error);
+    assert(state_ == BackendState::kRunning);
+
+    MainloopLock lock(pa_mainloop_);
+    waitForOperation(pa_stream_flush(pa_stream_, &streamSuccessCallback, this));
+
+    wakeup_ = false;
   }
 
   void PulseAudioBackend::drain()
   {
-    int error;
-    if (pa_simple_drain(pa_simple_, &error) < 0)
-      throw PulseaudioError(state_, error);
+    assert(state_ == BackendState::kRunning);
+
+    MainloopLock lock(pa_mainloop_);
+    waitForOperation(pa_stream_drain(pa_stream_, &streamSuccessCallback, this));
   }
 
   microseconds PulseAudioBackend::latency()
   {
-    if ( ! pa_simple_ )
+    if (!pa_stream_)
       return 0us;
 
-    int error;
-    uint64_t latency = pa_simple_get_latency(pa_simple_, &error);
+    MainloopLock lock(pa_mainloop_);
+
+    pa_usec_t latency = 0;
+    int negative = 0;
+
+    // fails with PA_ERR_NODATA until the first timing update arrived
+    if (pa_stream_get_latency(pa_stream_, &latency, &negative) < 0 || negative)
+      return 0us;
 
-    if (error != PA_OK) {
-      // throw BackendError( pa_strerror(error) );
-    }
     return microseconds(latency);
   }
 
+  microseconds PulseAudioBackend::position()
+  {
+    if (!pa_stream_)
+      return 0us;
+
+    MainloopLock lock(pa_mainloop_);
+
+    pa_usec_t time = 0;
+    if (pa_stream_get_time(pa_stream_, &time) < 0)
+      return 0us;
+
+    return microseconds(time);
+  }
+
+  std::uint64_t PulseAudioBackend::xruns() const
+  {
+    return underflows_.load(std::memory_order_relaxed);
+  }
+
+  void PulseAudioBackend::wakeup()
+  {
+    if (!pa_mainloop_)
+      return;
+
+    MainloopLock lock(pa_mainloop_);
+    wakeup_ = true;
+    pa_threaded_mainloop_signal(pa_mainloop_, 0);
+  }
+
   BackendState PulseAudioBackend::state() const
   {
     return state_;
   }
 
+  void PulseAudioBackend::connectContext()
+  {
+    pa_mainloop_ = pa_threaded_mainloop_new();
+    if (!pa_mainloop_)
+      throw PulseaudioError(state_, "failed to create mainloop");
+
+    pa_context_ = pa_context_new(pa_threaded_mainloop_get_api(pa_mainloop_), PACKAGE_NAME);
+    if (!pa_context_)
+      throw PulseaudioError(state_, "failed to create context");
+
+    pa_context_set_state_callback(pa_context_, &contextStateCallback, this);
+
+    if (pa_context_connect(pa_context_, nullptr, PA_CONTEXT_NOFLAGS, nullptr) < 0)
+      throwContextError("failed to connect to the server");
+
+    if (pa_threaded_mainloop_start(pa_mainloop_) < 0)
+      throw PulseaudioError(state_, "failed to start mainloop");
+
+    MainloopLock lock(pa_mainloop_);
+
+    pa_context_state_t context_state;
+    while ((context_state = pa_context_get_state(pa_context_)) != PA_CONTEXT_READY)
+    {
+      if (!PA_CONTEXT_IS_GOOD(context_state))
+        throwContextError("failed to connect to the server");
+
+      pa_threaded_mainloop_wait(pa_mainloop_);
+    }
+  }
+
+  void PulseAudioBackend::connectStream()
+  {
+    MainloopLock lock(pa_mainloop_);
+
+    pa_stream_ = pa_stream_new(pa_context_, "playback", &pa_spec_, nullptr);
+    if (!pa_stream_)
+      throwContextError("failed to create stream");
+
+    pa_stream_set_state_callback(pa_stream_, &streamStateCallback, this);
+    pa_stream_set_write_callback(pa_stream_, &streamRequestCallback, this);
+    pa_stream_set_underflow_callback(pa_stream_, &streamUnderflowCallback, this);
+
+    const char* dev = cfg_.name.empty() ? nullptr : cfg_.name.c_str();
+
+    if (pa_stream_connect_playback(pa_stream_, dev, &pa_buffer_attr_,
+                                   kStreamFlags, nullptr, nullptr) < 0)
+      throwContextError("failed to connect stream");
+
+    pa_stream_state_t stream_state;
+    while ((stream_state = pa_stream_get_state(pa_stream_)) != PA_STREAM_READY)
+    {
+      if (!PA_STREAM_IS_GOOD(stream_state))
+        throwContextError("failed to connect stream");
+
+      pa_threaded_mainloop_wait(pa_mainloop_);
+    }
+
+    if (const pa_buffer_attr* attr = pa_stream_get_buffer_attr(pa_stream_); attr)
+      pa_buffer_attr_ = *attr;
+  }
+
+  void PulseAudioBackend::disconnect() noexcept
+  {
+    // stop the mainloop thread first, afterwards the objects can be
+    // released without locking
+    if (pa_mainloop_)
+      pa_threaded_mainloop_stop(pa_mainloop_);
+
+    if (pa_stream_)
+    {
+      pa_stream_disconnect(pa_stream_);
+      pa_stream_unref(pa_stream_);
+      pa_stream_ = nullptr;
+    }
+
+    if (pa_context_)
+    {
+      pa_context_disconnect(pa_context_);
+      pa_context_unref(pa_context_);
+      pa_context_ = nullptr;
+    }
+
+    if (pa_mainloop_)
+    {
+      pa_threaded_mainloop_free(pa_mainloop_);
+      pa_mainloop_ = nullptr;
+    }
+  }
+
+  void PulseAudioBackend::installCallbacks() noexcept
+  {
+    if (!pa_mainloop_)
+      return;
+
+    MainloopLock lock(pa_mainloop_);
+
+    if (pa_context_)
+      pa_context_set_state_callback(pa_context_, &contextStateCallback, this);
+
+    if (pa_stream_)
+    {
+      pa_stream_set_state_callback(pa_stream_, &streamStateCallback, this);
+      pa_stream_set_write_callback(pa_stream_, &streamRequestCallback, this);
+      pa_stream_set_underflow_callback(pa_stream_, &streamUnderflowCallback, this);
+    }
+  }
+
+  // expects the mainloop to be locked
+  void PulseAudioBackend::waitForOperation(pa_operation* op)
+  {
+    if (!op)
+      throwContextError("operation failed");
+
+    while (pa_operation_get_state(op) == PA_OPERATION_RUNNING)
+      pa_threaded_mainloop_wait(pa_mainloop_);
+
+    bool done = pa_operation_get_state(op) == PA_OPERATION_DONE;
+
+    pa_operation_unref(op);
+
+    if (!done)
+      throwContextError("operation cancelled");
+  }
+
+  void PulseAudioBackend::throwContextError(const char* what)
+  {
+    int error = pa_context_ ? pa_context_errno(pa_context_) : PA_ERR_UNKNOWN;
+
+    std::string msg = std::string(what) + " (" + pa_strerror(error) + ")";
+#ifndef NDEBUG
+    std::cerr << "PulseAudioBackend: " << msg << std::endl;
+#endif
+    throw PulseaudioError(state_, msg.c_str());
+  }
+
+  void PulseAudioBackend::contextStateCallback(pa_context* context, void* userdata)
+  {
+    auto backend = static_cast<PulseAudioBackend*>(userdata);
+    pa_threaded_mainloop_signal(backend->pa_mainloop_, 0);
+  }
+
+  void PulseAudioBackend::streamStateCallback(pa_stream* stream, void* userdata)
+  {
+    auto backend = static_cast<PulseAudioBackend*>(userdata);
+    pa_threaded_mainloop_signal(backend->pa_mainloop_, 0);
+  }
+
+  void PulseAudioBackend::streamRequestCallback(pa_stream* stream, size_t bytes, void* userdata)
+  {
+    auto backend = static_cast<PulseAudioBackend*>(userdata);
+    pa_threaded_mainloop_signal(backend->pa_mainloop_, 0);
+  }
+
+  void PulseAudioBackend::streamUnderflowCallback(pa_stream* stream, void* userdata)
+  {
+    auto backend = static_cast<PulseAudioBackend*>(userdata);
+    if (backend->streaming_)
+      backend->underflows_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void PulseAudioBackend::streamSuccessCallback(pa_stream* stream, int success, void* userdata)
+  {
+    auto backend = static_cast<PulseAudioBackend*>(userdata);
+    pa_threaded_mainloop_signal(backend->pa_mainloop_, 0);
+  }
+
 }//namespace audio
@@ -21,15 +21,21 @@
 #define GMetronome_PulseAudio_h
 
 #include "AudioBackend.h"
+#include <atomic>
 #include <memory>
-#include <pulse/sample.h>
-#include <pulse/simple.h>
-#include <pulse/error.h>
+#include <pulse/pulseaudio.h>
 
 namespace audio {
 
   /**
-   * PulseAudio Backend
+   * @class PulseAudioBackend
+   * @brief PulseAudio Backend
+   *
+   * The backend uses the asynchronous API of PulseAudio with a threaded
+   * mainloop. The playback stream requests the latency of the latency
+   * profile (PA_STREAM_ADJUST_LATENCY) and the timing information of the
+   * stream is updated and interpolated automatically, i.e. latency() and
+   * position() do not block on a server roundtrip.
    */
   class PulseAudioBackend : public Backend
   {
@@ -49,10 +55,13 @@ namespace audio {
     void close() override;
     void start() override;
     void stop() override;
-    void write(const void* data, size_t bytes) override;
+    size_t write(const void* data, size_t bytes) override;
     void flush() override;
     void drain() override;
     microseconds latency() override;
+    microseconds position() override;
+    std::uint64_t xruns() const override;
+    void wakeup() override;
     BackendState state() const override;
 
   private:
@@ -60,8 +69,26 @@ namespace audio {
     audio::DeviceConfig cfg_;
     pa_sample_spec pa_spec_;
     pa_buffer_attr pa_buffer_attr_;
-    pa_simple*     pa_simple_;
-};
+    pa_threaded_mainloop* pa_mainloop_;
+    pa_context* pa_context_;
+    pa_stream* pa_stream_;
+    bool wakeup_;    // protected by the mainloop lock
+    bool streaming_; // protected by the mainloop lock
+    std::atomic<std::uint64_t> underflows_;
+
+    void connectContext();
+    void connectStream();
+    void disconnect() noexcept;
+    void installCallbacks() noexcept;
+    void waitForOperation(pa_operation* op);
+    [[noreturn]] void throwContextError(const char* what = "");
+
+    static void contextStateCallback(pa_context* context, void* userdata);
+    static void streamStateCallback(pa_stream* stream, void* userdata);
+    static void streamRequestCallback(pa_stream* stream, size_t bytes, void* userdata);
+    static void streamUnderflowCallback(pa_stream* stream, void* userdata);
+    static void streamSuccessCallback(pa_stream* stream, int success, void* userdata);
+  };
 
 }//namespace audio
 #endif//GMetronome_PulseAudio_h
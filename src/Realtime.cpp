@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "Realtime.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__SSE__)
+# include <xmmintrin.h>
+#endif
+
+namespace audio {
+
+  namespace {
+
+#if defined(__x86_64__) || defined(__SSE__)
+# define GMETRONOME_DENORMAL_MODE 1
+
+    // MXCSR: flush-to-zero (bit 15) and denormals-are-zero (bit 6)
+    constexpr std::uintptr_t kDenormalBits = 0x8040;
+
+    std::uintptr_t getFloatMode()
+    { return _mm_getcsr(); }
+
+    void setFloatMode(std::uintptr_t mode)
+    { _mm_setcsr(static_cast<unsigned int>(mode)); }
+
+#elif defined(__aarch64__)
+# define GMETRONOME_DENORMAL_MODE 1
+
+    // FPCR: flush-to-zero (bit 24), which covers inputs and outputs
+    constexpr std::uintptr_t kDenormalBits = std::uintptr_t(1) << 24;
+
+    std::uintptr_t getFloatMode()
+    {
+      std::uint64_t fpcr;
+      asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+      return fpcr;
+    }
+
+    void setFloatMode(std::uintptr_t mode)
+    {
+      std::uint64_t fpcr = mode;
+      asm volatile("msr fpcr, %0" : : "r"(fpcr));
+    }
+
+#endif
+
+  }//unnamed namespace
+
+  RealtimePolicy makeThreadRealtime(int priority)
+  {
+    const std::array<std::pair<RealtimePolicy, int>, 2> policies = {{
+        {RealtimePolicy::kFifo, SCHED_FIFO},
+        {RealtimePolicy::kRoundRobin, SCHED_RR}
+      }};
+
+    for (const auto& [policy, sched_policy] : policies)
+    {
+      sched_param param {};
+      param.sched_priority = std::clamp(priority,
+                                        sched_get_priority_min(sched_policy),
+                                        sched_get_priority_max(sched_policy));
+
+      if (pthread_setschedparam(pthread_self(), sched_policy, &param) == 0)
+        return policy;
+    }
+    return RealtimePolicy::kNone;
+  }
+
+  void makeThreadNormal()
+  {
+    sched_param param {};
+    param.sched_priority = 0;
+
+    pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+  }
+
+  bool lockMemory(const void* data, std::size_t bytes)
+  {
+    if (data == nullptr || bytes == 0)
+      return true;
+
+    // some systems require page aligned addresses
+    static const std::uintptr_t page_size = sysconf(_SC_PAGESIZE);
+
+    std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(data);
+    std::uintptr_t aligned = begin - begin % page_size;
+
+    return mlock(reinterpret_cast<const void*>(aligned), bytes + (begin - aligned)) == 0;
+  }
+
+  // not inlined to place the touched stack below the frame of the caller
+  __attribute__((noinline)) bool lockStack()
+  {
+    volatile unsigned char stack[kRealtimeStackSize];
+
+    // write to every byte to map the pages of the stack
+    for (std::size_t n = 0; n < kRealtimeStackSize; ++n)
+      stack[n] = 0;
+
+    return lockMemory(const_cast<unsigned char*>(stack), kRealtimeStackSize);
+  }
+
+  void unlockMemory()
+  { munlockall(); }
+
+  bool flushDenormals(bool enable)
+  {
+#ifdef GMETRONOME_DENORMAL_MODE
+    std::uintptr_t mode = getFloatMode();
+
+    if (enable)
+      setFloatMode(mode | kDenormalBits);
+    else
+      setFloatMode(mode & ~kDenormalBits);
+
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  DenormalGuard::DenormalGuard(bool enable) noexcept
+  {
+#ifdef GMETRONOME_DENORMAL_MODE
+    if (enable)
+    {
+      mode_ = getFloatMode();
+      restore_ = true;
+      setFloatMode(mode_ | kDenormalBits);
+    }
+#endif
+  }
+
+  DenormalGuard::~DenormalGuard()
+  {
+#ifdef GMETRONOME_DENORMAL_MODE
+    if (restore_)
+      setFloatMode(mode_);
+#endif
+  }
+
+}//namespace audio
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GMetronome_Realtime_h
+#define GMetronome_Realtime_h
+
+#include "AudioBuffer.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace audio {
+
+  /** Scheduling policy of a thread */
+  enum class RealtimePolicy
+  {
+    kNone        = 0,  //!< default time-sharing scheduling
+    kFifo        = 1,  //!< SCHED_FIFO
+    kRoundRobin  = 2   //!< SCHED_RR
+  };
+
+  /** Privileges that were actually granted in real-time mode */
+  struct RealtimeStatus
+  {
+    bool            enabled {false};          //!< real-time mode requested
+    RealtimePolicy  policy {RealtimePolicy::kNone};
+    int             priority {0};
+    bool            rtkit {false};            //!< scheduling granted by RealtimeKit
+    bool            memory_locked {false};    //!< working set locked into RAM
+    bool            flush_denormals {false};  //!< FTZ/DAZ enabled
+  };
+
+  /** Default real-time priority of the audio thread */
+  constexpr int kDefaultRealtimePriority = 20;
+
+  /** Amount of stack that is pre-faulted and locked for the audio thread */
+  constexpr std::size_t kRealtimeStackSize = 256 * 1024;
+
+  /**
+   * @brief Switch the calling thread to real-time scheduling
+   *
+   * Tries SCHED_FIFO and SCHED_RR (in this order) with the given priority,
+   * which is clamped to the range of the policy. This requires the
+   * capability CAP_SYS_NICE or a sufficient RLIMIT_RTPRIO.
+   *
+   * @return The granted policy (kNone on failure)
+   */
+  RealtimePolicy makeThreadRealtime(int priority = kDefaultRealtimePriority);
+
+  /** Switch the calling thread back to time-sharing scheduling. */
+  void makeThreadNormal();
+
+  /**
+   * @brief Lock a memory range into RAM
+   *
+   * The pages are pre-faulted, i.e. accessing the memory afterwards does
+   * not cause page faults. Fails if the process exceeds RLIMIT_MEMLOCK.
+   */
+  bool lockMemory(const void* data, std::size_t bytes);
+
+  /** Lock the data of a buffer into RAM. */
+  inline bool lockMemory(const ByteBuffer& buffer)
+    { return lockMemory(buffer.data(), buffer.size()); }
+
+  /** Pre-fault and lock kRealtimeStackSize bytes of the stack of the calling thread. */
+  bool lockStack();
+
+  /** Unlock all memory that was locked by the process. */
+  void unlockMemory();
+
+  /**
+   * @brief Flush denormal floats to zero on the calling thread
+   *
+   * Enables (or disables) the flush-to-zero and denormals-are-zero modes
+   * of the floating-point unit. Denormals occur in decaying filters and
+   * are processed very slowly by most CPUs.
+   *
+   * @return False if the modes are not supported by the platform
+   */
+  bool flushDenormals(bool enable);
+
+  /**
+   * @class DenormalGuard
+   * @brief Flushes denormal floats to zero within a scope
+   *
+   * Restores the previous floating-point mode on destruction.
+   */
+  class DenormalGuard {
+  public:
+    explicit DenormalGuard(bool enable = true) noexcept;
+    ~DenormalGuard();
+
+    DenormalGuard(const DenormalGuard&) = delete;
+    DenormalGuard& operator=(const DenormalGuard&) = delete;
+
+  private:
+    std::uintptr_t mode_ {0};
+    bool restore_ {false};
+  };
+
+}//namespace audio
+#endif//GMetronome_Realtime_h
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "RealtimeKit.h"
+
+#ifdef __linux__
+# include <gio/gio.h>
+# include <sys/resource.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+# include <algorithm>
+#endif
+
+#ifndef NDEBUG
+# include <iostream>
+#endif
+
+namespace audio {
+
+#ifdef __linux__
+
+  namespace {
+
+    constexpr const char* kServiceName   = "org.freedesktop.RealtimeKit1";
+    constexpr const char* kObjectPath    = "/org/freedesktop/RealtimeKit1";
+    constexpr const char* kInterfaceName = "org.freedesktop.RealtimeKit1";
+
+    // timeout of D-Bus calls in milliseconds
+    constexpr gint kCallTimeout = 1000;
+
+    void reportError(const char* what, GError* error)
+    {
+#ifndef NDEBUG
+      std::cerr << "RealtimeKit: " << what << " ("
+                << (error ? error->message : "unknown error") << ")" << std::endl;
+#endif
+      if (error)
+        g_error_free(error);
+    }
+
+    // reads an integer property of the service
+    bool getProperty(GDBusConnection* connection, const char* name, gint64& value)
+    {
+      GError* error = nullptr;
+      GVariant* reply = g_dbus_connection_call_sync(connection,
+                                                    kServiceName,
+                                                    kObjectPath,
+                                                    "org.freedesktop.DBus.Properties",
+                                                    "Get",
+                                                    g_variant_new("(ss)", kInterfaceName, name),
+                                                    G_VARIANT_TYPE("(v)"),
+                                                    G_DBUS_CALL_FLAGS_NONE,
+                                                    kCallTimeout,
+                                                    nullptr,
+                                                    &error);
+      if (reply == nullptr)
+      {
+        reportError("failed to read service property", error);
+        return false;
+      }
+
+      GVariant* variant = nullptr;
+      g_variant_get(reply, "(v)", &variant);
+
+      bool success = true;
+      if (g_variant_is_of_type(variant, G_VARIANT_TYPE_INT32))
+        value = g_variant_get_int32(variant);
+      else if (g_variant_is_of_type(variant, G_VARIANT_TYPE_INT64))
+        value = g_variant_get_int64(variant);
+      else
+        success = false;
+
+      g_variant_unref(variant);
+      g_variant_unref(reply);
+
+      return success;
+    }
+
+    // RealtimeKit only serves processes with a limited real-time CPU time
+    bool limitRealtimeCpuTime(gint64 max_usecs)
+    {
+      rlimit limit {};
+      if (getrlimit(RLIMIT_RTTIME, &limit) != 0)
+        return false;
+
+      if (limit.rlim_max != RLIM_INFINITY && limit.rlim_max <= rlim_t(max_usecs))
+        return true;
+
+      limit.rlim_cur = limit.rlim_max = max_usecs;
+
+      return setrlimit(RLIMIT_RTTIME, &limit) == 0;
+    }
+
+  }//unnamed namespace
+
+  bool requestRealtimeKit(int& priority)
+  {
+    GError* error = nullptr;
+    GDBusConnection* connection = g_bus_get_sync(G_BUS_TYPE_SYSTEM, nullptr, &error);
+    if (connection == nullptr)
+    {
+      reportError("failed to connect to the system bus", error);
+      return false;
+    }
+
+    bool granted = false;
+    gint64 max_priority = 0;
+    gint64 max_rttime = 0;
+
+    if (getProperty(connection, "MaxRealtimePriority", max_priority)
+        && getProperty(connection, "RTTimeUSecMax", max_rttime)
+        && max_priority > 0
+        && limitRealtimeCpuTime(max_rttime))
+    {
+      const guint32 thread_priority = std::clamp<gint64>(priority, 1, max_priority);
+      const guint64 thread_id = syscall(SYS_gettid);
+
+      GVariant* reply = g_dbus_connection_call_sync(connection,
+                                                    kServiceName,
+                                                    kObjectPath,
+                                                    kInterfaceName,
+                                                    "MakeThreadRealtime",
+                                                    g_variant_new("(tu)", thread_id, thread_priority),
+                                                    nullptr,
+                                                    G_DBUS_CALL_FLAGS_NONE,
+                                                    kCallTimeout,
+                                                    nullptr,
+                                                    &error);
+      if (reply != nullptr)
+      {
+        g_variant_unref(reply);
+        priority = thread_priority;
+        granted = true;
+      }
+      else reportError("request denied", error);
+    }
+
+    g_object_unref(connection);
+
+    return granted;
+  }
+
+#else
+
+  bool requestRealtimeKit(int& /*priority*/)
+  {
+    return false;
+  }
+
+#endif//__linux__
+
+}//namespace audio
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GMetronome_RealtimeKit_h
+#define GMetronome_RealtimeKit_h
+
+namespace audio {
+
+  /**
+   * @brief Ask RealtimeKit to switch the calling thread to real-time scheduling
+   *
+   * RealtimeKit (org.freedesktop.RealtimeKit1) is a system service that
+   * grants SCHED_RR to unprivileged processes on request. The priority is
+   * clamped to the maximum priority of the service and the RLIMIT_RTTIME
+   * of the process is lowered as required by RealtimeKit. The service is
+   * only available on Linux.
+   *
+   * @param priority  In: the requested priority, out: the granted priority
+   * @return Whether the request was granted
+   */
+  bool requestRealtimeKit(int& priority);
+
+}//namespace audio
+#endif//GMetronome_RealtimeKit_h
@@ -0,0 +1,354 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Offline rendering of click tracks
+ *
+ * Usage: gmetronome-render [OPTION]... FILE
+ *
+ * Renders the metronome stream to a WAV file as fast as the CPU allows,
+ * i.e. the stream controller is driven directly without an audio thread
+ * (see FileBackend). The program does not depend on GTK and uses the
+ * sounds of the default sound theme.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "Audio.h"
+#include "AudioBackendFile.h"
+#include "Generator.h"
+#include "Meter.h"
+#include "Synthesizer.h"
+
+#include <getopt.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+  using namespace audio;
+
+  // parameter ranges of the application (see Profile)
+  constexpr double kMinTempo    = 30.0;
+  constexpr double kMaxTempo    = 250.0;
+  constexpr double kMinAccel    = 1.0;
+  constexpr double kMaxAccel    = 1000.0;
+  constexpr double kMinStep     = 1.0;
+  constexpr double kMaxStep     = 99.0;
+  constexpr int    kMinHold     = 1;
+  constexpr int    kMaxHold     = 99;
+  constexpr int    kMaxCountIn  = 12;
+
+  constexpr double kMaxLength   = 24 * 3600.0; // seconds
+
+  struct Options
+  {
+    std::string   file;
+    double        tempo {120.0};
+    int           beats {kQuadrupleMeter};
+    int           division {kNoDivision};
+    std::string   accents;
+    int           count_in {0};
+    double        length {60.0};
+    double        accel {0.0};
+    double        step {0.0};
+    int           hold {8};
+    double        target {0.0};
+    StreamSpec    spec {kDefaultSpec};
+  };
+
+  class UsageError : public std::runtime_error {
+  public:
+    explicit UsageError(const std::string& what) : std::runtime_error(what)
+      { }
+  };
+
+  void printUsage(std::FILE* out)
+  {
+    std::fputs(
+      "Usage: gmetronome-render [OPTION]... FILE\n"
+      "Render a click track to a WAV file.\n"
+      "\n"
+      "  -t, --tempo=BPM        tempo (default: 120)\n"
+      "  -b, --beats=N          beats per measure, 1-12 (default: 4)\n"
+      "  -d, --division=N       subdivision of the beats, 1-4 (default: 1)\n"
+      "  -a, --accents=PATTERN  accent of each (sub)beat: 0 (off), 1 (weak),\n"
+      "                         2 (mid), 3 (strong), e.g. 3020 for -b2 -d2\n"
+      "  -c, --count-in=N       number of count-in beats, 0-12 (default: 0)\n"
+      "  -l, --length=TIME      length of the track in seconds or [HH:]MM:SS,\n"
+      "                         including the count-in (default: 60)\n"
+      "      --accel=BPM        accelerate continuously by BPM per minute\n"
+      "      --step=BPM         accelerate stepwise by BPM\n"
+      "      --hold=N           beats to hold each step (default: 8)\n"
+      "      --target=BPM       target tempo of the acceleration\n"
+      "  -f, --format=FORMAT    sample format: u8, s16, s32, float (default: s16)\n"
+      "  -r, --rate=HZ          sample rate (default: 44100)\n"
+      "  -m, --mono             write a single channel\n"
+      "  -h, --help             display this help and exit\n",
+      out);
+  }
+
+  double parseNumber(const char* arg, const char* option, double min, double max)
+  {
+    char* end = nullptr;
+    errno = 0;
+    double value = std::strtod(arg, &end);
+
+    if (end == arg || *end != '\0' || errno != 0 || !std::isfinite(value))
+      throw UsageError(std::string("invalid argument for ") + option + ": '" + arg + "'");
+
+    if (value < min || value > max)
+      throw UsageError(std::string("argument out of range for ") + option + ": '" + arg + "'");
+
+    return value;
+  }
+
+  int parseInteger(const char* arg, const char* option, int min, int max)
+  {
+    double value = parseNumber(arg, option, min, max);
+
+    if (value != std::trunc(value))
+      throw UsageError(std::string("invalid argument for ") + option + ": '" + arg + "'");
+
+    return static_cast<int>(value);
+  }
+
+  // seconds or [HH:]MM:SS
+  double parseTime(const std::string& arg, const char* option)
+  {
+    double seconds = 0.0;
+    std::string::size_type begin = 0;
+    int fields = 0;
+
+    while (true)
+    {
+      auto end = arg.find(':', begin);
+      std::string field = arg.substr(begin, end - begin);
+
+      if (++fields > 3)
+        throw UsageError(std::string("invalid argument for ") + option + ": '" + arg + "'");
+
+      seconds = 60.0 * seconds + parseNumber(field.c_str(), option, 0.0, kMaxLength);
+
+      if (end == std::string::npos)
+        break;
+
+      begin = end + 1;
+    }
+
+    if (seconds <= 0.0 || seconds > kMaxLength)
+      throw UsageError(std::string("argument out of range for ") + option + ": '" + arg + "'");
+
+    return seconds;
+  }
+
+  SampleFormat parseFormat(const std::string& arg)
+  {
+    if (arg == "u8")
+      return SampleFormat::kU8;
+    else if (arg == "s16")
+      return SampleFormat::kS16LE;
+    else if (arg == "s32")
+      return SampleFormat::kS32LE;
+    else if (arg == "float")
+      return SampleFormat::kFloat32LE;
+    else
+      throw UsageError("invalid sample format: '" + arg + "'");
+  }
+
+  Options parseOptions(int argc, char* argv[])
+  {
+    enum { kOptAccel = 256, kOptStep, kOptHold, kOptTarget };
+
+    const struct option long_options[] = {
+      {"tempo",    required_argument, nullptr, 't'},
+      {"beats",    required_argument, nullptr, 'b'},
+      {"division", required_argument, nullptr, 'd'},
+      {"accents",  required_argument, nullptr, 'a'},
+      {"count-in", required_argument, nullptr, 'c'},
+      {"length",   required_argument, nullptr, 'l'},
+      {"accel",    required_argument, nullptr, kOptAccel},
+      {"step",     required_argument, nullptr, kOptStep},
+      {"hold",     required_argument, nullptr, kOptHold},
+      {"target",   required_argument, nullptr, kOptTarget},
+      {"format",   required_argument, nullptr, 'f'},
+      {"rate",     required_argument, nullptr, 'r'},
+      {"mono",     no_argument,       nullptr, 'm'},
+      {"help",     no_argument,       nullptr, 'h'},
+      {nullptr, 0, nullptr, 0}
+    };
+
+    Options opts;
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "t:b:d:a:c:l:f:r:mh", long_options, nullptr)) != -1)
+    {
+      switch (opt) {
+      case 't': opts.tempo = parseNumber(optarg, "--tempo", kMinTempo, kMaxTempo); break;
+      case 'b': opts.beats = parseInteger(optarg, "--beats", 1, Meter::kMaxBeats); break;
+      case 'd': opts.division = parseInteger(optarg, "--division", 1, Meter::kMaxDivision); break;
+      case 'a': opts.accents = optarg; break;
+      case 'c': opts.count_in = parseInteger(optarg, "--count-in", 0, kMaxCountIn); break;
+      case 'l': opts.length = parseTime(optarg, "--length"); break;
+      case kOptAccel: opts.accel = parseNumber(optarg, "--accel", kMinAccel, kMaxAccel); break;
+      case kOptStep: opts.step = parseNumber(optarg, "--step", kMinStep, kMaxStep); break;
+      case kOptHold: opts.hold = parseInteger(optarg, "--hold", kMinHold, kMaxHold); break;
+      case kOptTarget: opts.target = parseNumber(optarg, "--target", kMinTempo, kMaxTempo); break;
+      case 'f': opts.spec.format = parseFormat(optarg); break;
+      case 'r': opts.spec.rate = parseInteger(optarg, "--rate", 8000, 192000); break;
+      case 'm': opts.spec.channels = 1; break;
+      case 'h': printUsage(stdout); std::exit(EXIT_SUCCESS); break;
+      default:
+        throw UsageError("");
+      };
+    }
+
+    if (optind + 1 != argc)
+      throw UsageError(optind < argc ? "too many arguments" : "missing file name");
+
+    opts.file = argv[optind];
+
+    if (opts.accel > 0.0 && opts.step > 0.0)
+      throw UsageError("--accel and --step are mutually exclusive");
+
+    if ((opts.accel > 0.0 || opts.step > 0.0) && opts.target == 0.0)
+      throw UsageError("missing target tempo (--target)");
+
+    if (opts.accents.size() > size_t(opts.beats * opts.division)
+        || opts.accents.find_first_not_of("0123") != std::string::npos)
+      throw UsageError("invalid accent pattern: '" + opts.accents + "'");
+
+    return opts;
+  }
+
+  // strong first beat, mid beats, weak subdivisions (unless given explicitly)
+  Meter makeMeter(const Options& opts)
+  {
+    AccentPattern accents(opts.beats * opts.division, kAccentWeak);
+
+    for (int beat = 0; beat < opts.beats; ++beat)
+      accents[beat * opts.division] = (beat == 0 && opts.beats > 1) ? kAccentStrong : kAccentMid;
+
+    for (size_t index = 0; index < opts.accents.size(); ++index)
+      accents[index] = static_cast<Accent>(opts.accents[index] - '0');
+
+    return Meter(opts.division, opts.beats, accents);
+  }
+
+  /**
+   * Drives the stream controller and writes the stream to the backend until
+   * the given number of frames is reached. Returns the number of frames.
+   */
+  size_t renderStream(BeatStreamController& ctrl, Backend& backend, size_t frames)
+  {
+    const size_t frame_size = frameSize(ctrl.spec());
+
+    size_t frames_done = 0;
+    while (frames_done < frames)
+    {
+      const void* data = nullptr;
+      size_t bytes = 0;
+
+      ctrl.cycle(data, bytes, frames - frames_done);
+
+      size_t chunk_frames = std::min(bytes / frame_size, frames - frames_done);
+      if (chunk_frames == 0 || data == nullptr)
+        break;
+
+      backend.write(data, chunk_frames * frame_size);
+      frames_done += chunk_frames;
+    }
+    return frames_done;
+  }
+
+  void render(const Options& opts)
+  {
+    FileBackend backend;
+    backend.configure({opts.file, opts.spec, LatencyProfile::kPowerSave});
+
+    DeviceConfig cfg = backend.open();
+
+    // the largest chunks of the power-save profile minimize the number of cycles
+    auto ctrl = std::make_unique<BeatStreamController>(cfg.spec);
+    ctrl->prepare(cfg.spec, cfg.latency);
+
+    Synthesizer synth(cfg.spec);
+    for (Accent accent : {kAccentWeak, kAccentMid, kAccentStrong})
+    {
+      ByteBuffer sound = synth.create(defaultSoundParameters(accent));
+      ctrl->swapSound(accent, sound);
+    }
+
+    Meter meter = makeMeter(opts);
+    ctrl->swapMeter(meter);
+    ctrl->setCountIn(opts.count_in);
+    ctrl->setTempo(opts.tempo);
+
+    if (opts.accel > 0.0)
+      ctrl->accelerate(opts.accel, opts.target);
+    else if (opts.step > 0.0)
+      ctrl->accelerate(opts.hold, opts.step, opts.target);
+
+    const size_t frames = std::llround(opts.length * cfg.spec.rate);
+
+    auto start = std::chrono::steady_clock::now();
+
+    // skip the silence that fills the buffer of a sound card
+    ctrl->start(kPreCountGenerator);
+    backend.start();
+    renderStream(*ctrl, backend, frames);
+    backend.stop();
+    backend.close();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::fprintf(stderr, "%s: %.1f s rendered in %.3f s\n",
+                 opts.file.c_str(), (double) frames / cfg.spec.rate, elapsed.count());
+  }
+
+}//unnamed namespace
+
+int main(int argc, char* argv[])
+{
+  try {
+    render(parseOptions(argc, argv));
+  }
+  catch (const UsageError& e) {
+    if (*e.what() != '\0')
+      std::fprintf(stderr, "gmetronome-render: %s\n", e.what());
+    std::fputs("Try 'gmetronome-render --help' for more information.\n", stderr);
+    return EXIT_FAILURE;
+  }
+  catch (const std::exception& e) {
+    std::fprintf(stderr, "gmetronome-render: %s\n", e.what());
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -43,6 +43,9 @@ namespace settings {
 #endif
 #if HAVE_PULSEAUDIO
     {settings::kAudioBackendPulseaudio, audio::BackendIdentifier::kPulseAudio},
+#endif
+#if HAVE_JACK
+    {settings::kAudioBackendJack, audio::BackendIdentifier::kJACK},
 #endif
   };
 
@@ -73,6 +76,19 @@ namespace settings {
     return backends;
   }
 
+  audio::LatencyProfile audioLatencyToProfile(AudioLatency latency)
+  {
+    switch (latency)
+    {
+    case kAudioLatencyUltraLow: return audio::LatencyProfile::kUltraLow; break;
+    case kAudioLatencyPowerSave: return audio::LatencyProfile::kPowerSave; break;
+    case kAudioLatencyNormal:
+      [[fallthrough]];
+    default: return audio::LatencyProfile::kNormal;
+      break;
+    };
+  }
+
   const std::map<settings::AudioBackend, Glib::ustring> kBackendToDeviceMap
   {
 #if HAVE_ALSA
@@ -83,6 +99,9 @@ namespace settings {
 #endif
 #if HAVE_PULSEAUDIO
     { settings::kAudioBackendPulseaudio, settings::kKeyPrefsAudioDevicePulseaudio },
+#endif
+#if HAVE_JACK
+    { settings::kAudioBackendJack, settings::kKeyPrefsAudioDeviceJack },
 #endif
   };
 
@@ -96,6 +115,9 @@ namespace settings {
 #endif
 #if HAVE_PULSEAUDIO
     { settings::kKeyPrefsAudioDevicePulseaudio, settings::kAudioBackendPulseaudio },
+#endif
+#if HAVE_JACK
+    { settings::kKeyPrefsAudioDeviceJack, settings::kAudioBackendJack },
 #endif
   };
 
@@ -33,6 +33,7 @@
 // forward decl.
 namespace audio {
   enum class BackendIdentifier;
+  enum class LatencyProfile : unsigned char;
 }
 enum Accent : int;
 
@@ -115,6 +116,9 @@ namespace settings {
 #endif
 #if HAVE_PULSEAUDIO
     kAudioBackendPulseaudio = 3,
+#endif
+#if HAVE_JACK
+    kAudioBackendJack       = 4,
 #endif
   };
 
@@ -128,6 +132,16 @@ namespace settings {
   // Get a list of available audio backends (see audio::availableBackends)
   std::vector<AudioBackend> availableBackends();
 
+  enum AudioLatency
+  {
+    kAudioLatencyUltraLow   = 0,
+    kAudioLatencyNormal     = 1,
+    kAudioLatencyPowerSave  = 2
+  };
+
+  // Map audio latency to a latency profile as used in the audio framework
+  audio::LatencyProfile audioLatencyToProfile(AudioLatency latency);
+
   enum PendulumAction
   {
     kPendulumActionCenter = 0,
@@ -166,6 +180,10 @@ namespace settings {
   inline const Glib::ustring  kKeyPrefsMeterAnimation             {"meter-animation"};
   inline const Glib::ustring  kKeyPrefsAnimationSync              {"animation-sync"};
   inline const Glib::ustring  kKeyPrefsAudioBackend               {"audio-backend"};
+  inline const Glib::ustring  kKeyPrefsAudioLatency               {"audio-latency"};
+  inline const Glib::ustring  kKeyPrefsAudioRealtime              {"audio-realtime"};
+  inline const Glib::ustring  kKeyPrefsAudioTransport             {"audio-transport"};
+  inline const Glib::ustring  kKeyPrefsAudioStandby               {"audio-standby"};
 
 #if HAVE_ALSA
   inline const Glib::ustring  kKeyPrefsAudioDeviceAlsa            {"audio-device-alsa"};
@@ -176,6 +194,9 @@ namespace settings {
 #if HAVE_PULSEAUDIO
   inline const Glib::ustring  kKeyPrefsAudioDevicePulseaudio      {"audio-device-pulseaudio"};
 #endif
+#if HAVE_JACK
+  inline const Glib::ustring  kKeyPrefsAudioDeviceJack            {"audio-device-jack"};
+#endif
 
   // Map audio backend (w/o kAudioBackendNone) to the corresponding audio device settings
   // key (e.g. kAudioBackendAlsa -> "audio-device-alsa") and vice versa
@@ -206,7 +227,9 @@ namespace settings {
   inline const Glib::ustring  kKeySoundThemeToneHoldShape         {"tone-hold-shape"};
   inline const Glib::ustring  kKeySoundThemeToneDecay             {"tone-decay"};
   inline const Glib::ustring  kKeySoundThemeToneDecayShape        {"tone-decay-shape"};
+  inline const Glib::ustring  kKeySoundThemePercussionFilter      {"percussion-filter"};
   inline const Glib::ustring  kKeySoundThemePercussionCutoff      {"percussion-cutoff"};
+  inline const Glib::ustring  kKeySoundThemePercussionResonance   {"percussion-resonance"};
   inline const Glib::ustring  kKeySoundThemePercussionAttack      {"percussion-attack"};
   inline const Glib::ustring  kKeySoundThemePercussionAttackShape {"percussion-attack-shape"};
   inline const Glib::ustring  kKeySoundThemePercussionHold        {"percussion-hold"};
@@ -229,7 +252,9 @@ namespace settings {
   inline const Glib::ustring  kKeyShortcutsShowHelp               {"show-help"};
   inline const Glib::ustring  kKeyShortcutsShowPendulum           {"show-pendulum"};
   inline const Glib::ustring  kKeyShortcutsFullScreen             {"full-screen"};
+  inline const Glib::ustring  kKeyShortcutsShowStats              {"show-stats"};
   inline const Glib::ustring  kKeyShortcutsStart                  {"start"};
+  inline const Glib::ustring  kKeyShortcutsPause                  {"pause"};
   inline const Glib::ustring  kKeyShortcutsVolumeIncrease1        {"volume-increase-1"};
   inline const Glib::ustring  kKeyShortcutsVolumeDecrease1        {"volume-decrease-1"};
   inline const Glib::ustring  kKeyShortcutsVolumeIncrease10       {"volume-increase-10"};
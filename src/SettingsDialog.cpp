@@ -30,6 +30,7 @@
 #include "MainWindow.h"
 
 #include <glibmm/i18n.h>
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
@@ -54,6 +55,10 @@ SettingsDialog::SettingsDialog(BaseObjectType* cobject,
   builder_->get_widget("soundThemeEditButton", sound_theme_edit_button_);
   builder_->get_widget("audioBackendComboBox", audio_backend_combo_box_);
   builder_->get_widget("audioDeviceComboBox", audio_device_combo_box_);
+  builder_->get_widget("audioLatencyComboBox", audio_latency_combo_box_);
+  builder_->get_widget("audioRealtimeSwitch", audio_realtime_switch_);
+  builder_->get_widget("audioTransportSwitch", audio_transport_switch_);
+  builder_->get_widget("audioStandbySwitch", audio_standby_switch_);
   builder_->get_widget("audioDeviceEntry", audio_device_entry_);
   builder_->get_widget("shortcutsResetButton", shortcuts_reset_button_);
   builder_->get_widget("shortcutsTreeView", shortcuts_tree_view_);
@@ -282,6 +287,14 @@ void SettingsDialog::initBindings()
   //
   settings::preferences()->bind(settings::kKeyPrefsAudioBackend,
                                 audio_backend_combo_box_->property_active_id());
+  settings::preferences()->bind(settings::kKeyPrefsAudioLatency,
+                                audio_latency_combo_box_->property_active_id());
+  settings::preferences()->bind(settings::kKeyPrefsAudioRealtime,
+                                audio_realtime_switch_->property_active());
+  settings::preferences()->bind(settings::kKeyPrefsAudioTransport,
+                                audio_transport_switch_->property_active());
+  settings::preferences()->bind(settings::kKeyPrefsAudioStandby,
+                                audio_standby_switch_->property_active());
 
   audio_device_entry_->add_events(Gdk::FOCUS_CHANGE_MASK);
 
@@ -719,13 +732,22 @@ void SettingsDialog::updateAudioDeviceList()
   std::vector<Glib::ustring> dev_list;
   app->get_action_state(kActionAudioDeviceList, dev_list);
 
-  audio_device_combo_box_->remove_all();
+  dev_list.erase(std::remove(dev_list.begin(), dev_list.end(), Glib::ustring{}),
+                 dev_list.end());
 
-  for (auto& dev : dev_list)
+  // The device list grows while the devices are scanned, so that in most
+  // cases only the new devices need to be appended.
+  if (dev_list.size() < audio_device_list_.size()
+      || !std::equal(audio_device_list_.begin(), audio_device_list_.end(), dev_list.begin()))
   {
-    if (!dev.empty())
-      audio_device_combo_box_->append(dev, dev);
+    audio_device_combo_box_->remove_all();
+    audio_device_list_.clear();
   }
+
+  for (auto it = dev_list.begin() + audio_device_list_.size(); it != dev_list.end(); ++it)
+    audio_device_combo_box_->append(*it, *it);
+
+  audio_device_list_ = std::move(dev_list);
 }
 
 void SettingsDialog::updateAudioDevice()
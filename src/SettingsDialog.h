@@ -100,7 +100,12 @@ private:
   // Audio Device tab
   Gtk::ComboBoxText* audio_backend_combo_box_;
   Gtk::ComboBoxText* audio_device_combo_box_;
+  std::vector<Glib::ustring> audio_device_list_; // items of audio_device_combo_box_
   Gtk::Entry* audio_device_entry_;
+  Gtk::ComboBoxText* audio_latency_combo_box_;
+  Gtk::Switch* audio_realtime_switch_;
+  Gtk::Switch* audio_transport_switch_;
+  Gtk::Switch* audio_standby_switch_;
 
   // Shortcuts tab
   Gtk::TreeView* shortcuts_tree_view_;
@@ -41,12 +41,14 @@ const std::vector<ShortcutGroup>& ShortcutList()
       {
         { settings::kKeyShortcutsShowPendulum,    C_("Shortcut title", "Show Pendulum") },
         { settings::kKeyShortcutsFullScreen,      C_("Shortcut title", "Full Screen") },
+        { settings::kKeyShortcutsShowStats,       C_("Shortcut title", "Show Audio Statistics") },
       }
     },{
       ShortcutGroupIdentifier::Transport,
       C_("Shortcut group title", "Transport"),
       {
         {settings::kKeyShortcutsStart,            C_("Shortcut title", "Start/Stop") },
+        {settings::kKeyShortcutsPause,            C_("Shortcut title", "Pause/Resume") },
       }
     },{
       ShortcutGroupIdentifier::Tempo,
@@ -134,11 +136,17 @@ const std::map<Glib::ustring, ShortcutAction> kDefaultShortcutActionMap
   { settings::kKeyShortcutsFullScreen,
     { kActionFullScreen, {} }
   },
+  { settings::kKeyShortcutsShowStats,
+    { kActionShowStats, {} }
+  },
 
   // Transport
   { settings::kKeyShortcutsStart,
     { kActionStart, {} }
   },
+  { settings::kKeyShortcutsPause,
+    { kActionPause, {} }
+  },
 
   //Tempo
   { settings::kKeyShortcutsTempoIncrease1,
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "SoundCache.h"
+
+#include <functional>
+
+namespace audio {
+
+  namespace {
+
+    template<typename T>
+    void hashCombine(std::size_t& seed, const T& value)
+    {
+      seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+  }//unnamed namespace
+
+  std::size_t SoundCache::KeyHash::operator()(const Key& key) const
+  {
+    const SoundParameters& p = key.params;
+
+    std::size_t seed = 0;
+    hashCombine(seed, p.tone_pitch);
+    hashCombine(seed, p.tone_timbre);
+    hashCombine(seed, p.tone_detune);
+    hashCombine(seed, p.tone_attack);
+    hashCombine(seed, p.tone_attack_shape);
+    hashCombine(seed, p.tone_hold);
+    hashCombine(seed, p.tone_hold_shape);
+    hashCombine(seed, p.tone_decay);
+    hashCombine(seed, p.tone_decay_shape);
+    hashCombine(seed, p.percussion_filter);
+    hashCombine(seed, p.percussion_cutoff);
+    hashCombine(seed, p.percussion_resonance);
+    hashCombine(seed, p.percussion_attack);
+    hashCombine(seed, p.percussion_attack_shape);
+    hashCombine(seed, p.percussion_hold);
+    hashCombine(seed, p.percussion_hold_shape);
+    hashCombine(seed, p.percussion_decay);
+    hashCombine(seed, p.percussion_decay_shape);
+    hashCombine(seed, p.mix);
+    hashCombine(seed, p.pan);
+    hashCombine(seed, p.volume);
+    hashCombine(seed, key.spec.format);
+    hashCombine(seed, key.spec.rate);
+    hashCombine(seed, key.spec.channels);
+    return seed;
+  }
+
+  SoundCache::SoundCache(std::size_t budget)
+    : budget_{budget}
+  {}
+
+  bool SoundCache::lookup(const SoundParameters& params,
+                          const StreamSpec& spec,
+                          ByteBuffer& buffer)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    auto it = index_.find({params, spec});
+    if (it == index_.end())
+    {
+      ++misses_;
+      return false;
+    }
+
+    entries_.splice(entries_.begin(), entries_, it->second);
+    buffer = it->second->second;
+
+    ++hits_;
+    return true;
+  }
+
+  void SoundCache::insert(const SoundParameters& params,
+                          const StreamSpec& spec,
+                          const ByteBuffer& buffer)
+  {
+    auto fits = [this, &buffer] { return budget_ > 0 && buffer.size() <= budget_; };
+
+    if (std::lock_guard<std::mutex> guard(mutex_); !fits())
+      return;
+
+    // copy the sound before the cache is locked
+    EntryList entry;
+    entry.emplace_front(Key{params, spec}, buffer);
+
+    const Key& key = entry.front().first;
+
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    // the budget might have changed in the meantime
+    if (!fits())
+      return;
+
+    if (auto it = index_.find(key); it != index_.end())
+    {
+      bytes_ -= it->second->second.size();
+      entries_.erase(it->second);
+      index_.erase(it);
+    }
+
+    evict(budget_ - buffer.size());
+
+    entries_.splice(entries_.begin(), entry);
+    index_.emplace(key, entries_.begin());
+    bytes_ += buffer.size();
+  }
+
+  void SoundCache::setBudget(std::size_t budget)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    budget_ = budget;
+    evict(budget_);
+  }
+
+  void SoundCache::clear()
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    index_.clear();
+    entries_.clear();
+    bytes_ = 0;
+  }
+
+  SoundCache::Stats SoundCache::stats() const
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return {hits_, misses_, entries_.size(), bytes_, budget_};
+  }
+
+  void SoundCache::resetStats()
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    hits_ = 0;
+    misses_ = 0;
+  }
+
+  void SoundCache::evict(std::size_t budget)
+  {
+    while (bytes_ > budget && !entries_.empty())
+    {
+      auto& [key, buffer] = entries_.back();
+      bytes_ -= buffer.size();
+      index_.erase(key);
+      entries_.pop_back();
+    }
+  }
+
+}//namespace audio
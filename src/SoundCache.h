@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef GMetronome_SoundCache_h
+#define GMetronome_SoundCache_h
+
+#include "Audio.h"
+#include "AudioBuffer.h"
+#include "Synthesizer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace audio {
+
+  /** Default memory budget of a SoundCache (in bytes) */
+  constexpr std::size_t kDefaultSoundCacheBudget = 4 * 1024 * 1024;
+
+  /**
+   * @class SoundCache
+   * @brief A least recently used cache of rendered sounds
+   *
+   * The sounds are addressed by their content, i.e. the sound parameters
+   * and the stream specification they were rendered with. If the size of
+   * the cached sounds exceeds the memory budget, the least recently used
+   * sounds are evicted. The cache is thread-safe, but the lookup copies the
+   * sound while the cache is locked, so it should not be shared with the
+   * audio thread.
+   */
+  class SoundCache {
+  public:
+    struct Stats
+    {
+      std::uint64_t hits {0};
+      std::uint64_t misses {0};
+      std::size_t   entries {0};
+      std::size_t   bytes {0};
+      std::size_t   budget {0};
+    };
+
+    explicit SoundCache(std::size_t budget = kDefaultSoundCacheBudget);
+
+    /**
+     * @brief Look up a rendered sound
+     * @param buffer  Receives a copy of the cached sound on success
+     * @return Whether the sound was found
+     */
+    bool lookup(const SoundParameters& params, const StreamSpec& spec, ByteBuffer& buffer);
+
+    /**
+     * @brief Store a rendered sound
+     * Sounds that exceed the memory budget on their own are not stored.
+     */
+    void insert(const SoundParameters& params, const StreamSpec& spec, const ByteBuffer& buffer);
+
+    /** Change the memory budget and evict sounds if necessary (0 disables the cache). */
+    void setBudget(std::size_t budget);
+
+    /** Remove all sounds (the hit and miss counters are kept). */
+    void clear();
+
+    Stats stats() const;
+
+    /** Reset the hit and miss counters. */
+    void resetStats();
+
+  private:
+    struct Key
+    {
+      SoundParameters params;
+      StreamSpec spec;
+
+      bool operator==(const Key& other) const
+        { return params == other.params && spec == other.spec; }
+    };
+
+    struct KeyHash
+    {
+      std::size_t operator()(const Key& key) const;
+    };
+
+    // most recently used sounds first
+    using EntryList = std::list<std::pair<Key, ByteBuffer>>;
+
+    mutable std::mutex mutex_;
+    EntryList entries_;
+    std::unordered_map<Key, EntryList::iterator, KeyHash> index_;
+    std::size_t bytes_ {0};
+    std::size_t budget_;
+    std::uint64_t hits_ {0};
+    std::uint64_t misses_ {0};
+
+    void evict(std::size_t budget);
+  };
+
+}//namespace audio
+#endif//GMetronome_SoundCache_h
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "SoundRenderer.h"
+#include "Realtime.h"
+
+#include <cassert>
+
+#ifndef NDEBUG
+# include <iostream>
+#endif
+
+namespace audio {
+
+  SoundRenderer::SoundRenderer(const StreamSpec& spec)
+    : synth_{spec},
+      in_spec_{spec}
+  {
+    in_params_[kAccentOff].volume = 0.0;
+    in_pending_.set();
+
+    worker_ = std::thread(&SoundRenderer::workerFunction, this);
+  }
+
+  SoundRenderer::~SoundRenderer()
+  {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      quit_ = true;
+    }
+    cond_var_.notify_one();
+
+    if (worker_.joinable())
+      worker_.join();
+  }
+
+  void SoundRenderer::setSound(Accent accent, const SoundParameters& params)
+  {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+
+      // the sound is already rendered or about to be rendered
+      if (params == in_params_[accent])
+        return;
+
+      in_params_[accent] = params;
+      in_pending_.set(accent);
+    }
+    cond_var_.notify_one();
+  }
+
+  void SoundRenderer::prepare(const StreamSpec& spec) noexcept
+  {
+    assert(spec.rate > 0);
+
+    // neither lock the mutex nor notify the worker (see workerFunction)
+    spec_buffer_.back() = spec;
+    spec_buffer_.publish();
+  }
+
+  void SoundRenderer::setCacheBudget(std::size_t budget)
+  {
+    cache_.setBudget(budget);
+  }
+
+  SoundCache::Stats SoundRenderer::cacheStats() const
+  {
+    return cache_.stats();
+  }
+
+  void SoundRenderer::resetCacheStats()
+  {
+    cache_.resetStats();
+  }
+
+  ByteBuffer* SoundRenderer::acquire(Accent accent) noexcept
+  {
+    if (auto& sound = sounds_[accent]; sound.update())
+      return &sound.front();
+    else
+      return nullptr;
+  }
+
+  bool SoundRenderer::updateSpec()
+  {
+    if (!spec_buffer_.update() || spec_buffer_.front() == in_spec_)
+      return false;
+
+    in_spec_ = spec_buffer_.front();
+    in_pending_.set();
+    return true;
+  }
+
+  void SoundRenderer::workerFunction()
+  {
+    std::unique_lock<std::mutex> lck(mutex_);
+
+    while (true)
+    {
+      // the stream specification is polled, since prepare() does not notify
+      cond_var_.wait_for(lck, kSpecPollInterval, [&] {
+        updateSpec();
+        return quit_ || in_pending_.any();
+      });
+
+      if (quit_)
+        break;
+
+      if (in_pending_.none())
+        continue;
+
+      // render one sound at a time to pick up new parameters as early as possible
+      int accent = 0;
+      while (!in_pending_.test(accent))
+        ++accent;
+
+      in_pending_.reset(accent);
+
+      SoundParameters params = in_params_[accent];
+      StreamSpec spec = in_spec_;
+
+      // the cache copies and allocates, so it has its own lock
+      lck.unlock();
+
+      auto& buffer = sounds_[accent].back();
+
+      bool cached = false;
+      try {
+        cached = cache_.lookup(params, spec, buffer);
+      }
+      catch(...) {}
+
+      bool rendered = false;
+      if (!cached)
+      {
+        try {
+          DenormalGuard denormals {flush_denormals_.load(std::memory_order_relaxed)};
+
+          auto start = std::chrono::steady_clock::now();
+
+          synth_.prepare(spec);
+          synth_.update(buffer, params);
+
+          render_time_.record(std::chrono::steady_clock::now() - start);
+          rendered = true;
+        }
+        catch(...)
+        {
+#ifndef NDEBUG
+          std::cerr << "SoundRenderer: failed to render sound" << std::endl;
+#endif
+        }
+
+        // store the sound before it is published and might be swapped
+        // by the audio thread
+        if (rendered)
+        {
+          try {
+            cache_.insert(params, spec, buffer);
+          }
+          catch(...) {}
+        }
+      }
+
+      if (cached || rendered)
+        sounds_[accent].publish();
+
+      lck.lock();
+    }
+  }
+
+}//namespace audio
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GMetronome_SoundRenderer_h
+#define GMetronome_SoundRenderer_h
+
+#include "Audio.h"
+#include "AudioBuffer.h"
+#include "Histogram.h"
+#include "SoundCache.h"
+#include "Synthesizer.h"
+#include "TripleBuffer.h"
+#include "Meter.h"
+
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace audio {
+
+  /**
+   * @class SoundRenderer
+   * @brief Synthesizes the accent sounds on a background thread
+   *
+   * Sound parameters are passed to a worker thread that renders new sound
+   * buffers and publishes them in a TripleBuffer. The audio thread acquires
+   * the buffers with acquire(), which never blocks and does not allocate,
+   * and swaps them into the stream (see StreamController::swapSound).
+   *
+   * Rendered sounds are kept in a SoundCache, so that switching back to
+   * previously used sounds (e.g. of another profile or sound theme) copies
+   * the cached sound instead of synthesizing it again.
+   */
+  class SoundRenderer {
+  public:
+    explicit SoundRenderer(const StreamSpec& spec = kDefaultSpec);
+    ~SoundRenderer();
+
+    SoundRenderer(const SoundRenderer&) = delete;
+    SoundRenderer& operator=(const SoundRenderer&) = delete;
+
+    /**
+     * @brief Request a new sound for the given accent
+     * Subsequent calls before the worker picked up the parameters are
+     * merged, i.e. only the latest parameters will be rendered. Parameters
+     * that equal the latest ones are ignored.
+     */
+    void setSound(Accent accent, const SoundParameters& params);
+
+    /**
+     * @brief Change the stream specification
+     *
+     * If the specification changed, all sounds will be rendered again.
+     *
+     * This function is wait-free and meant to be called from the audio thread
+     * (only one thread at a time). The worker does not get notified, but picks
+     * up the specification within kSpecPollInterval.
+     */
+    void prepare(const StreamSpec& spec) noexcept;
+
+    /**
+     * @brief Acquire the most recently rendered sound of an accent
+     *
+     * This function is wait-free and meant to be called from the audio thread.
+     * The returned buffer is owned by the renderer but may be modified (e.g.
+     * swapped) by the caller until the next call to acquire() for the same
+     * accent.
+     *
+     * @return A pointer to the new sound buffer or nullptr, if no new sound
+     *         is available.
+     */
+    ByteBuffer* acquire(Accent accent) noexcept;
+
+    /**
+     * @brief Flush denormal floats to zero during synthesis
+     * Applies to all sounds that are rendered after the call (see DenormalGuard).
+     */
+    void setFlushDenormals(bool enable)
+      { flush_denormals_.store(enable, std::memory_order_relaxed); }
+
+    /** Distribution of the time to synthesize a sound. */
+    Histogram renderTime() const
+      { return render_time_.snapshot(); }
+
+    /** Reset the distribution of the synthesis time. */
+    void resetRenderTime()
+      { render_time_.reset(); }
+
+    /** Set the memory budget of the sound cache (in bytes). */
+    void setCacheBudget(std::size_t budget);
+
+    /** Statistics of the sound cache. */
+    SoundCache::Stats cacheStats() const;
+
+    /** Reset the hit and miss counters of the sound cache. */
+    void resetCacheStats();
+
+    /** Interval in which the worker looks for a new stream specification. */
+    static constexpr std::chrono::milliseconds kSpecPollInterval {20};
+
+  private:
+    Synthesizer synth_;
+    std::array<TripleBuffer<ByteBuffer>, kNumAccents> sounds_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cond_var_;
+    std::array<SoundParameters, kNumAccents> in_params_;
+    std::bitset<kNumAccents> in_pending_;
+    StreamSpec in_spec_;
+    TripleBuffer<StreamSpec> spec_buffer_; // see prepare()
+    bool quit_{false};
+    std::atomic<bool> flush_denormals_{false};
+    HistogramRecorder render_time_;
+    SoundCache cache_; // accessed without mutex_ (see SoundCache)
+
+    std::thread worker_;
+
+    bool updateSpec();
+    void workerFunction();
+  };
+
+}//namespace audio
+#endif//GMetronome_SoundRenderer_h
@@ -72,7 +72,10 @@ struct SettingsListDelegate<SoundTheme>
         target.tone_decay_shape = static_cast<audio::EnvelopeRampShape>(
           settings->get_enum(settings::kKeySoundThemeToneDecayShape));
 
+        target.percussion_filter = static_cast<audio::PercussionFilter>(
+          settings->get_enum(settings::kKeySoundThemePercussionFilter));
         target.percussion_cutoff = settings->get_double(settings::kKeySoundThemePercussionCutoff);
+        target.percussion_resonance = settings->get_double(settings::kKeySoundThemePercussionResonance);
 
         target.percussion_attack = settings->get_double(settings::kKeySoundThemePercussionAttack);
         target.percussion_attack_shape = static_cast<audio::EnvelopeRampShape>(
@@ -113,7 +116,10 @@ struct SettingsListDelegate<SoundTheme>
         settings->set_enum(settings::kKeySoundThemeToneDecayShape,
                            static_cast<int>(source.tone_decay_shape));
 
+        settings->set_enum(settings::kKeySoundThemePercussionFilter,
+                           static_cast<int>(source.percussion_filter));
         settings->set_double(settings::kKeySoundThemePercussionCutoff, source.percussion_cutoff);
+        settings->set_double(settings::kKeySoundThemePercussionResonance, source.percussion_resonance);
 
         settings->set_double(settings::kKeySoundThemePercussionAttack, source.percussion_attack);
         settings->set_enum(settings::kKeySoundThemePercussionAttackShape,
@@ -193,7 +199,9 @@ struct SettingsListDelegate<SoundTheme>
         m = m || settings->get_user_value(settings::kKeySoundThemeToneDecay, dbl_value);
         m = m || settings->get_user_value(settings::kKeySoundThemeToneDecayShape, int_value);
 
+        m = m || settings->get_user_value(settings::kKeySoundThemePercussionFilter, int_value);
         m = m || settings->get_user_value(settings::kKeySoundThemePercussionCutoff, dbl_value);
+        m = m || settings->get_user_value(settings::kKeySoundThemePercussionResonance, dbl_value);
 
         m = m || settings->get_user_value(settings::kKeySoundThemePercussionAttack, dbl_value);
         m = m || settings->get_user_value(settings::kKeySoundThemePercussionAttackShape, int_value);
@@ -192,6 +192,7 @@ SoundThemeEditor::SoundThemeEditor(BaseObjectType* obj,
   builder_->get_widget("toneAttackBox", tone_attack_box_);
   builder_->get_widget("toneHoldBox", tone_hold_box_);
   builder_->get_widget("toneDecayBox", tone_decay_box_);
+  builder_->get_widget("percussionFilterComboBox", percussion_filter_combo_box_);
   builder_->get_widget("percussionAttackBox", percussion_attack_box_);
   builder_->get_widget("percussionHoldBox", percussion_hold_box_);
   builder_->get_widget("percussionDecayBox", percussion_decay_box_);
@@ -213,6 +214,8 @@ SoundThemeEditor::SoundThemeEditor(BaseObjectType* obj,
     Glib::RefPtr<Gtk::Adjustment>::cast_dynamic(builder_->get_object("toneDecayAdjustment"));
   percussion_cutoff_adjustment_ =
     Glib::RefPtr<Gtk::Adjustment>::cast_dynamic(builder_->get_object("percussionCutoffAdjustment"));
+  percussion_resonance_adjustment_ =
+    Glib::RefPtr<Gtk::Adjustment>::cast_dynamic(builder_->get_object("percussionResonanceAdjustment"));
   percussion_attack_adjustment_ =
     Glib::RefPtr<Gtk::Adjustment>::cast_dynamic(builder_->get_object("percussionAttackAdjustment"));
   percussion_hold_adjustment_ =
@@ -376,8 +379,12 @@ void SoundThemeEditor::bindSoundProperties()
                           tone_decay_adjustment_->property_value());
     sound_settings_->bind(settings::kKeySoundThemeToneDecayShape,
                           tone_decay_shape_button_.property_shape());
+    sound_settings_->bind(settings::kKeySoundThemePercussionFilter,
+                          percussion_filter_combo_box_->property_active_id());
     sound_settings_->bind(settings::kKeySoundThemePercussionCutoff,
                           percussion_cutoff_adjustment_->property_value());
+    sound_settings_->bind(settings::kKeySoundThemePercussionResonance,
+                          percussion_resonance_adjustment_->property_value());
     sound_settings_->bind(settings::kKeySoundThemePercussionAttack,
                           percussion_attack_adjustment_->property_value());
     sound_settings_->bind(settings::kKeySoundThemePercussionAttackShape,
@@ -416,7 +423,9 @@ void SoundThemeEditor::unbindSoundProperties()
   unbindProperty(tone_hold_shape_button_.property_shape());
   unbindProperty(tone_decay_adjustment_->property_value());
   unbindProperty(tone_decay_shape_button_.property_shape());
+  unbindProperty(percussion_filter_combo_box_->property_active_id());
   unbindProperty(percussion_cutoff_adjustment_->property_value());
+  unbindProperty(percussion_resonance_adjustment_->property_value());
   unbindProperty(percussion_attack_adjustment_->property_value());
   unbindProperty(percussion_attack_shape_button_.property_shape());
   unbindProperty(percussion_hold_adjustment_->property_value());
@@ -501,7 +510,9 @@ namespace {
     {settings::kKeySoundThemeToneDecay,       G_TYPE_DOUBLE},
     {settings::kKeySoundThemeToneDecayShape,  G_TYPE_ENUM},
 
+    {settings::kKeySoundThemePercussionFilter,      G_TYPE_ENUM},
     {settings::kKeySoundThemePercussionCutoff,      G_TYPE_DOUBLE},
+    {settings::kKeySoundThemePercussionResonance,   G_TYPE_DOUBLE},
     {settings::kKeySoundThemePercussionAttack,      G_TYPE_DOUBLE},
     {settings::kKeySoundThemePercussionAttackShape, G_TYPE_ENUM},
     {settings::kKeySoundThemePercussionHold,        G_TYPE_DOUBLE},
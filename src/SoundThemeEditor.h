@@ -77,6 +77,7 @@ private:
   Gtk::Box* tone_attack_box_;
   Gtk::Box* tone_hold_box_;
   Gtk::Box* tone_decay_box_;
+  Gtk::ComboBoxText* percussion_filter_combo_box_;
   Gtk::Box* percussion_attack_box_;
   Gtk::Box* percussion_hold_box_;
   Gtk::Box* percussion_decay_box_;
@@ -95,6 +96,7 @@ private:
   Glib::RefPtr<Gtk::Adjustment> tone_hold_adjustment_;
   Glib::RefPtr<Gtk::Adjustment> tone_decay_adjustment_;
   Glib::RefPtr<Gtk::Adjustment> percussion_cutoff_adjustment_;
+  Glib::RefPtr<Gtk::Adjustment> percussion_resonance_adjustment_;
   Glib::RefPtr<Gtk::Adjustment> percussion_attack_adjustment_;
   Glib::RefPtr<Gtk::Adjustment> percussion_hold_adjustment_;
   Glib::RefPtr<Gtk::Adjustment> percussion_decay_adjustment_;
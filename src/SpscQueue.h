@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GMetronome_SpscQueue_h
+#define GMetronome_SpscQueue_h
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @class SpscQueue
+ * @brief Bounded wait-free FIFO for a single producer and a single consumer
+ *
+ * The queue operates on a fixed ring of N preallocated slots. Elements are
+ * move-assigned into their slot by push() and are processed in place by the
+ * consumer (front() / pop()). A popped element stays in its slot until the
+ * producer overwrites it, i.e. resources released by the assignment are
+ * freed on the producer side and never on the consumer side.
+ */
+template<typename T, std::size_t N>
+class SpscQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "capacity must be a power of two");
+
+public:
+  using value_type = T;
+
+  static constexpr std::size_t capacity() noexcept
+    { return N; }
+
+  // producer interface
+
+  /** Returns false if the queue is full. */
+  template<typename U>
+  bool push(U&& value)
+    {
+      const auto tail = tail_.load(std::memory_order_relaxed);
+      if (tail - head_.load(std::memory_order_acquire) == N)
+        return false;
+
+      slots_[tail & kIndexMask] = std::forward<U>(value);
+      tail_.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+  // consumer interface
+
+  /** Returns the oldest element or nullptr, if the queue is empty. */
+  T* front() noexcept
+    {
+      const auto head = head_.load(std::memory_order_relaxed);
+      if (head == tail_.load(std::memory_order_acquire))
+        return nullptr;
+      else
+        return &slots_[head & kIndexMask];
+    }
+
+  /** Removes the front element (the queue must not be empty). */
+  void pop() noexcept
+    { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+  bool empty() const noexcept
+    { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+
+private:
+  static constexpr std::size_t kIndexMask = N - 1;
+
+  std::array<T, N> slots_;
+
+  alignas(64) std::atomic<std::size_t> head_{0};
+  alignas(64) std::atomic<std::size_t> tail_{0};
+};
+
+#endif//GMetronome_SpscQueue_h
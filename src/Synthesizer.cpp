@@ -24,9 +24,10 @@
 #include "Synthesizer.h"
 
 #include <algorithm>
-#include <functional>
 #include <cmath>
 #include <cassert>
+#include <stdexcept>
+#include <string_view>
 
 #ifndef NDEBUG
 #  include <iostream>
@@ -34,6 +35,131 @@
 
 namespace audio {
 
+  namespace {
+
+    filter::BiquadType biquadType(PercussionFilter type)
+    {
+      switch (type) {
+      case PercussionFilter::kHighpass:
+        return filter::BiquadType::kHighpass;
+      case PercussionFilter::kBandpass:
+        return filter::BiquadType::kBandpass;
+      case PercussionFilter::kLowpass:
+        [[fallthrough]];
+      default:
+        return filter::BiquadType::kLowpass;
+      };
+    }
+
+    // maps the resonance (percent) exponentially to the quality factor
+    // of the filter, starting without a resonance peak
+    float resonanceToQ(float resonance)
+    {
+      constexpr float kMinQ = filter::Biquad<>::kButterworthQ;
+      constexpr float kMaxQ = 10.0f;
+
+      return kMinQ * std::pow(kMaxQ / kMinQ, resonance / 100.0f);
+    }
+
+    // maps the nicks of the settings schema to the shapes
+    // (an unknown nick of a default sound parameter fails to compile)
+    constexpr EnvelopeRampShape rampShape(std::string_view nick)
+    {
+      return nick == "linear" ? EnvelopeRampShape::kLinear
+        : nick == "cubic" ? EnvelopeRampShape::kCubic
+        : nick == "cubic-flipped" ? EnvelopeRampShape::kCubicFlipped
+        : throw std::invalid_argument {"unknown ramp shape"};
+    }
+
+    constexpr EnvelopeHoldShape holdShape(std::string_view nick)
+    {
+      return nick == "keep" ? EnvelopeHoldShape::kKeep
+        : nick == "quartic" ? EnvelopeHoldShape::kQuartic
+        : throw std::invalid_argument {"unknown hold shape"};
+    }
+
+    constexpr EnvelopeRampShape kDefaultToneAttackShape
+      = rampShape(DEFAULT_SOUND_TONE_ATTACK_SHAPE);
+    constexpr EnvelopeHoldShape kDefaultToneHoldShape
+      = holdShape(DEFAULT_SOUND_TONE_HOLD_SHAPE);
+    constexpr EnvelopeRampShape kDefaultToneDecayShape
+      = rampShape(DEFAULT_SOUND_TONE_DECAY_SHAPE);
+    constexpr EnvelopeRampShape kDefaultPercussionAttackShape
+      = rampShape(DEFAULT_SOUND_PERCUSSION_ATTACK_SHAPE);
+    constexpr EnvelopeHoldShape kDefaultPercussionHoldShape
+      = holdShape(DEFAULT_SOUND_PERCUSSION_HOLD_SHAPE);
+    constexpr EnvelopeRampShape kDefaultPercussionDecayShape
+      = rampShape(DEFAULT_SOUND_PERCUSSION_DECAY_SHAPE);
+
+  }//unnamed namespace
+
+  bool operator==(const SoundParameters& lhs, const SoundParameters& rhs)
+  {
+    return lhs.tone_pitch == rhs.tone_pitch
+      && lhs.tone_timbre == rhs.tone_timbre
+      && lhs.tone_detune == rhs.tone_detune
+      && lhs.tone_attack == rhs.tone_attack
+      && lhs.tone_attack_shape == rhs.tone_attack_shape
+      && lhs.tone_hold == rhs.tone_hold
+      && lhs.tone_hold_shape == rhs.tone_hold_shape
+      && lhs.tone_decay == rhs.tone_decay
+      && lhs.tone_decay_shape == rhs.tone_decay_shape
+      && lhs.percussion_filter == rhs.percussion_filter
+      && lhs.percussion_cutoff == rhs.percussion_cutoff
+      && lhs.percussion_resonance == rhs.percussion_resonance
+      && lhs.percussion_attack == rhs.percussion_attack
+      && lhs.percussion_attack_shape == rhs.percussion_attack_shape
+      && lhs.percussion_hold == rhs.percussion_hold
+      && lhs.percussion_hold_shape == rhs.percussion_hold_shape
+      && lhs.percussion_decay == rhs.percussion_decay
+      && lhs.percussion_decay_shape == rhs.percussion_decay_shape
+      && lhs.mix == rhs.mix
+      && lhs.pan == rhs.pan
+      && lhs.volume == rhs.volume;
+  }
+
+  bool operator!=(const SoundParameters& lhs, const SoundParameters& rhs)
+  { return !(lhs==rhs); }
+
+  // the values are defined in configure.ac, which also substitutes
+  // them into the default sound theme (preset-01) of the settings schema
+  SoundParameters defaultSoundParameters(Accent accent)
+  {
+    auto byAccent = [&accent] (float strong, float mid, float weak) {
+      return (accent == kAccentStrong) ? strong : (accent == kAccentMid) ? mid : weak;
+    };
+
+    SoundParameters params;
+    params.tone_pitch = byAccent(DEFAULT_SOUND_TONE_PITCH_STRONG,
+                                 DEFAULT_SOUND_TONE_PITCH_MID,
+                                 DEFAULT_SOUND_TONE_PITCH_WEAK);
+    params.tone_timbre = DEFAULT_SOUND_TONE_TIMBRE;
+    params.tone_detune = DEFAULT_SOUND_TONE_DETUNE;
+    params.tone_attack = DEFAULT_SOUND_TONE_ATTACK;
+    params.tone_attack_shape = kDefaultToneAttackShape;
+    params.tone_hold = DEFAULT_SOUND_TONE_HOLD;
+    params.tone_hold_shape = kDefaultToneHoldShape;
+    params.tone_decay = DEFAULT_SOUND_TONE_DECAY;
+    params.tone_decay_shape = kDefaultToneDecayShape;
+    params.percussion_cutoff = byAccent(DEFAULT_SOUND_PERCUSSION_CUTOFF_STRONG,
+                                        DEFAULT_SOUND_PERCUSSION_CUTOFF_MID,
+                                        DEFAULT_SOUND_PERCUSSION_CUTOFF_WEAK);
+    params.percussion_attack = DEFAULT_SOUND_PERCUSSION_ATTACK;
+    params.percussion_attack_shape = kDefaultPercussionAttackShape;
+    params.percussion_hold = byAccent(DEFAULT_SOUND_PERCUSSION_HOLD_STRONG,
+                                      DEFAULT_SOUND_PERCUSSION_HOLD_MID,
+                                      DEFAULT_SOUND_PERCUSSION_HOLD_WEAK);
+    params.percussion_hold_shape = kDefaultPercussionHoldShape;
+    params.percussion_decay = DEFAULT_SOUND_PERCUSSION_DECAY;
+    params.percussion_decay_shape = kDefaultPercussionDecayShape;
+    params.mix = DEFAULT_SOUND_MIX;
+    params.pan = DEFAULT_SOUND_PAN;
+    params.volume = byAccent(DEFAULT_SOUND_VOLUME_STRONG,
+                             DEFAULT_SOUND_VOLUME_MID,
+                             DEFAULT_SOUND_VOLUME_WEAK);
+    return params;
+  }
+
   Synthesizer::Synthesizer(const StreamSpec& spec)
     : spec_{SampleFormat::kUnknown, 0, 0}
   {
@@ -42,6 +168,13 @@ namespace audio {
     wavetables_.insert(kSawtoothTable, std::make_shared<SawtoothRecipe>());
     wavetables_.insert(kSquareTable, std::make_shared<SquareRecipe>());
 
+    osc_envelope_.reserve(kEnvelopePoints);
+    noise_envelope_.reserve(kEnvelopePoints);
+
+    filter::get<filter::std::Gain>(noise_pipe_).reserve(kEnvelopePoints);
+    filter::get<filter::std::Gain>(noise_fir_pipe_).reserve(kEnvelopePoints);
+    filter::get<5> /* Gain */ (osc_pipe_).reserve(kEnvelopePoints);
+
     prepare(spec);
   }
 
@@ -71,6 +204,7 @@ namespace audio {
 
     // prepare filter pipes
     noise_pipe_.prepare(filter_buffer_spec);
+    noise_fir_pipe_.prepare(filter_buffer_spec);
     osc_pipe_.prepare(filter_buffer_spec);
 
     spec_ = spec;
@@ -107,7 +241,9 @@ namespace audio {
     float osc_decay          = std::clamp(params.tone_decay, 0.0f, 20.0f);
     auto  osc_decay_shape    = params.tone_decay_shape;
 
+    auto  noise_filter       = params.percussion_filter;
     float noise_cutoff       = std::clamp(params.percussion_cutoff, 40.0f, 10000.0f);
+    float noise_resonance    = std::clamp(params.percussion_resonance, 0.0f, 100.0f);
     float noise_attack       = std::clamp(params.percussion_attack, 0.0f, 20.0f);
     auto  noise_attack_shape = params.percussion_attack_shape;
     float noise_hold         = std::clamp(params.percussion_hold, 0.0f, 20.0f);
@@ -129,13 +265,11 @@ namespace audio {
     float sawtooth_gain = osc_gain * std::clamp( 1.0f - std::abs(2.0f - osc_timbre), 0.0f, 1.0f);
     float square_gain   = osc_gain * std::clamp( 1.0f - std::abs(3.0f - osc_timbre), 0.0f, 1.0f);
 
-    auto osc_envelope
-      = buildEnvelope(osc_attack, osc_attack_shape, osc_hold, osc_hold_shape,
-                      osc_decay, osc_decay_shape);
+    buildEnvelope(osc_envelope_, osc_attack, osc_attack_shape,
+                  osc_hold, osc_hold_shape, osc_decay, osc_decay_shape);
 
-    auto noise_envelope
-      = buildEnvelope(noise_attack, noise_attack_shape, noise_hold, noise_hold_shape,
-                      noise_decay, noise_decay_shape);
+    buildEnvelope(noise_envelope_, noise_attack, noise_attack_shape,
+                  noise_hold, noise_hold_shape, noise_decay, noise_decay_shape);
 
     filter::std::Wave::Parameters sine_params =
       {
@@ -166,20 +300,34 @@ namespace audio {
         osc_detune
       };
 
-    // configure noise pipe
-    filter::get<filter::std::Noise>   (noise_pipe_).setAmplitude (noise_gain);
-    filter::get<filter::std::Lowpass> (noise_pipe_).setCutoff (noise_cutoff);
-    filter::get<filter::std::Gain>    (noise_pipe_).setEnvelope (std::move(noise_envelope));
+    if (noise_filter == PercussionFilter::kFirLowpass)
+    {
+      // configure and apply FIR noise pipe
+      filter::get<filter::std::Noise>   (noise_fir_pipe_).setAmplitude (noise_gain);
+      filter::get<filter::std::Lowpass> (noise_fir_pipe_).setCutoff (noise_cutoff);
+      filter::get<filter::std::Gain>    (noise_fir_pipe_).setEnvelope (noise_envelope_);
 
-    // apply noise pipe
-    noise_pipe_.process(noise_buffer_);
+      noise_fir_pipe_.process(noise_buffer_);
+    }
+    else
+    {
+      // configure noise pipe
+      filter::get<filter::std::Noise>   (noise_pipe_).setAmplitude (noise_gain);
+      filter::get<filter::std::Biquad>  (noise_pipe_).setType (biquadType(noise_filter));
+      filter::get<filter::std::Biquad>  (noise_pipe_).setCutoff (noise_cutoff);
+      filter::get<filter::std::Biquad>  (noise_pipe_).setResonance (resonanceToQ(noise_resonance));
+      filter::get<filter::std::Gain>    (noise_pipe_).setEnvelope (noise_envelope_);
+
+      // apply noise pipe
+      noise_pipe_.process(noise_buffer_);
+    }
 
     // configure oscillator pipe
     filter::get<1> /* Wave */ (osc_pipe_).setParameters(sine_params);
     filter::get<2> /* Wave */ (osc_pipe_).setParameters(triangle_params);
     filter::get<3> /* Wave */ (osc_pipe_).setParameters(sawtooth_params);
     filter::get<4> /* Wave */ (osc_pipe_).setParameters(square_params);
-    filter::get<5> /* Gain */ (osc_pipe_).setEnvelope(std::move(osc_envelope));
+    filter::get<5> /* Gain */ (osc_pipe_).setEnvelope(osc_envelope_);
     filter::get<6> /* Mix  */ (osc_pipe_).setBuffer(&noise_buffer_);
     filter::get<6>            (osc_pipe_).setGain(gain);
     filter::get<6>            (osc_pipe_).setPan( pan / 100.0f );
@@ -199,52 +347,41 @@ namespace audio {
     constexpr float flip(float arg)
     { return 1.0f - arg; }
 
-    std::function<float(float)> shapeProjection(EnvelopeRampShape shape)
-    {
-      std::function<float(float)> proj;
+    using Projection = float (*)(float);
 
+    Projection shapeProjection(EnvelopeRampShape shape)
+    {
       switch (shape) {
       case EnvelopeRampShape::kCubic:
-        proj = cube;
-        break;
+        return cube;
       case EnvelopeRampShape::kCubicFlipped:
-        proj = [] (float arg) { return flip(cube(flip(arg))); };
-        break;
+        return [] (float arg) { return flip(cube(flip(arg))); };
       case EnvelopeRampShape::kLinear:
         [[fallthrough]];
       default:
         // when switching to C++20 use std::identity
-        proj = [] (float arg) { return arg; };
-        break;
+        return [] (float arg) { return arg; };
       };
-
-      return proj;
     }
 
-    std::function<float(float)> shapeProjection(EnvelopeHoldShape shape)
+    Projection shapeProjection(EnvelopeHoldShape shape)
     {
-      std::function<float(float)> proj;
-
       switch (shape) {
       case EnvelopeHoldShape::kQuartic:
-        proj = [] (float arg) { return std::pow(2.0f * arg - 1.0f, 4.0f); };
-        break;
+        return [] (float arg) { return std::pow(2.0f * arg - 1.0f, 4.0f); };
       case EnvelopeHoldShape::kKeep:
         [[fallthrough]];
       default:
-        proj = [] (float arg) { return 1.0f; };
-        break;
+        return [] (float arg) { return 1.0f; };
       };
-
-      return proj;
     }
 
   }//unnnamed namespace
 
-  filter::Automation
-  Synthesizer::buildEnvelope(float attack, EnvelopeRampShape attack_shape,
-                             float hold, EnvelopeHoldShape hold_shape,
-                             float decay, EnvelopeRampShape decay_shape) const
+  void Synthesizer::buildEnvelope(filter::Automation& envelope,
+                                  float attack, EnvelopeRampShape attack_shape,
+                                  float hold, EnvelopeHoldShape hold_shape,
+                                  float decay, EnvelopeRampShape decay_shape) const
   {
     using milliseconds_dbl = std::chrono::duration<double, std::milli>;
 
@@ -256,14 +393,15 @@ namespace audio {
     const auto hold_step_tm = (hold_tm - attack_tm) / 5.0;
     const auto decay_step_tm = (decay_tm - hold_tm) / 5.0;
 
-    std::function<float(float)> attack_proj = shapeProjection(attack_shape);
-    std::function<float(float)> hold_proj = shapeProjection(hold_shape);
-    std::function<float(float)> decay_proj = shapeProjection(decay_shape);
+    auto attack_proj = shapeProjection(attack_shape);
+    auto hold_proj = shapeProjection(hold_shape);
+    auto decay_proj = shapeProjection(decay_shape);
 
-    filter::Automation envelope {{0ms, 0.0f}};
+    envelope.clear();
+    envelope.append({{0ms, 0.0f}});
 
     if (attack_tm == 0ms && hold_tm == 0ms && decay_tm == 0ms )
-      return envelope;
+      return;
 
     if (attack_tm > 0ms)
     {
@@ -302,8 +440,6 @@ namespace audio {
         });
     }
     else envelope.append({{decay_tm, 0.0f}});
-
-    return envelope;
   }
 
 }//namespace audio
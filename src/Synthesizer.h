@@ -24,6 +24,7 @@
 #include "Filter.h"
 #include "AudioBuffer.h"
 #include "WavetableLibrary.h"
+#include "Meter.h"
 
 #include <tuple>
 
@@ -47,6 +48,14 @@ namespace audio {
     kQuartic = 4
   };
 
+  enum class PercussionFilter
+  {
+    kLowpass = 0,
+    kHighpass = 1,
+    kBandpass = 2,
+    kFirLowpass = 3   // windowed-sinc lowpass (no resonance)
+  };
+
   struct SoundParameters
   {
     float             tone_pitch        {1000.0f};                     // [40.0f, 10000.0f] (hertz)
@@ -59,7 +68,9 @@ namespace audio {
     float             tone_decay        {10.0f};                       // [0.0f, 20.0f] (ms)
     EnvelopeRampShape tone_decay_shape  {EnvelopeRampShape::kLinear};
 
+    PercussionFilter  percussion_filter       {PercussionFilter::kLowpass};
     float             percussion_cutoff       {1000.0f};               // [40.0f, 10000.0f] (hertz)
+    float             percussion_resonance    {0.0f};                  // [0.0f, 100.0f] (percent)
     float             percussion_attack       {10.0f};                 // [0.0f, 20.0f] (ms)
     EnvelopeRampShape percussion_attack_shape {EnvelopeRampShape::kLinear};
     float             percussion_hold         {10.0};                  // [0.0f, 20.0f] (ms)
@@ -72,6 +83,17 @@ namespace audio {
     float volume  {75.0f};   // [   0.0f, 100.0f] (percent)
   };
 
+  bool operator==(const SoundParameters& lhs, const SoundParameters& rhs);
+  bool operator!=(const SoundParameters& lhs, const SoundParameters& rhs);
+
+  /**
+   * The sound parameters of an accent in the default sound theme of the
+   * application. The values are defined in configure.ac, which also
+   * substitutes them into the preset-01 schema. Used by programs that run
+   * without the settings of the application, e.g. gmetronome-render.
+   */
+  SoundParameters defaultSoundParameters(Accent accent);
+
   /**
    * Without mixing capabilities the time gap between two consecutive clicks
    * at maximum tempo (250 bpm) with the maximum number of beat division (4)
@@ -120,12 +142,22 @@ namespace audio {
     using NoiseFilterPipe = decltype(
         filter::std::Zero()
       | filter::std::Noise()
-      | filter::std::Lowpass()
+      | filter::std::Biquad()
       | filter::std::Gain()
     );
 
     NoiseFilterPipe noise_pipe_;
 
+    // the former noise filter (see PercussionFilter::kFirLowpass)
+    using NoiseFIRFilterPipe = decltype(
+        filter::std::Zero()
+      | filter::std::Noise()
+      | filter::std::Lowpass()
+      | filter::std::Gain()
+    );
+
+    NoiseFIRFilterPipe noise_fir_pipe_;
+
     using OscFilterPipe = decltype(
         filter::std::Zero()
       | filter::std::Wave() // Sine
@@ -138,9 +170,17 @@ namespace audio {
 
     OscFilterPipe osc_pipe_;
 
-    filter::Automation buildEnvelope(float attack, EnvelopeRampShape attack_shape,
-                                     float hold, EnvelopeHoldShape hold_shape,
-                                     float decay, EnvelopeRampShape decay_shape) const;
+    // maximum number of envelope points (see buildEnvelope)
+    static constexpr size_t kEnvelopePoints = 16;
+
+    // preallocated envelopes to keep update() free of allocations
+    filter::Automation osc_envelope_;
+    filter::Automation noise_envelope_;
+
+    void buildEnvelope(filter::Automation& envelope,
+                       float attack, EnvelopeRampShape attack_shape,
+                       float hold, EnvelopeHoldShape hold_shape,
+                       float decay, EnvelopeRampShape decay_shape) const;
   };
 
 }//namespace audio
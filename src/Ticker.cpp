@@ -22,9 +22,12 @@
 #endif
 
 #include "Ticker.h"
+#include "AllocGuard.h"
+#include "RealtimeKit.h"
 
 #include <glib.h>
 #include <algorithm>
+#include <cstring>
 #include <cassert>
 
 #ifndef NDEBUG
@@ -37,6 +40,38 @@ namespace audio {
 
     constexpr microseconds  kSwapBackendTimeout = 1s;
 
+    // maximum time to wait for the sounds of a new stream specification
+    // before a gapless switch (see framesToSwitch)
+    constexpr microseconds  kSwitchRenderTimeout = 1s;
+
+    // a gapless switch waits for the next beat, but not longer than the
+    // current beat delay plus this margin (e.g. if the tempo decreases)
+    constexpr microseconds  kSwitchBeatMargin = 250ms;
+
+    // upper bound of the beat delay (a beat at 30 bpm takes 2 s)
+    constexpr microseconds  kSwitchMaxBeatDelay = 3s;
+
+    // interval to check for switches that were completed by the audio thread
+    constexpr microseconds  kSwitchPollInterval = 20ms;
+
+    // interval to check for control requests (stop, backend swap) while
+    // the backend pulls the audio data from the render callback
+    constexpr microseconds  kPullModePollInterval = 20ms;
+
+    using Clock = std::chrono::steady_clock;
+
+    // sounds are rendered with unity gain, the actual volume is applied
+    // by the stream controller
+    constexpr float kUnityVolume = 100.0f;
+
+    // the queue of the device plus the chunk in progress (push mode)
+    size_t historyFrames(const DeviceConfig& config)
+    {
+      const auto& params = latencyParameters(config.latency);
+      return std::max(config.buffer_frames, usecsToFrames(params.buffer, config.spec))
+        + usecsToFrames(params.max_chunk, config.spec);
+    }
+
   }//unnamed namespace
 
   // Ticker
@@ -44,11 +79,25 @@ namespace audio {
     : backend_ {createBackend(BackendIdentifier::kNone)}
   {
     swap_backend_flag_.test_and_set();
+
+    for (auto accent : {kAccentWeak, kAccentMid, kAccentStrong})
+      setSound(accent, SoundParameters{});
+
+    switch_thread_ = std::thread(&Ticker::switchThreadFunction, this);
   }
 
   Ticker::~Ticker()
   {
     reset();
+
+    {
+      std::lock_guard<std::mutex> guard(switch_mutex_);
+      switch_quit_ = true;
+    }
+    switch_cond_var_.notify_one();
+
+    if (switch_thread_.joinable())
+      switch_thread_.join();
   }
 
   std::unique_ptr<Backend> Ticker::getBackend(const microseconds& timeout)
@@ -75,20 +124,34 @@ namespace audio {
     // otherwise we try to synchronize the threads with a conditional variable
     // to prevent data races during the swap operation.
 
+    // a pending gapless switch is superseded by this one
+    cancelSwitch();
+
     if (auto s = state();
         s.test(Ticker::StateFlag::kRunning)
-        && ( ! s.test(Ticker::StateFlag::kStarted) || s.test(Ticker::StateFlag::kError) ) )
+        && ( ( ! s.test(Ticker::StateFlag::kStarted) && ! idling_ )
+             || s.test(Ticker::StateFlag::kError) ) )
     {
       stopAudioThread(true); // join
+      idling_ = false;
     }
 
     if ( state().test(Ticker::StateFlag::kRunning) )
     {
+      // switch to the new device while the old one keeps playing
+      if (backend && gaplessSwapBackend(backend))
+        return;
+
       std::unique_lock<SpinLock> lck(spin_mutex_);
 
       // initiate backend swap
       swap_backend_flag_.clear(std::memory_order_release);
 
+      // interrupt a blocking write (the audio thread can not replace the
+      // backend while we hold the lock)
+      if (backend_)
+        backend_->wakeup();
+
       // wait for the audio thread to be ready
       ready_to_swap_ = false;
       bool success =  cond_var_.wait_for( lck, timeout, [&] { return ready_to_swap_; });
@@ -129,13 +192,44 @@ namespace audio {
       std::rethrow_exception(audio_thread_error_);
     }
 
+    // the audio thread sees the request time along with the request
+    start_request_time_.store(Clock::now().time_since_epoch().count(),
+                              std::memory_order_relaxed);
+
+    if (idling_)
+    {
+      // The audio thread is waiting in standby mode with a primed backend,
+      // so we just deliver the backlog and let the stream play.
+      flushCommands();
+
+      out_info_.update();
+      consumed_sequence_ = out_info_.front().sequence;
+
+      idling_ = false;
+      pause_flag_.store(false, std::memory_order_relaxed);
+      play_flag_.store(true, std::memory_order_release);
+
+      state_.reset(Ticker::StateFlag::kPaused);
+      state_.set(Ticker::StateFlag::kStarted);
+      return;
+    }
+
     if (current_state.test(Ticker::StateFlag::kRunning))
       stopAudioThread(true); // join
 
-    has_info_ = false;
+    // No audio thread is running at this point, so we can take over the
+    // consumer side of the command queue and make room for the backlog.
+    stageCommands();
+    flushCommands();
+
+    // discard the status frames of the previous run
+    out_info_.update();
+    consumed_sequence_ = out_info_.front().sequence;
 
+    play_flag_.store(true, std::memory_order_relaxed);
     startAudioThread();
 
+    state_.reset(Ticker::StateFlag::kPaused);
     state_.set(Ticker::StateFlag::kStarted);
   }
 
@@ -149,10 +243,20 @@ namespace audio {
       std::rethrow_exception(audio_thread_error_);
     }
 
-    if (current_state.test(Ticker::StateFlag::kRunning))
-      stopAudioThread(false); // do not join
+    if (current_state.test(Ticker::StateFlag::kRunning) && !idling_)
+    {
+      if (standby_ && current_state.test(Ticker::StateFlag::kStarted))
+      {
+        // keep the audio thread and the backend running
+        pause_flag_.store(false, std::memory_order_relaxed);
+        play_flag_.store(false, std::memory_order_release);
+        idling_ = true;
+      }
+      else stopAudioThread(false); // do not join
+    }
 
     state_.reset(Ticker::StateFlag::kStarted);
+    state_.reset(Ticker::StateFlag::kPaused);
   }
 
   void Ticker::reset() noexcept
@@ -160,6 +264,9 @@ namespace audio {
     try {
       if (audio_thread_) stopAudioThread(true); // join
 
+      idling_ = false;
+      play_flag_.store(false, std::memory_order_relaxed);
+      pause_flag_.store(false, std::memory_order_relaxed);
       state_.reset();
       audio_thread_error_ = nullptr;
       audio_thread_error_flag_.store(false, std::memory_order_release);
@@ -169,6 +276,72 @@ namespace audio {
     }
   }
 
+  void Ticker::setStandby(bool enable)
+  {
+    standby_ = enable;
+
+    auto current_state = state();
+
+    // while the metronome is started the mode takes effect with stop()
+    if (current_state.test(Ticker::StateFlag::kStarted)
+        || current_state.test(Ticker::StateFlag::kError))
+      return;
+
+    if (enable && !idling_)
+    {
+      if (current_state.test(Ticker::StateFlag::kRunning))
+        stopAudioThread(true); // join
+
+      stageCommands();
+      flushCommands();
+
+      play_flag_.store(false, std::memory_order_relaxed);
+      startAudioThread();
+
+      idling_ = true;
+    }
+    else if (!enable && idling_)
+    {
+      stopAudioThread(false); // do not join
+      idling_ = false;
+    }
+  }
+
+  void Ticker::pause()
+  {
+    auto current_state = state();
+
+    if (current_state.test(Ticker::StateFlag::kError))
+    {
+      assert(audio_thread_error_ != nullptr);
+      std::rethrow_exception(audio_thread_error_);
+    }
+
+    if (!current_state.test(Ticker::StateFlag::kStarted)
+        || current_state.test(Ticker::StateFlag::kPaused))
+      return;
+
+    pause_flag_.store(true, std::memory_order_release);
+    state_.set(Ticker::StateFlag::kPaused);
+  }
+
+  void Ticker::resume()
+  {
+    auto current_state = state();
+
+    if (current_state.test(Ticker::StateFlag::kError))
+    {
+      assert(audio_thread_error_ != nullptr);
+      std::rethrow_exception(audio_thread_error_);
+    }
+
+    if (!current_state.test(Ticker::StateFlag::kPaused))
+      return;
+
+    pause_flag_.store(false, std::memory_order_release);
+    state_.reset(Ticker::StateFlag::kPaused);
+  }
+
   Ticker::State Ticker::state() const noexcept
   {
     Ticker::State out_state = state_;
@@ -181,107 +354,281 @@ namespace audio {
 
   void Ticker::setTempo(double tempo)
   {
-    std::lock_guard<SpinLock> guard(spin_mutex_);
-
-    in_tempo_ = tempo;
-
-    in_ops_.reset (kOpFlagSync);
-    in_ops_.set   (kOpFlagTempo);
+    Command cmd;
+    cmd.op = kOpFlagTempo;
+    cmd.tempo = tempo;
+    pushCommand(std::move(cmd));
   }
 
   void Ticker::setCountIn(int count_in)
   {
-    std::lock_guard<SpinLock> guard(spin_mutex_);
-    in_count_in_ = count_in;
-    in_ops_.set   (kOpFlagCountIn);
+    Command cmd;
+    cmd.op = kOpFlagCountIn;
+    cmd.count_in = count_in;
+    pushCommand(std::move(cmd));
   }
 
   void Ticker::accelerate(double accel, double target)
   {
-    std::lock_guard<SpinLock> guard(spin_mutex_);
-
-    in_accel_ = accel;
-    in_target_ = target;
-
-    in_ops_ &= ~kOpMaskAccel;
-    in_ops_.set(kOpFlagAccelCS);
+    Command cmd;
+    cmd.op = kOpFlagAccelCS;
+    cmd.accel = accel;
+    cmd.target = target;
+    pushCommand(std::move(cmd));
   }
 
   void Ticker::accelerate(int hold, double step, double target)
   {
-    std::lock_guard<SpinLock> guard(spin_mutex_);
+    Command cmd;
+    cmd.op = kOpFlagAccelSW;
+    cmd.hold = hold;
+    cmd.step = step;
+    cmd.target = target;
+    pushCommand(std::move(cmd));
+  }
 
-    in_hold_ = hold;
-    in_step_ = step;
-    in_target_ = target;
+  void Ticker::stopAcceleration()
+  {
+    Command cmd;
+    cmd.op = kOpFlagAccelSP;
+    pushCommand(std::move(cmd));
+  }
 
-    in_ops_ &= ~kOpMaskAccel;
-    in_ops_.set(kOpFlagAccelSW);
+  void Ticker::synchronize(double beats, double tempo, microseconds time)
+  {
+    Command cmd;
+    cmd.op = kOpFlagSync;
+    cmd.sync_beats = beats;
+    cmd.tempo = tempo;
+    cmd.sync_time = time;
+    pushCommand(std::move(cmd));
   }
 
-  void Ticker::stopAcceleration()
+  void Ticker::setMeter(Meter meter)
   {
-    std::lock_guard<SpinLock> guard(spin_mutex_);
+    Command cmd;
+    cmd.op = kOpFlagMeter;
+    cmd.meter = std::move(meter);
+    pushCommand(std::move(cmd));
+  }
 
-    in_ops_ &= ~kOpMaskAccel;
-    in_ops_.set(kOpFlagAccelSP);
+  void Ticker::resetMeter()
+  {
+    Command cmd;
+    cmd.op = kOpFlagMeterReset;
+    pushCommand(std::move(cmd));
   }
 
-  void Ticker::synchronize(double beats, double tempo, microseconds time)
+  void Ticker::setSound(Accent accent, const SoundParameters& params)
   {
-    std::lock_guard<SpinLock> guard(spin_mutex_);
+    if (params.volume != sound_volume_[accent])
+    {
+      sound_volume_[accent] = params.volume;
+
+      Command cmd;
+      cmd.op = kOpFlagSoundVolume;
+      cmd.sound_volume = sound_volume_;
+      pushCommand(std::move(cmd));
+    }
 
-    in_sync_beats_ = beats;
-    in_sync_tempo_ = tempo;
-    in_sync_time_ = time;
+    SoundParameters timbre = params;
+    timbre.volume = kUnityVolume;
 
-    in_ops_.set(kOpFlagSync);
+    sound_renderer_.setSound(accent, timbre);
   }
 
-  void Ticker::setMeter(Meter meter)
+  void Ticker::setVolume(double volume)
   {
-    std::lock_guard<SpinLock> guard(spin_mutex_);
+    Command cmd;
+    cmd.op = kOpFlagVolume;
+    cmd.volume = volume;
+    pushCommand(std::move(cmd));
+  }
 
-    std::swap(in_meter_, meter);
+  void Ticker::setCommandCoalescing(bool enable)
+  {
+    coalesce_commands_.store(enable, std::memory_order_relaxed);
+  }
 
-    in_ops_ &= ~kOpMaskMeter;
-    in_ops_.set(kOpFlagMeter);
+  void Ticker::setSoundCacheBudget(std::size_t budget)
+  {
+    sound_renderer_.setCacheBudget(budget);
   }
 
-  void Ticker::resetMeter()
+  Ticker::Stats Ticker::stats() const
   {
-    std::lock_guard<SpinLock> guard(spin_mutex_);
+    Stats stats;
+    stats.cycles = stats_.cycles.load(std::memory_order_relaxed);
+    stats.xruns = stats_.xruns.load(std::memory_order_relaxed);
+    stats.deferred_commands = stats_.deferred_commands.load(std::memory_order_relaxed);
+    stats.cycle_time = stats_.cycle_time.snapshot();
+    stats.write_time = stats_.write_time.snapshot();
+    stats.buffer_fill = stats_.buffer_fill.snapshot();
+    stats.render_time = sound_renderer_.renderTime();
+    auto cache_stats = sound_renderer_.cacheStats();
+    stats.sound_cache_hits = cache_stats.hits;
+    stats.sound_cache_misses = cache_stats.misses;
+    stats.first_click = stats_.first_click.snapshot();
+    stats.alloc_violations = AllocGuard::violations()
+      - stats_.alloc_violations_base.load(std::memory_order_relaxed);
+    return stats;
+  }
 
-    in_ops_ &= ~kOpMaskMeter;
-    in_ops_.set(kOpFlagMeterReset);
+  void Ticker::resetStats()
+  {
+    stats_.cycles.store(0, std::memory_order_relaxed);
+    stats_.xruns.store(0, std::memory_order_relaxed);
+    stats_.deferred_commands.store(0, std::memory_order_relaxed);
+    stats_.cycle_time.reset();
+    stats_.write_time.reset();
+    stats_.buffer_fill.reset();
+    stats_.first_click.reset();
+    stats_.alloc_violations_base.store(AllocGuard::violations(), std::memory_order_relaxed);
+    sound_renderer_.resetRenderTime();
+    sound_renderer_.resetCacheStats();
   }
 
-  void Ticker::setSound(Accent accent, const SoundParameters& params)
+  bool Ticker::transport(Transport& transport)
   {
-    std::lock_guard<SpinLock> guard(spin_mutex_);
+    std::lock_guard<SpinLock> lck(spin_mutex_);
+    return backend_ ? backend_->transport(transport) : false;
+  }
 
-    in_sounds_[accent] = params;
+  void Ticker::setRealtime(bool enable)
+  {
+    realtime_.store(enable, std::memory_order_relaxed);
+  }
 
-    in_ops_.set(kOpFlagSoundOff + accent);
+  RealtimeStatus Ticker::realtimeStatus() const
+  {
+    std::lock_guard<std::mutex> guard(realtime_mutex_);
+    return realtime_status_;
   }
 
-  Ticker::Info Ticker::getInfo() const
+  bool Ticker::flush()
   {
-    std::lock_guard<SpinLock> guard(spin_mutex_);
-    return out_info_;
+    flushCommands();
+    return !backlog_.empty();
   }
 
   Ticker::Info Ticker::getInfo(bool consume)
   {
-    std::lock_guard<SpinLock> guard(spin_mutex_);
-    has_info_ = has_info_ && !consume;
-    return out_info_;
+    out_info_.update();
+
+    const auto& info = out_info_.front();
+
+    if (consume)
+      consumed_sequence_ = info.sequence;
+
+    return info;
   }
 
   bool Ticker::hasInfo() const
   {
-    std::lock_guard<SpinLock> guard(spin_mutex_);
-    return has_info_;
+    return out_info_.pending() || out_info_.front().sequence > consumed_sequence_;
+  }
+
+  Ticker::OpFlags Ticker::supersededOps(OpFlag op)
+  {
+    switch (op)
+    {
+    case kOpFlagTempo:
+      return OpFlags{}.set(kOpFlagTempo).set(kOpFlagSync);
+    case kOpFlagAccelCS:
+      [[fallthrough]];
+    case kOpFlagAccelSW:
+      [[fallthrough]];
+    case kOpFlagAccelSP:
+      return kOpMaskAccel;
+    case kOpFlagMeter:
+      [[fallthrough]];
+    case kOpFlagMeterReset:
+      return kOpMaskMeter;
+    default:
+      return OpFlags{}.set(op);
+    }
+  }
+
+  void Ticker::pushCommand(Command cmd)
+  {
+    flushCommands();
+
+    if (backlog_.empty() && in_queue_.push(std::move(cmd)))
+      return;
+
+    // The queue is full (e.g. the audio thread is not running), so we keep
+    // the command on our side. Since all commands in the backlog are newer
+    // than the queued ones, we can drop the superseded commands to keep the
+    // backlog small without affecting the outcome.
+    auto superseded = supersededOps(cmd.op);
+    backlog_.erase(std::remove_if(backlog_.begin(), backlog_.end(),
+                                  [&] (const auto& c) { return superseded.test(c.op); }),
+                   backlog_.end());
+
+    backlog_.push_back(std::move(cmd));
+
+    stats_.deferred_commands.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void Ticker::flushCommands()
+  {
+    auto it = backlog_.begin();
+    while (it != backlog_.end() && in_queue_.push(std::move(*it)))
+      ++it;
+
+    backlog_.erase(backlog_.begin(), it);
+  }
+
+  void Ticker::stageCommand(Command& cmd)
+  {
+    switch (cmd.op)
+    {
+    case kOpFlagTempo:
+      in_tempo_ = cmd.tempo;
+      break;
+    case kOpFlagCountIn:
+      in_count_in_ = cmd.count_in;
+      break;
+    case kOpFlagAccelCS:
+      in_accel_ = cmd.accel;
+      in_target_ = cmd.target;
+      break;
+    case kOpFlagAccelSW:
+      in_hold_ = cmd.hold;
+      in_step_ = cmd.step;
+      in_target_ = cmd.target;
+      break;
+    case kOpFlagSync:
+      in_sync_beats_ = cmd.sync_beats;
+      in_sync_tempo_ = cmd.tempo;
+      in_sync_time_ = cmd.sync_time;
+      break;
+    case kOpFlagMeter:
+      // the previous meter is left in the queue slot and will be
+      // destroyed by the producer (no deallocation on the audio thread)
+      std::swap(in_meter_, cmd.meter);
+      break;
+    case kOpFlagVolume:
+      in_volume_ = cmd.volume;
+      break;
+    case kOpFlagSoundVolume:
+      in_sound_volume_ = cmd.sound_volume;
+      break;
+    default:
+      break;
+    }
+
+    in_ops_ &= ~supersededOps(cmd.op);
+    in_ops_.set(cmd.op);
+  }
+
+  void Ticker::stageCommands()
+  {
+    while (Command* cmd = in_queue_.front())
+    {
+      stageCommand(*cmd);
+      in_queue_.pop();
+    }
   }
 
   void Ticker::startAudioThread()
@@ -289,6 +636,10 @@ namespace audio {
     assert( audio_thread_ == nullptr );
 
     try {
+      render_error_ = nullptr;
+      render_error_flag_.store(false, std::memory_order_relaxed);
+      pause_flag_.store(false, std::memory_order_relaxed);
+
       continue_audio_thread_flag_.test_and_set();
       audio_thread_finished_flag_ = false;
       state_.set(Ticker::StateFlag::kRunning);
@@ -311,6 +662,8 @@ namespace audio {
 
     continue_audio_thread_flag_.clear();
 
+    wakeupBackend();
+
     if (join && audio_thread_->joinable())
     {
       // To prevent freezing of the ui thread in case of a non-responding audio thread
@@ -340,13 +693,24 @@ namespace audio {
     }
   }
 
+  void Ticker::wakeupBackend()
+  {
+    // the backend is only replaced by the audio thread while holding
+    // the lock during a swap operation (see syncSwapBackend)
+    std::lock_guard<SpinLock> lck(spin_mutex_);
+    if (backend_)
+      backend_->wakeup();
+  }
+
   void Ticker::openBackend()
   {
     assert (backend_ != nullptr);
     switch (backend_->state())
     {
     case BackendState::kConfig:
+      backend_->setRenderCallback(&renderer_);
       actual_device_config_ = backend_->open();
+      backend_xruns_ = 0;
       if (actual_device_config_.spec.channels <= 0)
         throw GMetronomeError {"Unsupported audio device (invalid number of channels)"};
       if (actual_device_config_.spec.rate <= 0)
@@ -362,6 +726,28 @@ namespace audio {
     }
   }
 
+  void Ticker::prepareBackend()
+  {
+    openBackend(); // updates actual_device_config_
+    stream_ctrl_.prepare(actual_device_config_.spec,
+                         actual_device_config_.latency,
+                         actual_device_config_.period_frames);
+    sound_renderer_.prepare(actual_device_config_.spec);
+    prepareHistory();
+
+    accel_defer_timer_.switchStreamSpec(actual_device_config_.spec);
+
+    // the stream buffers were reallocated
+    if (realtime_status_.enabled)
+    {
+      RealtimeStatus status = realtime_status_;
+      status.memory_locked = lockWorkingSet();
+      setRealtimeStatus(status);
+    }
+
+    startBackend();
+  }
+
   void Ticker::closeBackend()
   {
     assert (backend_ != nullptr);
@@ -422,7 +808,97 @@ namespace audio {
   {
     assert(backend_ != nullptr);
     if (bytes > 0)
-      backend_->write(data, bytes);
+    {
+      auto start = Clock::now();
+      size_t written = backend_->write(data, bytes);
+      stats_.write_time.record(Clock::now() - start);
+
+      recordHistory(data, written);
+    }
+  }
+
+  void Ticker::prepareHistory()
+  {
+    const auto& spec = actual_device_config_.spec;
+
+    const size_t frames = backend_->mode() == BackendMode::kPush
+      ? historyFrames(actual_device_config_) : 0;
+
+    history_ = ByteBuffer(spec, frames * frameSize(spec));
+    history_pos_ = 0;
+
+    fade_buffer_ = ByteBuffer(spec, frames > 0 ? usecsToBytes(kFadeOutTime, spec) : 0);
+    crossfade_buffer_ = ByteBuffer(spec, fade_buffer_.size());
+  }
+
+  void Ticker::recordHistory(const void* data, size_t bytes)
+  {
+    const size_t size = history_.size();
+    if (size == 0)
+      return;
+
+    auto in = static_cast<const ByteBuffer::value_type*>(data);
+    if (bytes > size)
+    {
+      in += bytes - size;
+      bytes = size;
+    }
+
+    const size_t head = std::min(bytes, size - history_pos_);
+    std::memcpy(history_.data() + history_pos_, in, head);
+    std::memcpy(history_.data(), in + head, bytes - head);
+
+    history_pos_ = (history_pos_ + bytes) % size;
+  }
+
+  void Ticker::fadeOutBackend()
+  {
+    assert(backend_ != nullptr);
+
+    if (backend_->state() != BackendState::kRunning)
+      return;
+
+    if (backend_->mode() == BackendMode::kPull)
+    {
+      // let the render callback fade out the stream (see importPlayback)
+      // and wait until the fade is audible
+      pause_flag_.store(true, std::memory_order_release);
+
+      const auto& params = latencyParameters(actual_device_config_.latency);
+      std::this_thread::sleep_for(VoiceMixer::kGainRampTime + params.period
+                                  + backend_->latency());
+      return;
+    }
+
+    if (history_.empty())
+      return;
+
+    const auto& spec = actual_device_config_.spec;
+    const size_t frame_size = frameSize(spec);
+
+    // the queued data is the most recent part of the history
+    size_t queued = std::min(usecsToBytes(backend_->latency(), spec), history_.size());
+    queued -= queued % frame_size;
+
+    const size_t fade_bytes = std::min(queued, fade_buffer_.size());
+
+    size_t pos = (history_pos_ + history_.size() - queued) % history_.size();
+    const size_t head = std::min(fade_bytes, history_.size() - pos);
+    std::memcpy(fade_buffer_.data(), history_.data() + pos, head);
+    std::memcpy(fade_buffer_.data() + head, history_.data(), fade_bytes - head);
+
+    rampGain(fade_buffer_.data(), fade_bytes / frame_size, spec, 1.0f, 0.0f);
+
+    // a wakeup (see stopAudioThread) must not interrupt the faded tail
+    std::lock_guard<SpinLock> lck(spin_mutex_);
+
+    backend_->flush();
+
+    if (fade_bytes > 0)
+      backend_->write(fade_buffer_.data(), fade_bytes);
+
+    history_pos_ = 0;
+    std::fill(history_.begin(), history_.end(), 0);
   }
 
   bool Ticker::syncSwapBackend()
@@ -446,7 +922,6 @@ namespace audio {
     lck.lock();
     bool success = cond_var_.wait_for(lck, kSwapBackendTimeout,
                                       [&] {return backend_swapped_;});
-    lck.unlock();
 
     // check the (possibly) new backend and (re-)install
     // the dummy backend if necessary
@@ -455,6 +930,7 @@ namespace audio {
       backend_ = std::move(dummy_);
       using_dummy_ = true;
     }
+    lck.unlock();
 
     return success;
   }
@@ -478,88 +954,534 @@ namespace audio {
     }
   }
 
-  bool Ticker::importBackend()
+  bool Ticker::gaplessSwapBackend(std::unique_ptr<Backend>& backend)
   {
-    if (!swap_backend_flag_.test_and_set(std::memory_order_acquire))
+    if (backend->mode() != BackendMode::kPush || backend->state() != BackendState::kConfig)
+      return false;
+
     {
-      closeBackend();
-      return syncSwapBackend();
+      std::lock_guard<SpinLock> lck(spin_mutex_);
+      if (using_dummy_ || !backend_ || backend_->mode() != BackendMode::kPush)
+        return false;
     }
-    else return false;
-  }
-
-  void Ticker::deferAccel(microseconds time)
-  {
-    accel_defer_timer_.start(time);
-  }
-
-  bool Ticker::tryAmendAccel(bool force)
-  {
-    if (!isAccelDeferred())
-      return true;
-
-    std::unique_lock<SpinLock> lck(spin_mutex_, std::defer_lock);
 
-    if (force)
-      lck.lock();
-    else
-      static_cast<void>(lck.try_lock()); // try_lock has [[nodiscard]]
-
-    if (lck.owns_lock())
+    // the switch thread opens the new device (see switchThreadFunction)
     {
-      importAccelModeParams();
-      accel_defer_timer_.reset();
-
-      return true;
+      std::lock_guard<std::mutex> guard(switch_mutex_);
+      in_switch_backend_ = std::move(backend);
     }
-    else return false;
-  }
+    switch_cond_var_.notify_one();
 
-  void Ticker::abortAccelDefer()
-  {
-    accel_defer_timer_.reset();
+    return true;
   }
 
-  void Ticker::importTempo()
+  void Ticker::cancelSwitch()
   {
-    stream_ctrl_.setTempo(in_tempo_);
-    in_ops_.reset(kOpFlagTempo);
-  }
+    std::lock_guard<std::mutex> guard(switch_mutex_);
 
-  void Ticker::importCountIn()
-  {
-    stream_ctrl_.setCountIn(in_count_in_);
-    in_ops_.reset(kOpFlagCountIn);
-  }
+    // a switch in preparation is discarded by the switch thread
+    ++in_switch_request_;
+    in_switch_backend_ = nullptr;
 
-  void Ticker::importAccelMode()
-  {
-    if (in_ops_.test(kOpFlagAccelCS))
-    {
-      in_ops_.reset(kOpFlagAccelCS);
-      accel_mode_ = AccelMode::kContinuous;
-    }
-    else if (in_ops_.test(kOpFlagAccelSW))
+    std::unique_ptr<Switch> s;
     {
-      in_ops_.reset(kOpFlagAccelSW);
-      accel_mode_ = AccelMode::kStepwise;
+      std::lock_guard<SpinLock> lck(spin_mutex_);
+      s = std::move(next_switch_);
+      next_switch_id_.store(0, std::memory_order_release);
     }
-    else if (in_ops_.test(kOpFlagAccelSP))
+
+    if (s)
     {
-      in_ops_.reset(kOpFlagAccelSP);
-      accel_mode_ = AccelMode::kNoAccel;
+      switch_disposal_.push_back(std::move(s));
+      switch_cond_var_.notify_one();
     }
   }
 
-  void Ticker::importAccelModeParams()
+  void Ticker::switchThreadFunction()
   {
-    if (accel_mode_ == AccelMode::kContinuous)
-      stream_ctrl_.accelerate(in_accel_, in_target_);
-    else if (accel_mode_ == AccelMode::kStepwise)
-      stream_ctrl_.accelerate(in_hold_, in_step_, in_target_);
-    else if (accel_mode_ == AccelMode::kNoAccel)
-      stream_ctrl_.setTempo(in_tempo_);
-  }
+    std::unique_lock<std::mutex> lck(switch_mutex_);
+
+    std::unique_ptr<Switch> prepared {nullptr};
+    std::uint64_t prepared_request = 0;
+    std::uint64_t sequence = 0;
+    bool outstanding = false;
+
+    while (true)
+    {
+      auto requested = [&] {
+        return switch_quit_ || in_switch_backend_ || !switch_disposal_.empty(); };
+
+      // the audio thread does not notify us (it must not block on the mutex),
+      // so we poll for completed switches
+      if (prepared || outstanding)
+        switch_cond_var_.wait_for(lck, kSwitchPollInterval, requested);
+      else
+        switch_cond_var_.wait(lck, requested);
+
+      if (switch_quit_)
+        break;
+
+      std::vector<std::unique_ptr<Switch>> disposal;
+      disposal.swap(switch_disposal_);
+
+      if (prepared && in_switch_request_ != prepared_request)
+        disposal.push_back(std::move(prepared)); // superseded
+
+      std::unique_ptr<Switch> done {nullptr};
+      {
+        std::lock_guard<SpinLock> guard(spin_mutex_);
+
+        done = std::move(done_switch_);
+        outstanding = next_switch_ || switch_busy_;
+
+        // hand the prepared switch to the audio thread (see updateSwitch)
+        if (prepared && !outstanding)
+        {
+          next_switch_ = std::move(prepared);
+          next_switch_id_.store(++sequence, std::memory_order_release);
+          outstanding = true;
+        }
+      }
+
+      if (done)
+        disposal.push_back(std::move(done));
+
+      std::unique_ptr<Backend> backend = std::move(in_switch_backend_);
+      const std::uint64_t request = in_switch_request_;
+
+      lck.unlock();
+
+      // drain and close the old devices
+      for (auto& s : disposal)
+        disposeSwitch(*s);
+      disposal.clear();
+
+      if (backend)
+      {
+        prepared = prepareSwitch(std::move(backend));
+        prepared_request = request;
+      }
+
+      lck.lock();
+    }
+  }
+
+  std::unique_ptr<Ticker::Switch> Ticker::prepareSwitch(std::unique_ptr<Backend> backend)
+  {
+    auto s = std::make_unique<Switch>();
+    s->backend = std::move(backend);
+
+    try {
+      s->backend->setRenderCallback(&renderer_);
+      s->config = s->backend->open();
+
+      const auto& spec = s->config.spec;
+      if (spec.channels <= 0 || spec.rate <= 0)
+        throw GMetronomeError {"Unsupported audio device"};
+
+      // the buffers that are exchanged by the audio thread (see switchBackend)
+      s->stream = BeatStreamController::allocateBuffers(spec, s->config.latency);
+      s->history = ByteBuffer(spec, historyFrames(s->config) * frameSize(spec));
+      s->fade = ByteBuffer(spec, usecsToBytes(kFadeOutTime, spec));
+      s->crossfade = ByteBuffer(spec, s->fade.size());
+
+      if (realtime_.load(std::memory_order_relaxed))
+      {
+        s->memory_locked = BeatStreamController::lockMemory(s->stream)
+          && lockMemory(s->history) && lockMemory(s->fade) && lockMemory(s->crossfade);
+      }
+
+      // the playback starts as soon as the audio thread fills the buffer
+      // of the device (i.e. not before the switch)
+      s->backend->start();
+      s->prepared = true;
+    }
+    catch(...)
+    {
+#ifndef NDEBUG
+      std::cerr << "Ticker: failed to prepare the new backend in advance" << std::endl;
+#endif
+      // if the device is busy, e.g. the same hardware that is used by the
+      // old backend, the audio thread falls back to a regular swap
+      try {
+        if (s->backend->state() == BackendState::kRunning)
+          s->backend->stop();
+        if (s->backend->state() == BackendState::kOpen)
+          s->backend->close();
+      }
+      catch(...) {}
+
+      auto fallback = std::make_unique<Switch>();
+      fallback->backend = std::move(s->backend);
+      return fallback;
+    }
+
+    return s;
+  }
+
+  void Ticker::disposeSwitch(Switch& s)
+  {
+    if (!s.backend)
+      return;
+
+    // the old device plays the queued audio data in parallel to the new device
+    try {
+      if (s.backend->state() == BackendState::kRunning)
+        s.backend->stop();
+      if (s.backend->state() == BackendState::kOpen)
+        s.backend->close();
+    }
+    catch(...)
+    {
+#ifndef NDEBUG
+      std::cerr << "Ticker: failed to close the old backend after a switch" << std::endl;
+#endif
+    }
+    s.backend = nullptr;
+  }
+
+  std::unique_ptr<Ticker::Switch> Ticker::claimSwitch(std::uint64_t id)
+  {
+    std::lock_guard<SpinLock> lck(spin_mutex_);
+
+    if (!next_switch_ || next_switch_id_.load(std::memory_order_relaxed) != id)
+      return nullptr; // cancelled or superseded
+
+    // a claimed switch can not be cancelled anymore (see cancelSwitch)
+    auto s = std::move(next_switch_);
+    next_switch_id_.store(0, std::memory_order_relaxed);
+    switch_busy_ = true;
+
+    return s;
+  }
+
+  void Ticker::releaseSwitch(std::unique_ptr<Switch> s)
+  {
+    // the switch thread releases the old backend and the old buffers
+    std::lock_guard<SpinLock> lck(spin_mutex_);
+    done_switch_ = std::move(s);
+    switch_busy_ = false;
+  }
+
+  void Ticker::installSwitch()
+  {
+    // complete a switch that was handed over while the audio thread was not
+    // running (the new device has not played yet, so there is nothing to fade)
+    auto s = claimSwitch(next_switch_id_.load(std::memory_order_acquire));
+    if (!s)
+      return;
+
+    {
+      std::lock_guard<SpinLock> lck(spin_mutex_);
+
+      if (using_dummy_)
+      {
+        std::swap(dummy_, backend_);
+        using_dummy_ = false;
+      }
+      std::swap(backend_, s->backend);
+    }
+
+    if (s->prepared)
+    {
+      std::swap(actual_device_config_, s->config);
+      backend_xruns_ = 0;
+    }
+
+    releaseSwitch(std::move(s));
+  }
+
+  void Ticker::replaceBackend(std::uint64_t id)
+  {
+    // the new device could not be opened in advance, so we drain the old
+    // device and open the new one like a regular swap (see importBackend)
+    auto s = claimSwitch(id);
+    if (!s)
+      return;
+
+    closeBackend();
+    {
+      std::lock_guard<SpinLock> lck(spin_mutex_);
+      std::swap(backend_, s->backend);
+    }
+    releaseSwitch(std::move(s));
+
+    prepareBackend();
+  }
+
+  void Ticker::updateSwitch()
+  {
+    const std::uint64_t id = next_switch_id_.load(std::memory_order_acquire);
+
+    if (id != switch_id_)
+    {
+      if (switch_pending_)
+      {
+        // the switch was cancelled or superseded
+        switch_pending_ = false;
+        staged_sounds_.fill(nullptr);
+        sound_renderer_.prepare(actual_device_config_.spec);
+      }
+      switch_id_ = 0;
+
+      if (id == 0)
+        return;
+
+      bool prepared = false;
+      {
+        std::lock_guard<SpinLock> lck(spin_mutex_);
+        if (!next_switch_ || next_switch_id_.load(std::memory_order_relaxed) != id)
+          return; // cancelled in the meantime
+
+        prepared = next_switch_->prepared;
+        switch_spec_ = next_switch_->config.spec;
+      }
+
+      if (!prepared)
+      {
+        replaceBackend(id);
+        return;
+      }
+
+      switch_id_ = id;
+      switch_pending_ = true;
+      switch_ready_ = false;
+      switch_deadline_ = Clock::now() + kSwitchRenderTimeout;
+      staged_sounds_.fill(nullptr);
+
+      // render the sounds for the new device in advance (see importSounds)
+      sound_renderer_.prepare(switch_spec_);
+    }
+
+    if (switch_pending_ && framesToSwitch() == 0)
+      switchBackend();
+  }
+
+  size_t Ticker::framesToSwitch()
+  {
+    if (!switch_pending_)
+      return kNoFrameLimit;
+
+    const auto now = Clock::now();
+
+    const auto& status = stream_ctrl_.status();
+    const bool on_beat = playing_ && !paused_
+      && (status.generator == kPreCountGenerator || status.generator == kRegularGenerator);
+
+    if (!switch_ready_)
+    {
+      // wait for the sounds of a new stream specification
+      if (now < switch_deadline_ && switch_spec_ != actual_device_config_.spec
+          && std::any_of(staged_sounds_.begin(), staged_sounds_.end(),
+                         [] (auto sound) { return sound == nullptr; }))
+        return kNoFrameLimit;
+
+      // from now on we wait for the next beat (at any tempo)
+      switch_ready_ = true;
+      const microseconds delay = on_beat
+        ? std::clamp(status.next_accent_delay, 0us, kSwitchMaxBeatDelay) : 0us;
+
+      switch_deadline_ = now + delay + kSwitchBeatMargin;
+    }
+
+    if (!on_beat || now >= switch_deadline_)
+      return 0;
+
+    // the crossfade ends with the next beat
+    const size_t frames = usecsToFrames(status.next_accent_delay, actual_device_config_.spec);
+    const size_t crossfade_frames = crossfade_buffer_.frames();
+
+    return frames > crossfade_frames ? frames - crossfade_frames : 0;
+  }
+
+  void Ticker::switchBackend()
+  {
+    // The switch thread allocated the buffers for the new device and started
+    // it in advance, so we only exchange the backends and the buffers here.
+    AllocGuard alloc_guard;
+
+    auto next = claimSwitch(switch_id_);
+
+    switch_pending_ = false;
+
+    if (!next)
+    {
+      // cancelled (see cancelSwitch)
+      staged_sounds_.fill(nullptr);
+      sound_renderer_.prepare(actual_device_config_.spec);
+      return;
+    }
+
+    const StreamSpec old_spec = actual_device_config_.spec;
+    const bool same_spec = next->config.spec == old_spec;
+
+    // the last chunk of the old device is faded out (and faded in on the new
+    // device, if the specifications match)
+    size_t crossfade_bytes = 0;
+    if (playing_ && !paused_)
+    {
+      size_t frames = crossfade_buffer_.frames();
+
+      const auto& status = stream_ctrl_.status();
+      if (status.generator == kPreCountGenerator || status.generator == kRegularGenerator)
+        frames = std::min(frames, usecsToFrames(status.next_accent_delay, old_spec));
+
+      if (frames > 0)
+      {
+        const void* data = nullptr;
+        size_t bytes = 0;
+
+        stream_ctrl_.cycle(data, bytes, frames);
+        updateAccelDeferTimer(bytes);
+
+        crossfade_bytes = std::min({bytes, fade_buffer_.size(), crossfade_buffer_.size()});
+        frames = crossfade_bytes / frameSize(old_spec);
+
+        std::memcpy(fade_buffer_.data(), data, crossfade_bytes);
+        std::memcpy(crossfade_buffer_.data(), data, crossfade_bytes);
+
+        rampGain(fade_buffer_.data(), frames, old_spec, 1.0f, 0.0f);
+        rampGain(crossfade_buffer_.data(), frames, old_spec, 0.0f, 1.0f);
+
+        backend_->write(fade_buffer_.data(), crossfade_bytes);
+      }
+    }
+
+    // the new device starts to play when the old one runs out of data
+    const microseconds queued = backend_->latency();
+
+    {
+      std::lock_guard<SpinLock> lck(spin_mutex_);
+      std::swap(backend_, next->backend);
+    }
+
+    std::swap(actual_device_config_, next->config);
+    backend_xruns_ = 0;
+
+    const auto& spec = actual_device_config_.spec;
+
+    stream_ctrl_.prepare(next->stream, actual_device_config_.period_frames);
+
+    for (auto accent : {kAccentOff, kAccentWeak, kAccentMid, kAccentStrong})
+    {
+      if (staged_sounds_[accent])
+        stream_ctrl_.swapSound(accent, *staged_sounds_[accent]);
+    }
+    staged_sounds_.fill(nullptr);
+
+    // the old crossfade buffer keeps the faded-in chunk
+    history_.swap(next->history);
+    history_pos_ = 0;
+    fade_buffer_.swap(next->fade);
+    crossfade_buffer_.swap(next->crossfade);
+
+    accel_defer_timer_.switchStreamSpec(spec);
+
+    size_t silence_frames = usecsToFrames(queued, spec);
+    if (same_spec)
+      silence_frames -= std::min(silence_frames, crossfade_bytes / frameSize(spec));
+
+    if (writeSilence(silence_frames) == silence_frames && same_spec && crossfade_bytes > 0)
+      backend_->write(next->crossfade.data(), crossfade_bytes);
+
+    if (realtime_status_.enabled && realtime_status_.memory_locked && !next->memory_locked)
+    {
+      RealtimeStatus status = realtime_status_;
+      status.memory_locked = false;
+      setRealtimeStatus(status);
+    }
+
+    releaseSwitch(std::move(next));
+  }
+
+  size_t Ticker::writeSilence(size_t frames)
+  {
+    const auto& silence = stream_ctrl_.silence();
+    const size_t frame_size = frameSize(actual_device_config_.spec);
+
+    size_t frames_written = 0;
+    while (frames_written < frames && silence.frames() > 0)
+    {
+      const size_t bytes = std::min(frames - frames_written, silence.frames()) * frame_size;
+      const size_t written = backend_->write(silence.data(), bytes);
+
+      frames_written += written / frame_size;
+
+      if (written < bytes)
+        break; // interrupted
+    }
+    return frames_written;
+  }
+
+  bool Ticker::importBackend()
+  {
+    if (!swap_backend_flag_.test_and_set(std::memory_order_acquire))
+    {
+      closeBackend();
+      return syncSwapBackend();
+    }
+    else return false;
+  }
+
+  void Ticker::deferAccel(microseconds time)
+  {
+    accel_defer_timer_.start(time);
+  }
+
+  void Ticker::amendAccel()
+  {
+    if (!isAccelDeferred())
+      return;
+
+    importAccelModeParams();
+    accel_defer_timer_.reset();
+  }
+
+  void Ticker::abortAccelDefer()
+  {
+    accel_defer_timer_.reset();
+  }
+
+  void Ticker::importTempo()
+  {
+    stream_ctrl_.setTempo(in_tempo_);
+    in_ops_.reset(kOpFlagTempo);
+  }
+
+  void Ticker::importCountIn()
+  {
+    stream_ctrl_.setCountIn(in_count_in_);
+    in_ops_.reset(kOpFlagCountIn);
+  }
+
+  void Ticker::importAccelMode()
+  {
+    if (in_ops_.test(kOpFlagAccelCS))
+    {
+      in_ops_.reset(kOpFlagAccelCS);
+      accel_mode_ = AccelMode::kContinuous;
+    }
+    else if (in_ops_.test(kOpFlagAccelSW))
+    {
+      in_ops_.reset(kOpFlagAccelSW);
+      accel_mode_ = AccelMode::kStepwise;
+    }
+    else if (in_ops_.test(kOpFlagAccelSP))
+    {
+      in_ops_.reset(kOpFlagAccelSP);
+      accel_mode_ = AccelMode::kNoAccel;
+    }
+  }
+
+  void Ticker::importAccelModeParams()
+  {
+    if (accel_mode_ == AccelMode::kContinuous)
+      stream_ctrl_.accelerate(in_accel_, in_target_);
+    else if (accel_mode_ == AccelMode::kStepwise)
+      stream_ctrl_.accelerate(in_hold_, in_step_, in_target_);
+    else if (accel_mode_ == AccelMode::kNoAccel)
+      stream_ctrl_.setTempo(in_tempo_);
+  }
 
   void Ticker::importSync()
   {
@@ -581,34 +1503,85 @@ namespace audio {
     }
   }
 
-  void Ticker::importSound()
+  void Ticker::importVolume()
   {
-    // import one sound per cycle
-    if (in_ops_.test(kOpFlagSoundOff))
-    {
-      stream_ctrl_.setSound(kAccentOff, in_sounds_[kAccentOff]);
-      in_ops_.reset(kOpFlagSoundOff);
-    }
-    else if (in_ops_.test(kOpFlagSoundWeak))
+    stream_ctrl_.setGain(paused_ ? 0.0f : volumeToAmplitude(in_volume_));
+    in_ops_.reset(kOpFlagVolume);
+  }
+
+  void Ticker::importSoundVolume()
+  {
+    for (auto accent : {kAccentOff, kAccentWeak, kAccentMid, kAccentStrong})
+      stream_ctrl_.setAccentGain(accent, volumeToAmplitude(in_sound_volume_[accent]));
+
+    in_ops_.reset(kOpFlagSoundVolume);
+  }
+
+  void Ticker::importSounds()
+  {
+    // swap in the sounds that were rendered in the meantime (wait-free)
+    for (auto accent : {kAccentOff, kAccentWeak, kAccentMid, kAccentStrong})
     {
-      stream_ctrl_.setSound(kAccentWeak, in_sounds_[kAccentWeak]);
-      in_ops_.reset(kOpFlagSoundWeak);
+      if (ByteBuffer* sound = sound_renderer_.acquire(accent); sound)
+      {
+        // keep the sounds that were rendered for the next backend
+        if (!stream_ctrl_.swapSound(accent, *sound)
+            && switch_pending_ && sound->spec() == switch_spec_)
+          staged_sounds_[accent] = sound;
+      }
     }
-    else if (in_ops_.test(kOpFlagSoundMid))
+  }
+
+  void Ticker::importPlayback()
+  {
+    const bool play = play_flag_.load(std::memory_order_acquire);
+    if (play != playing_)
     {
-      stream_ctrl_.setSound(kAccentMid, in_sounds_[kAccentMid]);
-      in_ops_.reset(kOpFlagSoundMid);
+      playing_ = play;
+
+      if (isAccelDeferred())
+        amendAccel();
+
+      if (playing_)
+      {
+        // the backend is already primed, so the initial silence is skipped
+        stream_ctrl_.start(kPreCountGenerator);
+        first_click_pending_ = true;
+      }
+      else
+      {
+        stream_ctrl_.start(kIdleGenerator);
+        first_click_pending_ = false;
+
+        // discard the clicks that are still queued in the device
+        if (backend_->mode() == BackendMode::kPush)
+          fadeOutBackend();
+      }
     }
-    else if (in_ops_.test(kOpFlagSoundStrong))
+
+    // a paused stream fades out and keeps its state until it is resumed
+    const bool pause = playing_ && pause_flag_.load(std::memory_order_acquire);
+    if (pause != paused_)
     {
-      stream_ctrl_.setSound(kAccentStrong, in_sounds_[kAccentStrong]);
-      in_ops_.reset(kOpFlagSoundStrong);
+      paused_ = pause;
+
+      if (paused_)
+      {
+        stream_ctrl_.setGain(0.0f);
+        pause_fade_frames_ = usecsToFrames(VoiceMixer::kGainRampTime,
+                                           actual_device_config_.spec);
+      }
+      else
+      {
+        stream_ctrl_.setGain(volumeToAmplitude(in_volume_));
+        pause_fade_frames_ = 0;
+      }
     }
   }
 
   void Ticker::importSettingsInitial()
   {
-    std::unique_lock<SpinLock> lck(spin_mutex_);
+    stageCommands();
 
     // Ignore Sync
     if (in_ops_.test(kOpFlagSync))
@@ -631,171 +1604,425 @@ namespace audio {
     if ((in_ops_ & kOpMaskMeter).any())
       importMeter();
 
-    // Sound
-    if ((in_ops_ & kOpMaskSound).any())
-      importSound();
+    // Volume
+    if (in_ops_.test(kOpFlagVolume))
+      importVolume();
+
+    if (in_ops_.test(kOpFlagSoundVolume))
+      importSoundVolume();
   }
 
-  bool Ticker::tryImportSettings(bool force)
+  void Ticker::importSettings()
   {
-    std::unique_lock<SpinLock> lck(spin_mutex_, std::defer_lock);
+    if (in_ops_.none())
+      return;
 
-    if (force)
-      lck.lock();
-    else
-      static_cast<void>(lck.try_lock()); // try_lock has [[nodiscard]]
+    // Count-in
+    if (in_ops_.test(kOpFlagCountIn))
+      importCountIn();
 
-    if (lck.owns_lock())
+    // Tempo
+    if (in_ops_.test(kOpFlagTempo))
     {
-      if (in_ops_.any())
-      {
-        // Count-in
-        if (in_ops_.test(kOpFlagCountIn))
-          importCountIn();
+      importTempo();
+      if (accel_mode_ != AccelMode::kNoAccel)
+        deferAccel();
+    }
 
-        // Tempo
-        if (in_ops_.test(kOpFlagTempo))
-        {
-          importTempo();
-          if (accel_mode_ != AccelMode::kNoAccel)
-            deferAccel();
-        }
+    // Sync
+    if (in_ops_.test(kOpFlagSync))
+    {
+      importSync();
+      deferAccel(in_sync_time_ + kDefaultAccelDeferTime);
+    }
 
-        // Sync
-        if (in_ops_.test(kOpFlagSync))
-        {
-          importSync();
-          deferAccel(in_sync_time_ + kDefaultAccelDeferTime);
-        }
+    // Accel
+    if ((in_ops_ & kOpMaskAccel).any())
+    {
+      auto old_mode = accel_mode_;
 
-        // Accel
-        if ((in_ops_ & kOpMaskAccel).any())
-        {
-          auto old_mode = accel_mode_;
+      importAccelMode();
+
+      bool mode_changed = accel_mode_ != old_mode;
 
-          importAccelMode();
+      if (isAccelDeferred() && mode_changed && accel_mode_ == AccelMode::kNoAccel)
+        abortAccelDefer();
 
-          bool mode_changed = accel_mode_ != old_mode;
+      if (!isAccelDeferred())
+        importAccelModeParams();
+    }
 
-          if (isAccelDeferred() && mode_changed && accel_mode_ == AccelMode::kNoAccel)
-            abortAccelDefer();
+    if ((in_ops_ & kOpMaskMeter).any())
+      importMeter();
 
-          if (!isAccelDeferred())
-            importAccelModeParams();
-        }
+    if (in_ops_.test(kOpFlagVolume))
+      importVolume();
 
-        if ((in_ops_ & kOpMaskMeter).any())
-          importMeter();
+    if (in_ops_.test(kOpFlagSoundVolume))
+      importSoundVolume();
+  }
 
-        if ((in_ops_ & kOpMaskSound).any())
-          importSound();
+  void Ticker::importCommands()
+  {
+    if (coalesce_commands_.load(std::memory_order_relaxed))
+    {
+      stageCommands();
+      importSettings();
+    }
+    else
+    {
+      while (Command* cmd = in_queue_.front())
+      {
+        stageCommand(*cmd);
+        in_queue_.pop();
+        importSettings();
       }
-      return true;
     }
-    else return false;
   }
 
-  bool Ticker::tryExportInfo(bool force)
+  void Ticker::exportInfo()
   {
-    std::unique_lock<SpinLock> lck(spin_mutex_, std::defer_lock);
+    auto& info = out_info_.back();
 
-    if (force)
-      lck.lock();
+    info.sequence  = ++out_sequence_;
+    info.timestamp = microseconds(g_get_monotonic_time());
+
+    const auto& gen_status = stream_ctrl_.status();
+    const auto& meter = stream_ctrl_.meter();
+
+    info.mode         = accel_mode_;
+    info.pending      = isAccelDeferred() || gen_status.generator == kPreCountGenerator;
+    info.syncing      = gen_status.mode == TempoMode::kSync;
+
+    info.position     = gen_status.position;
+    info.tempo        = gen_status.tempo;
+    info.acceleration = gen_status.acceleration;
+
+    if (isAccelDeferred())
+      info.target     = in_target_;
+    else
+      info.target     = stream_ctrl_.target();
+
+    info.hold         = gen_status.hold;
+    info.count_in     = stream_ctrl_.countIn();
+
+    // Meter
+    info.default_meter     = !stream_ctrl_.isMeterEnabled();
+    info.beats             = meter.beats();
+    info.division          = meter.division();
+    info.accent            = gen_status.accent;
+    info.next_accent_delay = gen_status.next_accent_delay;
+    info.generator         = gen_status.generator;
+
+    if (backend_)
+      info.backend_latency = backend_->latency();
+    else
+      info.backend_latency = 0us;
+
+    info.response_latency = info.backend_latency + chunk_duration_;
+
+    stats_.buffer_fill.record(info.backend_latency);
+
+    out_info_.publish();
+  }
+
+  void Ticker::processCycle()
+  {
+    const void* data;
+    size_t bytes;
+
+    exportInfo();
+
+    importCommands();
+
+    importPlayback();
+
+    importSounds();
+
+    // make up deferred accel mode before the new cycle
+    if (isAccelDeferred() && isAccelDeferExpired())
+      amendAccel();
+
+    if (first_click_pending_)
+      recordFirstClick();
+
+    const auto& spec = actual_device_config_.spec;
+
+    auto start = Clock::now();
+    if (paused_ && pause_fade_frames_ == 0)
+    {
+      // the stream is frozen, so we play silence without cycling
+      const auto& silence = stream_ctrl_.silence();
+
+      size_t frames = stream_ctrl_.periodFrames();
+      if (frames == 0)
+        frames = usecsToFrames(stream_ctrl_.latency().avg_chunk, spec);
+
+      data = silence.data();
+      bytes = std::min(frames, silence.frames()) * frameSize(spec);
+    }
     else
-      static_cast<void>(lck.try_lock()); // try_lock has [[nodiscard]]
+    {
+      // a pending switch of the backend limits the chunk (see framesToSwitch)
+      size_t max_frames = paused_ ? pause_fade_frames_ : framesToSwitch();
+      if (max_frames == 0)
+        max_frames = kNoFrameLimit;
+
+      stream_ctrl_.cycle(data, bytes, max_frames);
+
+      if (paused_)
+        pause_fade_frames_ -= std::min(pause_fade_frames_, bytes / frameSize(spec));
+    }
+    stats_.cycle_time.record(Clock::now() - start);
+    stats_.cycles.fetch_add(1, std::memory_order_relaxed);
+
+    chunk_duration_ = bytesToUsecs(bytes, spec);
+    writeBackend(data, bytes);
+
+    if (!paused_)
+      updateAccelDeferTimer(bytes);
+  }
+
+  void Ticker::updateXruns()
+  {
+    // the counter of the backend restarts when the device is reopened
+    std::uint64_t xruns = backend_->xruns();
+    if (xruns < backend_xruns_)
+      backend_xruns_ = 0;
+
+    stats_.xruns.fetch_add(xruns - backend_xruns_, std::memory_order_relaxed);
+    backend_xruns_ = xruns;
+  }
+
+  void Ticker::recordFirstClick()
+  {
+    const GeneratorId generator = stream_ctrl_.status().generator;
+
+    if (generator != kPreCountGenerator && generator != kRegularGenerator)
+      return;
+
+    first_click_pending_ = false;
+
+    // the first beat of the next chunk is played after the queued audio
+    const Clock::time_point request {Clock::duration(
+        start_request_time_.load(std::memory_order_relaxed))};
+
+    const microseconds latency = backend_->latency();
 
-    if (lck.owns_lock())
+    stats_.first_click.record(Clock::now() - request + latency);
+  }
+
+  void Ticker::updateRealtime()
+  {
+    RealtimeStatus status;
+    status.enabled = realtime_.load(std::memory_order_relaxed);
+
+    if (status.enabled)
     {
-      out_info_.timestamp = microseconds(g_get_monotonic_time());
+      status.priority = kDefaultRealtimePriority;
+      status.policy = makeThreadRealtime(status.priority);
 
-      const auto& gen_status = stream_ctrl_.status();
-      const auto& meter = stream_ctrl_.meter();
+      // the D-Bus request may allocate, so it is done outside the real-time section
+      if (status.policy == RealtimePolicy::kNone)
+      {
+        if (requestRealtimeKit(status.priority))
+        {
+          status.policy = RealtimePolicy::kRoundRobin;
+          status.rtkit = true;
+        }
+        else status.priority = 0;
+      }
 
-      out_info_.mode         = accel_mode_;
-      out_info_.pending      = isAccelDeferred() || gen_status.generator == kPreCountGenerator;
-      out_info_.syncing      = gen_status.mode == TempoMode::kSync;
+      status.memory_locked = lockWorkingSet();
+      status.flush_denormals = flushDenormals(true);
+    }
+    else if (realtime_status_.enabled)
+    {
+      makeThreadNormal();
+      unlockMemory();
+      flushDenormals(false);
+    }
 
-      out_info_.position     = gen_status.position;
-      out_info_.tempo        = gen_status.tempo;
-      out_info_.acceleration = gen_status.acceleration;
+    sound_renderer_.setFlushDenormals(status.flush_denormals);
 
-      if (isAccelDeferred())
-        out_info_.target     = in_target_;
-      else
-        out_info_.target     = stream_ctrl_.target();
+    setRealtimeStatus(status);
 
-      out_info_.hold         = gen_status.hold;
-      out_info_.count_in     = stream_ctrl_.countIn();
+#ifndef NDEBUG
+    if (status.enabled)
+      std::cerr << "Ticker: real-time mode enabled (scheduling: "
+                << (status.policy == RealtimePolicy::kFifo ? "SCHED_FIFO" :
+                    status.policy == RealtimePolicy::kRoundRobin ? "SCHED_RR" : "denied")
+                << (status.rtkit ? " via RealtimeKit" : "")
+                << ", priority: " << status.priority
+                << ", memory locked: " << (status.memory_locked ? "yes" : "no")
+                << ", flush denormals: " << (status.flush_denormals ? "yes" : "no")
+                << ")" << std::endl;
+    else
+      std::cerr << "Ticker: real-time mode disabled" << std::endl;
+#endif
+  }
 
-      // Meter
-      out_info_.default_meter     = !stream_ctrl_.isMeterEnabled();
-      out_info_.beats             = meter.beats();
-      out_info_.division          = meter.division();
-      out_info_.accent            = gen_status.accent;
-      out_info_.next_accent_delay = gen_status.next_accent_delay;
-      out_info_.generator         = gen_status.generator;
+  void Ticker::resetRealtime()
+  {
+    if (realtime_status_.enabled)
+      unlockMemory();
 
-      if (backend_)
-        out_info_.backend_latency = backend_->latency();
-      else
-        out_info_.backend_latency = 0us;
+    sound_renderer_.setFlushDenormals(false);
+
+    setRealtimeStatus({});
+  }
+
+  bool Ticker::lockWorkingSet()
+  {
+    // the ticker holds the command queue and the status buffers
+    bool locked = lockMemory(this, sizeof(Ticker));
+
+    locked = stream_ctrl_.lockMemory() && locked;
+    locked = lockMemory(history_) && lockMemory(fade_buffer_)
+      && lockMemory(crossfade_buffer_) && locked;
+    locked = lockStack() && locked;
+
+    return locked;
+  }
+
+  void Ticker::setRealtimeStatus(const RealtimeStatus& status)
+  {
+    std::lock_guard<std::mutex> guard(realtime_mutex_);
+    realtime_status_ = status;
+  }
+
+  void Ticker::renderCallback(void* data, size_t frames) noexcept
+  {
+    try {
+      DenormalGuard denormals {realtime_.load(std::memory_order_relaxed)};
+
+      AllocGuard alloc_guard;
+
+      exportInfo();
+
+      importCommands();
+
+      importPlayback();
+
+      importSounds();
+
+      if (isAccelDeferred() && isAccelDeferExpired())
+        amendAccel();
 
-      has_info_ = true;
+      if (first_click_pending_)
+        recordFirstClick();
 
-      return true;
+      const auto& spec = actual_device_config_.spec;
+
+      auto start = Clock::now();
+      if (paused_)
+      {
+        // the stream is frozen after the fade-out
+        size_t fade_frames = std::min(frames, pause_fade_frames_);
+        if (fade_frames > 0)
+          stream_ctrl_.render(data, fade_frames);
+
+        stream_ctrl_.renderSilence(static_cast<ByteBuffer::pointer>(data)
+                                   + fade_frames * frameSize(spec),
+                                   frames - fade_frames);
+        pause_fade_frames_ -= fade_frames;
+      }
+      else stream_ctrl_.render(data, frames);
+      stats_.cycle_time.record(Clock::now() - start);
+      stats_.cycles.fetch_add(1, std::memory_order_relaxed);
+
+      chunk_duration_ = framesToUsecs(frames, spec);
+
+      if (!paused_)
+        updateAccelDeferTimer(frames * frameSize(spec));
+    }
+    catch(...)
+    {
+      // report the first error to the audio thread
+      if (!render_error_flag_.load(std::memory_order_relaxed))
+      {
+        render_error_ = std::current_exception();
+        render_error_flag_.store(true, std::memory_order_release);
+      }
     }
-    else return false;
   }
 
   void Ticker::audioThreadFunction() noexcept
   {
-    const void* data;
-    size_t bytes;
-
     try {
+      installSwitch();
       openBackend(); // sets actual_device_config_
-      stream_ctrl_.prepare(actual_device_config_.spec);
+      stream_ctrl_.prepare(actual_device_config_.spec,
+                           actual_device_config_.latency,
+                           actual_device_config_.period_frames);
+      sound_renderer_.prepare(actual_device_config_.spec);
+      prepareHistory();
 
       accel_defer_timer_.switchStreamSpec(actual_device_config_.spec);
 
+      updateRealtime();
+
+      paused_ = false;
+      pause_fade_frames_ = 0;
+
       importSettingsInitial();
+      importSounds();
 
-      stream_ctrl_.start(kFillBufferGenerator);
+      // in standby mode the stream idles until it is started
+      playing_ = play_flag_.load(std::memory_order_acquire);
+      first_click_pending_ = playing_;
+
+      switch_id_ = 0;
+      switch_pending_ = false;
+      staged_sounds_.fill(nullptr);
+
+      stream_ctrl_.start(playing_ ? kFillBufferGenerator : kIdleGenerator);
       startBackend();
 
       // enter the main loop
       while (continue_audio_thread_flag_.test_and_set())
       {
         if (importBackend())
-        {
-          openBackend(); // updates actual_device_config_
-          stream_ctrl_.prepare(actual_device_config_.spec);
+          prepareBackend();
+        else
+          updateSwitch();
 
-          accel_defer_timer_.switchStreamSpec(actual_device_config_.spec);
+        if (realtime_.load(std::memory_order_relaxed) != realtime_status_.enabled)
+          updateRealtime();
 
-          startBackend();
-        }
-
-        tryExportInfo();
-
-        tryImportSettings();
-
-        // make up deferred accel mode before the new cycle
-        if (isAccelDeferred() && isAccelDeferExpired())
-          tryAmendAccel();
+        // from here on the stream is processed without heap allocations
+        AllocGuard alloc_guard;
 
-        stream_ctrl_.cycle(data, bytes);
-        writeBackend(data, bytes);
+        if (backend_->mode() == BackendMode::kPull)
+        {
+          // the stream is processed by the render callback
+          if (render_error_flag_.load(std::memory_order_acquire))
+          {
+            // leaving the real-time section (the exception is copied)
+            AllocGuard::Suspend suspend;
+            std::rethrow_exception(render_error_);
+          }
+
+          std::this_thread::sleep_for(kPullModePollInterval);
+        }
+        else
+        {
+          processCycle();
+        }
 
-        updateAccelDeferTimer(bytes);
+        updateXruns();
       }
 
+      // discard the queued audio data with a short fade-out and stop the
+      // backend first to finish pending render callbacks
+      fadeOutBackend();
+      stopBackend();
+
       if (isAccelDeferred())
-        tryAmendAccel(true);
+        amendAccel();
 
       stream_ctrl_.stop();
-      tryExportInfo(true);
-      stopBackend();
+      exportInfo();
     }
     catch(...)
     {
@@ -814,6 +2041,8 @@ namespace audio {
       audio_thread_error_flag_.store(true, std::memory_order_release);
     }
 
+    resetRealtime();
+
     audio_thread_finished_flag_ = true;
     cond_var_.notify_one();
   }
@@ -22,9 +22,14 @@
 
 #include "Meter.h"
 #include "Synthesizer.h"
+#include "SoundRenderer.h"
 #include "Generator.h"
 #include "AudioBackend.h"
+#include "Histogram.h"
+#include "Realtime.h"
 #include "SpinLock.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
 
 #include <memory>
 #include <thread>
@@ -33,6 +38,8 @@
 #include <condition_variable>
 #include <array>
 #include <bitset>
+#include <vector>
+#include <cstdint>
 
 namespace audio {
 
@@ -42,7 +49,8 @@ namespace audio {
     {
       kStarted      = 0,
       kRunning      = 1,
-      kError        = 2
+      kError        = 2,
+      kPaused       = 3
     };
 
     using State = std::bitset<16>;
@@ -56,6 +64,12 @@ namespace audio {
 
     struct Info
     {
+      // Number of the status frame. The audio thread exports one frame per
+      // cycle and numbers them consecutively (starting with 1), so the
+      // difference to a previously received frame minus one is the number
+      // of frames that were missed in between.
+      std::uint64_t sequence {0};
+
       microseconds  timestamp {0us};
 
       AccelMode     mode {AccelMode::kNoAccel};
@@ -77,11 +91,56 @@ namespace audio {
       microseconds  next_accent_delay {0us};
 
       GeneratorId   generator {kInvalidGenerator};
+
+      // Time until the stream position of this frame becomes audible
       microseconds  backend_latency {0us};
+
+      // Maximum time until a parameter change becomes audible, i.e. the
+      // duration of the chunk in progress plus the backend latency
+      microseconds  response_latency {0us};
+    };
+
+    // Health statistics of the audio engine (see stats())
+    struct Stats
+    {
+      // Number of processing cycles (push mode) or render callbacks (pull mode)
+      std::uint64_t cycles {0};
+
+      // Buffer underruns reported by the backends
+      std::uint64_t xruns {0};
+
+      // Commands that had to wait for free space in the command queue
+      std::uint64_t deferred_commands {0};
+
+      // Time to generate a chunk of the stream
+      Histogram     cycle_time;
+
+      // Time blocked in Backend::write() (push mode)
+      Histogram     write_time;
+
+      // Audio queued in the device at the beginning of a cycle
+      Histogram     buffer_fill;
+
+      // Time to synthesize a sound
+      Histogram     render_time;
+
+      // Sounds that were taken from the sound cache or had to be synthesized
+      std::uint64_t sound_cache_hits {0};
+      std::uint64_t sound_cache_misses {0};
+
+      // Time from start() until the first beat becomes audible
+      Histogram     first_click;
+
+      // Heap allocations in the real-time sections of the audio thread
+      // (only detected if the allocation guard is compiled in, see AllocGuard)
+      std::uint64_t alloc_violations {0};
     };
 
     static constexpr microseconds kDefaultSyncTime = 1s;
 
+    /** Duration of the fade-out of the queued audio data on stop() */
+    static constexpr microseconds kFadeOutTime = 10ms;
+
   public:
     Ticker();
     ~Ticker();
@@ -91,13 +150,76 @@ namespace audio {
 
     std::unique_ptr<Backend> getBackend(const microseconds& timeout = 2s);
 
+    /**
+     * @brief Replace the audio backend
+     *
+     * If both backends write to their devices (see BackendMode::kPush), the
+     * switch is gapless and asynchronous: a background thread opens and starts
+     * the new device and allocates the stream buffers for it, while the old
+     * device keeps playing and the sounds are rendered in advance for the new
+     * stream specification. The audio thread switches shortly before the next
+     * beat, crossfades the last chunk and delays the new device until the old
+     * one runs out of data, so that the beat phase is kept. The old device is
+     * drained and closed by the background thread. If the new device can not
+     * be opened in advance (e.g. because it is busy), the audio thread falls
+     * back to a regular swap and errors are reported by the state of the
+     * audio thread (see StateFlag::kError). A pending switch is cancelled by
+     * subsequent calls.
+     *
+     * Otherwise the old device is drained and closed before the new one is
+     * started.
+     *
+     * On return the argument holds the old backend (closed) or nullptr, if
+     * the switch is gapless.
+     */
     void swapBackend(std::unique_ptr<Backend>& backend,
                      const microseconds& timeout = 2s);
 
+    /**
+     * @brief Start the metronome
+     */
     void start();
+
+    /**
+     * @brief Stop the metronome
+     *
+     * The audio data that is queued in the device is discarded and the
+     * stream fades out within a few milliseconds (see kFadeOutTime).
+     */
     void stop();
+
     void reset() noexcept;
 
+    /**
+     * @brief Pause the metronome
+     *
+     * The stream fades out and plays silence, while the audio thread and
+     * the backend keep running and the state of the stream (position, tempo,
+     * acceleration) is frozen. Only applicable while the metronome is started.
+     */
+    void pause();
+
+    /**
+     * @brief Resume a paused metronome
+     *
+     * The stream continues on the beat phase at which it was paused without
+     * the initial silence of start().
+     */
+    void resume();
+
+    /**
+     * @brief Keep the audio thread and the backend running between sessions
+     *
+     * In standby mode stop() does not terminate the audio thread. Instead the
+     * stream switches to silence (see IdleGenerator) and the backend stays
+     * open and primed, so that the next start() only switches the generator
+     * of the stream and skips the thread creation, the preparation of the
+     * device and the initial silence of the stream. If the audio thread is
+     * not running, enabling the mode starts it in the idle state (default:
+     * disabled).
+     */
+    void setStandby(bool enable);
+
     Ticker::State state() const noexcept;
 
     /**
@@ -152,15 +274,115 @@ namespace audio {
      */
     void resetMeter();
 
+    /**
+     * @brief Set the sound of an accent
+     *
+     * The sound is synthesized asynchronously by a background worker and
+     * becomes audible as soon as the rendering is finished. The volume of
+     * the sound is not part of the synthesis but applied during playback,
+     * i.e. a change of the volume alone does not re-render the sound.
+     */
     void setSound(Accent accent, const SoundParameters& params);
 
-    Ticker::Info getInfo() const;
+    /**
+     * @brief Set the master volume of the metronome
+     *
+     * The volume (in percent) is applied in real-time and changes are ramped
+     * to prevent clicks.
+     */
+    void setVolume(double volume);
+
+    /**
+     * @brief Enable or disable the coalescing of input commands
+     *
+     * With coalescing enabled (default) the audio thread only applies the
+     * latest command of each kind that arrived since the last cycle, e.g. a
+     * burst of tempo changes results in a single tempo update of the stream.
+     * Otherwise every command is applied to the stream in order of arrival.
+     */
+    void setCommandCoalescing(bool enable);
+
+    /**
+     * @brief Set the memory budget of the sound cache
+     *
+     * Rendered sounds are cached by their sound parameters and stream
+     * specification up to the given size in bytes (default:
+     * kDefaultSoundCacheBudget). A budget of zero disables the cache.
+     */
+    void setSoundCacheBudget(std::size_t budget);
+
+    /**
+     * @brief Enable or disable the real-time mode of the audio thread
+     *
+     * In real-time mode the audio thread requests real-time scheduling
+     * (SCHED_FIFO or SCHED_RR, or SCHED_RR from RealtimeKit if the process
+     * lacks the privileges), locks its working set into RAM and flushes
+     * denormal floats to zero. In pull mode the scheduling of the render
+     * callback is left to the backend. The mode is applied asynchronously
+     * by the audio thread (default: disabled).
+     */
+    void setRealtime(bool enable);
+
+    /**
+     * @brief The privileges that were actually granted in real-time mode
+     */
+    RealtimeStatus realtimeStatus() const;
+
+    /**
+     * @brief Deliver the commands that were deferred because the command
+     *        queue was full
+     *
+     * Every setter delivers the deferred commands before its own command.
+     * Clients call this function periodically while the audio thread is
+     * running, so that deferred commands do not wait for the next setter.
+     *
+     * @return Whether commands are still deferred
+     */
+    bool flush();
+
+    /**
+     * @brief Get the most recent status frame of the audio thread
+     *
+     * The status is exported by the audio thread via a triple buffer, i.e.
+     * this function is wait-free and never delays the audio thread. It must
+     * not be called concurrently from different threads.
+     *
+     * @param consume Mark the frame as consumed (see hasInfo())
+     */
     Ticker::Info getInfo(bool consume = true);
 
+    /**
+     * @brief Check for a status frame that was not consumed yet
+     */
     bool hasInfo() const;
 
+    /**
+     * @brief Get the health statistics of the audio engine
+     *
+     * The statistics are recorded by the audio threads with relaxed atomic
+     * operations, i.e. this function never delays the audio thread and may
+     * be called at any time. The statistics accumulate until resetStats()
+     * is called.
+     */
+    Ticker::Stats stats() const;
+
+    /**
+     * @brief Reset the health statistics
+     */
+    void resetStats();
+
+    /**
+     * @brief Query the transport of the audio backend
+     *
+     * @param transport  Receives the transport state
+     * @return False if the backend does not have a transport (see
+     *         Backend::transport())
+     */
+    bool transport(Transport& transport);
+
   private:
     BeatStreamController stream_ctrl_;
+    SoundRenderer sound_renderer_;
 
     std::unique_ptr<Backend> backend_;
     std::unique_ptr<Backend> dummy_{nullptr};
@@ -168,6 +390,7 @@ namespace audio {
 
     Ticker::State state_{0};
 
+    // staged input parameters (owned by the audio thread while it is running)
     // tempo
     double in_tempo_{0.0};
 
@@ -188,8 +411,9 @@ namespace audio {
     // meter
     Meter in_meter_{};
 
-    // sound
-    std::array<SoundParameters, kNumAccents> in_sounds_;
+    // volume
+    double in_volume_{100.0};
+    std::array<double, kNumAccents> in_sound_volume_{};
 
     // input operations
     enum OpFlag
@@ -202,10 +426,8 @@ namespace audio {
       kOpFlagSync        = 5,
       kOpFlagMeter       = 6,
       kOpFlagMeterReset  = 7,
-      kOpFlagSoundOff    = 8,
-      kOpFlagSoundWeak   = 9,
-      kOpFlagSoundMid    = 10,
-      kOpFlagSoundStrong = 11,
+      kOpFlagVolume      = 8,
+      kOpFlagSoundVolume = 9,
       kNumOpFlags
     };
 
@@ -213,25 +435,194 @@ namespace audio {
 
     static constexpr OpFlags kOpMaskMeter {   0b11u << kOpFlagMeter};
     static constexpr OpFlags kOpMaskAccel {  0b111u << kOpFlagAccelCS};
-    static constexpr OpFlags kOpMaskSound { 0b1111u << kOpFlagSoundOff};
 
     OpFlags in_ops_{0};
 
+    // operations that are obsoleted by a subsequent operation of the given kind
+    static OpFlags supersededOps(OpFlag op);
+
+    // input commands (only the parameters of the respective operation are used)
+    struct Command
+    {
+      OpFlag       op {kOpFlagTempo};
+      double       tempo {0.0};        // tempo or sync tempo
+      int          count_in {0};
+      double       accel {0.0};
+      int          hold {0};
+      double       step {0.0};
+      double       target {0.0};
+      double       sync_beats {0.0};
+      microseconds sync_time {0us};
+      Meter        meter {};
+      double       volume {0.0};
+      std::array<double, kNumAccents> sound_volume {};
+    };
+
+    static constexpr std::size_t kCommandQueueCapacity = 256;
+
+    SpscQueue<Command, kCommandQueueCapacity> in_queue_;
+
+    // commands that did not fit into the queue (ui thread only)
+    std::vector<Command> backlog_;
+
+    // volumes of the accent sounds (ui thread only)
+    std::array<double, kNumAccents> sound_volume_{};
+
+    std::atomic<bool> coalesce_commands_{true};
+
+    // real-time mode (the status is written by the audio thread only)
+    std::atomic<bool> realtime_{false};
+    RealtimeStatus realtime_status_;
+    mutable std::mutex realtime_mutex_;
+
+    void updateRealtime();
+    void resetRealtime();
+    bool lockWorkingSet();
+    void setRealtimeStatus(const RealtimeStatus& status);
+
+    // health statistics (see stats())
+    struct StatsCounters
+    {
+      std::atomic<std::uint64_t> cycles {0};
+      std::atomic<std::uint64_t> xruns {0};
+      std::atomic<std::uint64_t> deferred_commands {0};
+      HistogramRecorder cycle_time;
+      HistogramRecorder write_time;
+      HistogramRecorder buffer_fill;
+      HistogramRecorder first_click;
+      std::atomic<std::uint64_t> alloc_violations_base {0};
+    };
+
+    StatsCounters stats_;
+    std::uint64_t backend_xruns_{0}; // audio thread only
+
+    void updateXruns();
+
+    // standby mode (see setStandby())
+    bool standby_{false};                // ui thread only
+    bool idling_{false};                 // ui thread only
+    std::atomic<bool> play_flag_{false}; // requested state of the stream
+    bool playing_{false};                // stream thread only
+
+    // time-to-first-click (see Stats::first_click)
+    std::atomic<std::int64_t> start_request_time_{0};
+    bool first_click_pending_{false};    // stream thread only
+
+    void importPlayback();
+    void recordFirstClick();
+
+    // pause/resume (see pause())
+    std::atomic<bool> pause_flag_{false};
+    bool paused_{false};                 // stream thread only
+    size_t pause_fade_frames_{0};        // stream thread only
+
+    // Recently written audio data (push mode). On exit the audio thread
+    // finds the data that is about to be played in this ring buffer and
+    // replaces the queue of the device with a faded copy of it.
+    ByteBuffer history_;
+    size_t history_pos_{0};
+    ByteBuffer fade_buffer_;
+
+    void prepareHistory();
+    void recordHistory(const void* data, size_t bytes);
+    void fadeOutBackend();
+
+    void pushCommand(Command cmd);
+    void flushCommands();
+
+    void stageCommand(Command& cmd);
+    void stageCommands();
+
     std::atomic_flag swap_backend_flag_;
     mutable SpinLock spin_mutex_;
 
-    Ticker::Info out_info_;
-    bool has_info_{false};
+    // status export (audio thread -> ui thread)
+    TripleBuffer<Ticker::Info> out_info_;
+    std::uint64_t out_sequence_{0};      // audio thread only
+    std::uint64_t consumed_sequence_{0}; // ui thread only
+
+    // pull mode (see BackendMode)
+    class Renderer : public RenderCallback {
+    public:
+      explicit Renderer(Ticker& ticker) : ticker_{ticker} {}
+      void render(void* data, size_t frames) noexcept override
+        { ticker_.renderCallback(data, frames); }
+    private:
+      Ticker& ticker_;
+    };
+
+    Renderer renderer_{*this};
+    std::exception_ptr render_error_{nullptr};
+    std::atomic<bool> render_error_flag_{false};
+
+    void renderCallback(void* data, size_t frames) noexcept;
+    microseconds chunk_duration_{0us};
+    void processCycle();
 
     void openBackend();
     void closeBackend();
     void startBackend();
     void stopBackend();
     void writeBackend(const void* data, size_t bytes);
+    void wakeupBackend();
+    void prepareBackend();
 
     bool syncSwapBackend();
     void hardSwapBackend(std::unique_ptr<Backend>& backend);
 
+    // gapless switch to a backend that is prepared in advance by the switch
+    // thread (see swapBackend())
+    struct Switch
+    {
+      std::unique_ptr<Backend> backend {nullptr};
+      DeviceConfig config {kDefaultConfig};
+      bool prepared {false};      // opened, started and buffers allocated
+      bool memory_locked {false}; // buffers locked into RAM (real-time mode)
+      BeatStreamController::Buffers stream;
+      ByteBuffer history;
+      ByteBuffer fade;
+      ByteBuffer crossfade;
+    };
+
+    // The switch thread hands a prepared switch to the audio thread, which
+    // returns it with the old backend and the old buffers after the switch,
+    // so that the audio thread neither allocates nor releases memory.
+    std::unique_ptr<Switch> next_switch_{nullptr};   // guarded by spin_mutex_
+    std::unique_ptr<Switch> done_switch_{nullptr};   // guarded by spin_mutex_
+    bool switch_busy_{false};                        // guarded by spin_mutex_
+    std::atomic<std::uint64_t> next_switch_id_{0};   // 0 if no switch is handed over
+
+    std::uint64_t switch_id_{0};                     // audio thread only
+    bool switch_pending_{false};                     // audio thread only
+    bool switch_ready_{false};                       // audio thread only
+    StreamSpec switch_spec_{kDefaultSpec};           // audio thread only
+    std::chrono::steady_clock::time_point switch_deadline_;
+    std::array<ByteBuffer*, kNumAccents> staged_sounds_{};
+    ByteBuffer crossfade_buffer_;
+
+    // switch requests (ui thread -> switch thread)
+    std::mutex switch_mutex_;
+    std::condition_variable switch_cond_var_;
+    std::unique_ptr<Backend> in_switch_backend_{nullptr};
+    std::uint64_t in_switch_request_{0};
+    std::vector<std::unique_ptr<Switch>> switch_disposal_;
+    bool switch_quit_{false};
+    std::thread switch_thread_;
+
+    bool gaplessSwapBackend(std::unique_ptr<Backend>& backend);
+    void cancelSwitch();
+    void switchThreadFunction();
+    std::unique_ptr<Switch> prepareSwitch(std::unique_ptr<Backend> backend);
+    void disposeSwitch(Switch& s);
+    std::unique_ptr<Switch> claimSwitch(std::uint64_t id);
+    void releaseSwitch(std::unique_ptr<Switch> s);
+    void installSwitch();
+    void replaceBackend(std::uint64_t id);
+    void updateSwitch();
+    size_t framesToSwitch();
+    void switchBackend();
+    size_t writeSilence(size_t frames);
+
     bool importBackend();
 
     // current accel mode
@@ -243,7 +634,7 @@ namespace audio {
     StreamTimer accel_defer_timer_;
 
     void deferAccel(microseconds time = kDefaultAccelDeferTime);
-    bool tryAmendAccel(bool force = false);
+    void amendAccel();
     void abortAccelDefer();
     bool isAccelDeferred() const
       { return accel_defer_timer_.running(); }
@@ -258,11 +649,14 @@ namespace audio {
     void importAccelModeParams();
     void importSync();
     void importMeter();
-    void importSound();
+    void importVolume();
+    void importSoundVolume();
+    void importSounds();
     void importSettingsInitial();
-    bool tryImportSettings(bool force = false);
+    void importSettings();
+    void importCommands();
 
-    bool tryExportInfo(bool force = false);
+    void exportInfo();
 
     std::unique_ptr<std::thread> audio_thread_{nullptr};
     std::atomic_flag continue_audio_thread_flag_;
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 The GMetronome Team
+ *
+ * This file is part of GMetronome.
+ *
+ * GMetronome is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GMetronome is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GMetronome.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GMetronome_TripleBuffer_h
+#define GMetronome_TripleBuffer_h
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class TripleBuffer
+ * @brief Wait-free exchange of objects between a single producer and a
+ *        single consumer thread
+ *
+ * The producer writes to the back buffer and publishes it with publish().
+ * The consumer calls update() to acquire the most recently published buffer
+ * which is then accessible with front(). Both sides only exchange indices
+ * with an atomic operation, i.e. no thread ever blocks or copies data.
+ * Values that are published but not acquired in the meantime are overwritten
+ * by later publications.
+ */
+template<typename T>
+class TripleBuffer {
+public:
+  using value_type = T;
+
+  // producer interface
+  T& back() noexcept
+    { return buffers_[back_]; }
+
+  void publish() noexcept
+    {
+      auto old_middle = middle_.exchange(back_ | kDirtyBit, std::memory_order_acq_rel);
+      back_ = old_middle & kIndexMask;
+    }
+
+  // consumer interface
+  T& front() noexcept
+    { return buffers_[front_]; }
+
+  const T& front() const noexcept
+    { return buffers_[front_]; }
+
+  /** Returns true if a new buffer was acquired. */
+  bool update() noexcept
+    {
+      if ( !pending() )
+        return false;
+
+      auto old_middle = middle_.exchange(front_, std::memory_order_acq_rel);
+      front_ = old_middle & kIndexMask;
+      return true;
+    }
+
+  /** Checks if the producer published a buffer that was not acquired yet. */
+  bool pending() const noexcept
+    { return middle_.load(std::memory_order_acquire) & kDirtyBit; }
+
+private:
+  static constexpr std::uint8_t kIndexMask = 0b011;
+  static constexpr std::uint8_t kDirtyBit  = 0b100;
+
+  std::array<T, 3> buffers_;
+
+  std::uint8_t back_{0};
+  std::atomic<std::uint8_t> middle_{1};
+  std::uint8_t front_{2};
+};
+
+#endif//GMetronome_TripleBuffer_h